@@ -5,6 +5,7 @@
 #include "PixelsScanFunction.hpp"
 #include "physical/StorageArrayScheduler.h"
 #include "profiler/CountProfiler.h"
+#include "duckdb/parallel/task_scheduler.hpp"
 
 namespace duckdb {
 
@@ -33,11 +34,68 @@ static unique_ptr<NodeStatistics> PixelsCardinality(ClientContext &context, cons
 	return make_uniq<NodeStatistics>(data.initialPixelsReader->getNumberOfRows() * data.files.size());
 }
 
+/**
+ * Reference the next count values of a run-encoded integer vector as a constant or a
+ * sequence vector, if they are covered by one run and none of them is null.
+ *
+ * @return false if the values have to be referenced as a flat vector
+ */
+static bool ReferenceIntegerRun(Vector &result, const std::shared_ptr<LongColumnVector> &col,
+                                bool isLong, uint64_t count) {
+	auto &runs = col->runs;
+	long offset = (long) col->position();
+	auto run = std::upper_bound(runs.begin(), runs.end(), offset,
+	                            [](long index, const IntegerRun &run) { return index < run.start; });
+	if (run == runs.begin()) {
+		return false;
+	}
+	--run;
+	if (!run->sequence || run->start + run->length < offset + (long) count) {
+		return false;
+	}
+	for (uint64_t i = 0; i < count; i++) {
+		if (!col->checkValid((int) (offset + i))) {
+			return false;
+		}
+	}
+	int64_t first = run->first + (offset - run->start) * run->delta;
+	if (run->delta == 0) {
+		result.Reference(isLong ? Value::BIGINT(first) : Value::INTEGER((int32_t) first));
+	} else {
+		result.Sequence(first, run->delta, count);
+	}
+	return true;
+}
+
+/**
+ * Get the vector of the dictionary that the values of a dictionary encoded column are
+ * sliced from. The vector and the validity of its null entry are built once for each
+ * column chunk and reused by all the output chunks read from that column chunk.
+ */
+static Vector &GetDictionaryVector(PixelsReadLocalState &data, uint64_t col_id,
+                                   const std::shared_ptr<BinaryColumnVector> &col) {
+	if (data.dictionaries.size() <= col_id) {
+		data.dictionaries.resize(col_id + 1);
+	}
+	auto &dictionary = data.dictionaries[col_id];
+	if (dictionary.vector == nullptr || dictionary.entries != col->dictionary ||
+	    dictionary.size != col->dictionarySize) {
+		// the last entry of the dictionary is the null entry
+		dictionary.vector = make_uniq<Vector>(LogicalType::VARCHAR, (data_ptr_t)(col->dictionary));
+		auto &validity = FlatVector::Validity(*dictionary.vector);
+		validity.Initialize(col->dictionarySize + 1);
+		validity.SetInvalid(col->dictionarySize);
+		dictionary.entries = col->dictionary;
+		dictionary.size = col->dictionarySize;
+	}
+	return *dictionary.vector;
+}
+
 TableFunctionSet PixelsScanFunction::GetFunctionSet() {
     TableFunction table_function("pixels_scan", {LogicalType::VARCHAR}, PixelsScanImplementation, PixelsScanBind,
 	                             PixelsScanInitGlobal, PixelsScanInitLocal);
 	table_function.projection_pushdown = true;
-//	table_function.filter_pushdown = true;
+	table_function.filter_pushdown = true;
     //table_function.filter_prune = true;
     enable_filter_pushdown = table_function.filter_pushdown;
     MultiFileReader::AddParameters(table_function);
@@ -70,13 +128,16 @@ void PixelsScanFunction::PixelsScanImplementation(ClientContext &context,
             }
         }
         auto currPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(data.currPixelsRecordReader);
-        auto nextPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(data.nextPixelsRecordReader);
 
         if (data.vectorizedRowBatch != nullptr && data.vectorizedRowBatch->isEndOfFile()) {
             data.vectorizedRowBatch = nullptr;
         }
         if (data.vectorizedRowBatch == nullptr) {
             data.vectorizedRowBatch = currPixelsRecordReader->readBatch(false);
+            // all the row groups of this file may be pruned by the statistics
+            if (data.vectorizedRowBatch->isEndOfFile()) {
+                continue;
+            }
         }
         uint64_t currentLoc = data.vectorizedRowBatch->position();
         std::shared_ptr<TypeDescription> resultSchema = data.currPixelsRecordReader->getResultSchema();
@@ -90,16 +151,19 @@ void PixelsScanFunction::PixelsScanImplementation(ClientContext &context,
         TransformDuckdbChunk(data, output, resultSchema, thisOutputChunkRows);
 
         // apply the filter operation
-        if (enable_filter_pushdown) {
-            idx_t sel_size = 0;
+        if (enable_filter_pushdown && filterMask != nullptr) {
             SelectionVector sel;
             sel.Initialize(thisOutputChunkRows);
-            for (idx_t i = 0; i < thisOutputChunkRows; i++) {
-                if (filterMask->get(i + currentLoc)) {
-                    sel.set_index(sel_size++, i);
+            idx_t sel_size = filterMask->toSelection((long)currentLoc, (long)thisOutputChunkRows, sel.data());
+            if (sel_size < thisOutputChunkRows) {
+                // sequence vectors are not sliced in place
+                for (auto &vector : output.data) {
+                    if (vector.GetVectorType() == VectorType::SEQUENCE_VECTOR) {
+                        vector.Flatten(thisOutputChunkRows);
+                    }
                 }
+                output.Slice(sel, sel_size);
             }
-            output.Slice(sel, sel_size);
         }
         if (output.size() > 0) {
             return;
@@ -142,7 +206,7 @@ unique_ptr<FunctionData> PixelsScanFunction::PixelsScanBind(
     // sort the pxl file by file name, so that all SSD arrays can be fully utilized
     sort(files.begin(), files.end(), compare_file_name());
 
-	auto footerCache = std::make_shared<PixelsFooterCache>();
+	auto footerCache = PixelsFooterCache::Instance();
 	auto builder = std::make_shared<PixelsReaderBuilder>();
 
 	std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
@@ -173,13 +237,38 @@ unique_ptr<GlobalTableFunctionState> PixelsScanFunction::PixelsScanInitGlobal(
 	result->initialPixelsReader = bind_data.initialPixelsReader;
 
     int max_threads = std::stoi(ConfigFactory::Instance().getProperty("pixel.threads"));
-    if (max_threads <= 0) {
-        max_threads = (int) bind_data.files.size();
+    auto &files = bind_data.files;
+
+    // if there are fewer files than threads, split the files into row groups,
+    // so that all the threads can cooperate on a few large files
+    std::vector<int> rowGroupNums;
+    idx_t available_threads = max_threads > 0 ? max_threads : TaskScheduler::GetScheduler(context).NumberOfThreads();
+    if (files.size() < available_threads) {
+        for (auto &file : files) {
+            if (file == files.at(0)) {
+                rowGroupNums.emplace_back(bind_data.initialPixelsReader->getRowGroupNum());
+                continue;
+            }
+            auto footerCache = PixelsFooterCache::Instance();
+            auto builder = std::make_shared<PixelsReaderBuilder>();
+            std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
+            std::shared_ptr<PixelsReader> pixelsReader = builder
+                                             ->setPath(file)
+                                             ->setStorage(storage)
+                                             ->setPixelsFooterCache(footerCache)
+                                             ->build();
+            rowGroupNums.emplace_back(pixelsReader->getRowGroupNum());
+            pixelsReader->close();
+        }
     }
 
-    result->storageArrayScheduler = std::make_shared<StorageArrayScheduler>(bind_data.files, max_threads);
+    if (max_threads <= 0) {
+        max_threads = rowGroupNums.empty() ? (int) files.size() :
+                      std::accumulate(rowGroupNums.begin(), rowGroupNums.end(), 0);
+        max_threads = std::max(max_threads, 1);
+    }
 
-    result->file_index.resize(result->storageArrayScheduler->getDeviceSum());
+    result->storageArrayScheduler = std::make_shared<StorageArrayScheduler>(files, max_threads, rowGroupNums);
 
 	result->max_threads = max_threads;
 
@@ -187,6 +276,15 @@ unique_ptr<GlobalTableFunctionState> PixelsScanFunction::PixelsScanInitGlobal(
 
     result->filters = input.filters.get();
 
+    // the reads of this scan are admitted by the priority of the query, see pixels_read_priority
+    result->query_id = (long) context.transaction.GetActiveQuery();
+    Value priority;
+    int query_priority = 0;
+    if (context.TryGetCurrentSetting("pixels_read_priority", priority)) {
+        query_priority = priority.GetValue<int32_t>();
+    }
+    RateLimitedScheduler::SetQueryPriority(result->query_id, query_priority);
+
 	return std::move(result);
 }
 
@@ -211,7 +309,13 @@ unique_ptr<LocalTableFunctionState> PixelsScanFunction::PixelsScanInitLocal(
 		}
 	}
 
-    ::DirectUringRandomAccessFile::Initialize();
+    if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io")) {
+        if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
+            ::DirectUringRandomAccessFile::Initialize();
+        } else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+            ::DirectAioRandomAccessFile::Initialize((int) result->column_names.size());
+        }
+    }
 	if(!PixelsParallelStateNext(context.client, bind_data, *result, gstate, true)) {
 		return nullptr;
 	}
@@ -292,6 +396,9 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
 			case TypeDescription::SHORT:
 			case TypeDescription::INT: {
 			    auto intCol = std::static_pointer_cast<LongColumnVector>(col);
+			    if (ReferenceIntegerRun(output.data.at(col_id), intCol, false, thisOutputChunkRows)) {
+				    break;
+			    }
                 Vector vector(LogicalType::INTEGER,
                               (data_ptr_t)(intCol->current()), col->currentValid());
                 output.data.at(col_id).Reference(vector);
@@ -305,6 +412,9 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
 		    }
 			case TypeDescription::LONG: {
 				auto longCol = std::static_pointer_cast<LongColumnVector>(col);
+				if (ReferenceIntegerRun(output.data.at(col_id), longCol, true, thisOutputChunkRows)) {
+					break;
+				}
                 Vector vector(LogicalType::BIGINT,
                               (data_ptr_t)(longCol->current()), col->currentValid());
                 output.data.at(col_id).Reference(vector);
@@ -365,6 +475,13 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
 			case TypeDescription::CHAR:
 		    {
 			    auto binaryCol = std::static_pointer_cast<BinaryColumnVector>(col);
+			    if (binaryCol->dictionary != nullptr) {
+				    // reference the dictionary and select its entries by the dictionary ids
+				    auto &dictionary = GetDictionaryVector(data, col_id, binaryCol);
+				    SelectionVector sel((sel_t *)(binaryCol->dictIds + binaryCol->position()));
+				    output.data.at(col_id).Slice(dictionary, sel, thisOutputChunkRows);
+				    break;
+			    }
                 Vector vector(LogicalType::VARCHAR,
                               (data_ptr_t)(binaryCol->current()), col->currentValid());
                 output.data.at(col_id).Reference(vector);
@@ -386,89 +503,134 @@ bool PixelsScanFunction::PixelsParallelStateNext(ClientContext &context, const P
                                                   PixelsReadLocalState &scan_data,
                                                   PixelsReadGlobalState &parallel_state,
                                                   bool is_init_state) {
+    auto& StorageInstance = parallel_state.storageArrayScheduler;
+    // the current morsel is done, so that its buffer slot can be reused and other threads
+    // are allowed to steal from its device
+    if(scan_data.currReader != nullptr) {
+        scan_data.currReader->close();
+        scan_data.currReader = nullptr;
+    }
+    if (scan_data.curr_device_id >= 0) {
+        StorageInstance->releaseMorsel(scan_data.curr_device_id);
+        scan_data.curr_device_id = -1;
+    }
+
+    // Claim morsels to fill the prefetch pipeline. Each prefetched morsel holds a slot of the
+    // buffer pool, so the pipeline is also bounded by the free slots. Only one morsel is claimed
+    // in the init state, and the pipeline is filled when the scan starts.
+    int prefetched = (int) scan_data.prefetched_morsels.size() - (is_init_state ? 0 : 1);
+    int claimNum = is_init_state ? 1 : scan_data.prefetch_depth.get() - prefetched;
+    claimNum = std::min(claimNum, ::BufferPool::GetFreeSlotNum());
+    if (prefetched <= 0) {
+        claimNum = std::max(claimNum, 1);
+    }
+
     unique_lock<mutex> parallel_lock(parallel_state.lock);
     if (parallel_state.error_opening_file) {
         throw InvalidArgumentException("PixelsScanInitLocal: file open error.");
     }
+    std::vector<std::pair<int, int>> claimedMorsels;
+    for (int i = 0; i < claimNum; i++) {
+        int deviceID = scan_data.deviceID;
+        int fileID = 0;
+        if (!StorageInstance->acquireMorsel(deviceID, fileID)) {
+            break;
+        }
+        claimedMorsels.emplace_back(deviceID, fileID);
+    }
+    parallel_lock.unlock();
+    // The below code uses global state but no race happens, so we don't need the lock anymore
+
+    // Open the claimed morsels and submit the reads of their first row groups. The row group
+    // morsels of a file are claimed one after another, and each of them opens its own reader:
+    // the async reads of a physical reader are completed in submission order, so the readers of
+    // the prefetched morsels can not share it. The file tail is only parsed by the first morsel
+    // of the file, the others find it in the footer cache, which is looked up by path and
+    // modification time.
+    auto footerCache = PixelsFooterCache::Instance();
+    std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
+    for (auto &claimed : claimedMorsels) {
+        PixelsPrefetchedMorsel morsel;
+        morsel.device_id = claimed.first;
+        morsel.file_index = claimed.second;
+        morsel.batch_index = StorageInstance->getBatchID(claimed.first, claimed.second);
+        morsel.file_name = StorageInstance->getFileName(claimed.first, claimed.second);
+        auto builder = std::make_shared<PixelsReaderBuilder>();
+        morsel.reader = builder->setPath(morsel.file_name)
+                ->setStorage(storage)
+                ->setPixelsFooterCache(footerCache)
+                ->build();
+
+        PixelsReaderOption option = GetPixelsReaderOption(scan_data, parallel_state, claimed.first,
+                                                          claimed.second, morsel.reader);
+        morsel.recordReader = morsel.reader->read(option);
+        auto recordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(morsel.recordReader);
+        recordReader->read();
+        scan_data.prefetched_morsels.emplace_back(std::move(morsel));
+    }
 
-    auto& StorageInstance = parallel_state.storageArrayScheduler;
     // In the following two cases, the state ends:
-    // 1. When PixelsScanInitLocal invokes this function, if all files are
+    // 1. When PixelsScanInitLocal invokes this function, if all morsels are
     // fetched by other threads, this means this thread doesn't need do anything, so just return false;
-    // 2. When PixelsScanImplementation invokes this function (scan_data.next_file_index > -1), if
-    // scan_data.next_file_index >= (int) StorageInstance.getFileSum(scan_data.deviceID), it means the current file is already
-    // done, so the function return false.
-    if ((is_init_state && parallel_state.file_index.at(scan_data.deviceID) >= StorageInstance->getFileSum(scan_data.deviceID)) ||
-            scan_data.next_file_index >= StorageInstance->getFileSum(scan_data.deviceID)) {
+    // 2. When PixelsScanImplementation invokes this function, if no morsel is prefetched or
+    // claimed, it means the current morsel is the last one of this thread, so the function return false.
+    if (scan_data.prefetched_morsels.empty()) {
 		::BufferPool::Reset();
-		// if async io is enabled, we need to unregister uring buffer
+		// if async io is enabled, we need to wait for the pending reads and unregister the files of the ring
 		if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io")) {
 			if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 				::DirectUringRandomAccessFile::Reset();
 			} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
-				throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+				::DirectAioRandomAccessFile::Reset();
 			}
 		}
-        parallel_lock.unlock();
         return false;
     }
-
-    scan_data.curr_file_index = scan_data.next_file_index;
-    scan_data.curr_batch_index = scan_data.next_batch_index;
-    scan_data.next_file_index = parallel_state.file_index.at(scan_data.deviceID);
-    scan_data.next_batch_index = StorageInstance->getBatchID(scan_data.deviceID, scan_data.next_file_index);
-    scan_data.curr_file_name = scan_data.next_file_name;
-    parallel_state.file_index.at(scan_data.deviceID)++;
-    parallel_lock.unlock();
-    // The below code uses global state but no race happens, so we don't need the lock anymore
-    
-
-    if(scan_data.currReader != nullptr) {
-        scan_data.currReader->close();
+    if (is_init_state) {
+        return true;
     }
 
-    ::BufferPool::Switch();
-    scan_data.currReader = scan_data.nextReader;
-    scan_data.currPixelsRecordReader = scan_data.nextPixelsRecordReader;
-    // asyncReadComplete is not invoked in the first run (is_init_state = true)
-    if (scan_data.currPixelsRecordReader != nullptr) {
-        auto currPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(scan_data.currPixelsRecordReader);
-        currPixelsRecordReader->asyncReadComplete((int)scan_data.column_names.size());
-    }
-    if(scan_data.next_file_index < StorageInstance->getFileSum(scan_data.deviceID)) {
-        auto footerCache = std::make_shared<PixelsFooterCache>();
-        auto builder = std::make_shared<PixelsReaderBuilder>();
-        std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
-        scan_data.next_file_name = StorageInstance->getFileName(scan_data.deviceID, scan_data.next_file_index);
-        scan_data.nextReader = builder->setPath(scan_data.next_file_name)
-                ->setStorage(storage)
-                ->setPixelsFooterCache(footerCache)
-                ->build();
-
-        PixelsReaderOption option = GetPixelsReaderOption(scan_data, parallel_state);
-        scan_data.nextPixelsRecordReader = scan_data.nextReader->read(option);
-        auto nextPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(scan_data.nextPixelsRecordReader);
-        nextPixelsRecordReader->read();
-    } else {
-        scan_data.nextReader = nullptr;
-        scan_data.nextPixelsRecordReader = nullptr;
-    }
+    auto &morsel = scan_data.prefetched_morsels.front();
+    scan_data.curr_device_id = morsel.device_id;
+    scan_data.curr_file_index = morsel.file_index;
+    scan_data.curr_batch_index = morsel.batch_index;
+    scan_data.curr_file_name = morsel.file_name;
+    scan_data.currReader = morsel.reader;
+    scan_data.currPixelsRecordReader = morsel.recordReader;
+    scan_data.prefetched_morsels.pop_front();
+
+    // adapt the prefetch pipeline to the time the thread waits for the first row group
+    auto currPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(scan_data.currPixelsRecordReader);
+    auto waitStart = std::chrono::steady_clock::now();
+    currPixelsRecordReader->asyncReadCompleteCurrent();
+    auto waitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - waitStart).count();
+    scan_data.prefetch_depth.update(waitTime);
     return true;
 }
 
-PixelsReaderOption PixelsScanFunction::GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state) {
+PixelsReaderOption PixelsScanFunction::GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state,
+                                                             int deviceID, int fileID,
+                                                             const std::shared_ptr<PixelsReader> &reader) {
     PixelsReaderOption option;
     option.setSkipCorruptRecords(true);
     option.setTolerantSchemaEvolution(true);
     option.setEnableEncodedColumnVector(true);
     option.setFilter(global_state.filters);
     option.setEnabledFilterPushDown(enable_filter_pushdown);
+    option.setEnableLateMaterialization(ConfigFactory::Instance().boolCheckProperty("pixel.late.materialization"));
     // includeCols comes from the caller of PixelsPageSource
     option.setIncludeCols(local_state.column_names);
-    option.setRGRange(0, local_state.nextReader->getRowGroupNum());
-    option.setQueryId(1);
-    int stride = std::stoi(ConfigFactory::Instance().getProperty("pixel.stride"));
-    option.setBatchSize(stride);
+    auto &scheduler = global_state.storageArrayScheduler;
+    int rgStart = scheduler->getRGStart(deviceID, fileID);
+    int rgLen = scheduler->getRGLen(deviceID, fileID);
+    if (rgLen < 0) {
+        rgLen = reader->getRowGroupNum() - rgStart;
+    }
+    option.setRGRange(rgStart, rgLen);
+    option.setQueryId(global_state.query_id);
+    // a batch is one pixel of the file, whatever stride the file was written with
+    option.setBatchSize((int) reader->getPixelStride());
     return option;
 }
 }
@@ -12,6 +12,7 @@
 #include <duckdb/parser/parsed_data/create_scalar_function_info.hpp>
 #include "PixelsReader.h"
 #include "physical/StorageArrayScheduler.h"
+#include "physical/scheduler/RateLimitedScheduler.h"
 
 namespace duckdb {
 
@@ -29,9 +30,6 @@ struct PixelsReadGlobalState : public GlobalTableFunctionState {
 
     std::shared_ptr<StorageArrayScheduler> storageArrayScheduler;
 
-	//! Index of file currently up for scanning
-	vector<idx_t> file_index;
-
 	//! Batch index of the next row group to be scanned
 	idx_t batch_index;
 
@@ -39,6 +37,13 @@ struct PixelsReadGlobalState : public GlobalTableFunctionState {
 
     TableFilterSet * filters;
 
+	//! The id of the query, which tells the reads of the concurrent queries apart in the scheduler
+	long query_id = -1;
+
+	~PixelsReadGlobalState() override {
+		RateLimitedScheduler::ClearQueryPriority(query_id);
+	}
+
 	idx_t MaxThreads() const override {
 		return max_threads;
 	}
@@ -12,38 +12,58 @@
 #include <duckdb/parser/parsed_data/create_scalar_function_info.hpp>
 #include "PixelsReader.h"
 #include "reader/PixelsRecordReader.h"
+#include "physical/PrefetchDepth.h"
+#include <deque>
 
 namespace duckdb {
 
+//! A morsel whose reader is opened and whose first row group is being read asynchronously
+struct PixelsPrefetchedMorsel {
+    int device_id;
+    idx_t file_index;
+    idx_t batch_index;
+    std::string file_name;
+    std::shared_ptr<PixelsReader> reader;
+    std::shared_ptr<PixelsRecordReader> recordReader;
+};
+
+//! The dictionary of a dictionary encoded column chunk, as the vector its values are sliced from
+struct PixelsDictionaryVector {
+    duckdb::string_t *entries = nullptr;
+    int size = 0;
+    unique_ptr<Vector> vector;
+};
+
 struct PixelsReadLocalState : public LocalTableFunctionState {
     PixelsReadLocalState() {
+        curr_device_id = -1;
         curr_file_index = 0;
-        next_file_index = 0;
         curr_batch_index = 0;
-        next_batch_index = 0;
         rowOffset = 0;
         currPixelsRecordReader = nullptr;
-        nextPixelsRecordReader = nullptr;
         vectorizedRowBatch = nullptr;
         currReader = nullptr;
-        nextReader = nullptr;
     }
 	std::shared_ptr<PixelsRecordReader> currPixelsRecordReader;
-    std::shared_ptr<PixelsRecordReader> nextPixelsRecordReader;
 	// this is used for storing row batch results.
 	std::shared_ptr<VectorizedRowBatch> vectorizedRowBatch;
+    // the home device of this thread
     int deviceID;
+    // the device of the current morsel, -1 if there is no current morsel
+    int curr_device_id;
 	int rowOffset;
 	vector<column_t> column_ids;
 	vector<string> column_names;
 	std::shared_ptr<PixelsReader> currReader;
-    std::shared_ptr<PixelsReader> nextReader;
 	idx_t curr_file_index;
-    idx_t next_file_index;
     idx_t curr_batch_index;
-    idx_t next_batch_index;
-    std::string next_file_name;
     std::string curr_file_name;
+    // the morsels read ahead of the current one, in the order they are scanned
+    std::deque<PixelsPrefetchedMorsel> prefetched_morsels;
+    // the number of morsels to keep in prefetched_morsels, adapted to the read latency
+    PrefetchDepth prefetch_depth;
+    // the dictionary vector of each output column, rebuilt when a new column chunk is read
+    vector<PixelsDictionaryVector> dictionaries;
 };
 
 }
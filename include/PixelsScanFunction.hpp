@@ -11,6 +11,7 @@
 #include <numeric>
 #include <string>
 #include <vector>
+#include <chrono>
 #include <cstdio>
 #include "duckdb/common/exception.hpp"
 #include "duckdb/common/string_util.hpp"
@@ -84,7 +85,8 @@ public:
 	static bool PixelsParallelStateNext(ClientContext &context, const PixelsReadBindData &bind_data,
 	                                     PixelsReadLocalState &scan_data, PixelsReadGlobalState &parallel_state,
                                          bool is_init_state = false);
-    static PixelsReaderOption GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state);
+    static PixelsReaderOption GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state,
+                                                    int deviceID, int fileID, const std::shared_ptr<PixelsReader> &reader);
 private:
 	static void TransformDuckdbType(const std::shared_ptr<TypeDescription>& type,
 	                         vector<LogicalType> &return_types);
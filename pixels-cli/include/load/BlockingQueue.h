@@ -0,0 +1,97 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIXELS_BLOCKINGQUEUE_H
+#define PIXELS_BLOCKINGQUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/**
+ * The bounded queue that connects the stages of the loading pipeline. The producers are blocked
+ * while the queue is full, and the consumers are blocked while it is empty. Once the queue is
+ * closed, the elements left can still be taken, and push() fails so that the producers stop.
+ */
+template<typename T>
+class BlockingQueue {
+public:
+    explicit BlockingQueue(size_t capacity) : capacity(capacity), closed(false) {}
+
+    /**
+     * @return false if the queue is closed, and the element is dropped
+     */
+    bool push(T element) {
+        std::unique_lock<std::mutex> lock(m);
+        notFull.wait(lock, [this] { return closed || elements.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        elements.push_back(std::move(element));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @return false if the queue is closed and empty
+     */
+    bool pop(T &element) {
+        std::unique_lock<std::mutex> lock(m);
+        notEmpty.wait(lock, [this] { return closed || !elements.empty(); });
+        if (elements.empty()) {
+            return false;
+        }
+        element = std::move(elements.front());
+        elements.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * Take an element without blocking.
+     * @return false if the queue is empty
+     */
+    bool tryPop(T &element) {
+        std::lock_guard<std::mutex> lock(m);
+        if (elements.empty()) {
+            return false;
+        }
+        element = std::move(elements.front());
+        elements.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(m);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+
+private:
+    std::mutex m;
+    std::condition_variable notFull;
+    std::condition_variable notEmpty;
+    std::deque<T> elements;
+    size_t capacity;
+    bool closed;
+};
+#endif //PIXELS_BLOCKINGQUEUE_H
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIXELS_DELIMITERSPLITTER_H
+#define PIXELS_DELIMITERSPLITTER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "vector/VectorizedRowBatch.h"
+
+/**
+ * Split the lines of the text files into fields by a single-character delimiter. The delimiters and
+ * the line breaks are found together by comparing 32 (AVX2) or 16 (SSE2) bytes at a time, so each
+ * byte of the input is scanned once, and the fields point into the input without being copied.
+ * SSE2 is the baseline, AVX2 is used if the running CPU supports it.
+ */
+class DelimiterSplitter {
+public:
+    explicit DelimiterSplitter(char delimiter);
+    /**
+     * Split the first line in [begin, end) into fields.
+     * @return the beginning of the next line, or end if the line is not terminated by '\n'
+     */
+    const char *splitLine(const char *begin, const char *end, std::vector<TextField> &fields) const;
+    /**
+     * Convert the row regex of LOAD into the delimiter if it matches a single character.
+     * "\\s" is taken as a space as before.
+     * @return false if the regex has to be matched by a regex engine
+     */
+    static bool toDelimiter(const std::string &regex, char &delimiter);
+
+private:
+    char delimiter;
+    bool avx2;
+};
+#endif //PIXELS_DELIMITERSPLITTER_H
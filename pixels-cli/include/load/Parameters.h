@@ -31,13 +31,18 @@
 class Parameters {
 public:
     Parameters(const std::string &schema, int maxRowNum, const std::string &regex,
-               const std::string &loadingPath, EncodingLevel encodingLevel, bool nullsPadding);
+               const std::string &loadingPath, EncodingLevel encodingLevel, bool nullsPadding,
+               int consumerThreadNum, int writerThreadNum, int rowGroupSize, long fileSize);
     std::string getLoadingPath() const;
     std::string getSchema() const;
     int getMaxRowNum() const;
     std::string getRegex() const;
     EncodingLevel getEncodingLevel() const;
     bool isNullsPadding() const;
+    int getConsumerThreadNum() const;
+    int getWriterThreadNum() const;
+    int getRowGroupSize() const;
+    long getFileSize() const;
 
 private:
     std::string schema;
@@ -46,5 +51,11 @@ private:
     std::string loadingPath;
     EncodingLevel encodingLevel;
     bool nullsPadding;
+    int consumerThreadNum;
+    int writerThreadNum;
+    // the size in bytes of the row groups, row.group.size is used if it is not positive
+    int rowGroupSize;
+    // the target size in bytes of the files, the files are only rolled by maxRowNum if it is not positive
+    long fileSize;
 };
 #endif //PIXELS_PARAMETERS_H
@@ -27,16 +27,45 @@
 
 #include <vector>
 #include <string>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <load/Parameters.h>
+#include <load/BlockingQueue.h>
+#include "TypeDescription.h"
+#include "vector/VectorizedRowBatch.h"
 
+/**
+ * Load the text files into pixels files by a pipeline. A reader thread maps the files and cuts them into
+ * blocks of whole lines, the parser threads split the lines and fill the row batches, and each writer thread writes the
+ * row batches into its own target files. The stages are connected by bounded queues, so that the memory
+ * is bounded if one stage is slower than the others.
+ */
 class PixelsConsumer {
 public:
     PixelsConsumer(const std::vector<std::string> &queue, const Parameters &parameters, const std::vector<std::string> &loadedFiles);
-    void run();
+    /**
+     * @return false if any stage of the pipeline failed
+     */
+    bool run();
 private:
-    static int GlobalTargetPathId;
+    void readFiles();
+    void parseBlocks();
+    void writeBatches();
+    std::shared_ptr<VectorizedRowBatch> takeRowBatch();
+    void fail(const std::string &stage, const std::exception &e);
+    static std::atomic<int> GlobalTargetPathId;
     std::vector<std::string> queue;
     Parameters parameters;
     std::vector<std::string> loadedFiles;
+    std::mutex loadedFilesMutex;
+    std::shared_ptr<TypeDescription> schema;
+    std::string targetPath;
+    int rowBatchSize;
+    std::unique_ptr<BlockingQueue<std::shared_ptr<ByteBuffer>>> blockQueue;
+    std::unique_ptr<BlockingQueue<std::shared_ptr<VectorizedRowBatch>>> rowBatchQueue;
+    // the row batches written by the writers are reused by the parsers
+    std::unique_ptr<BlockingQueue<std::shared_ptr<VectorizedRowBatch>>> freeRowBatchQueue;
+    std::atomic<bool> failed;
 };
 #endif //PIXELS_PIXELSCONSUMER_H
@@ -28,6 +28,7 @@
 #include <physical/storage/LocalFS.h>
 #include <load/Parameters.h>
 #include <chrono>
+#include <algorithm>
 #include <load/PixelsConsumer.h>
 
 void LoadExecutor::execute(const bpo::variables_map& ns, const std::string& command) {
@@ -38,12 +39,17 @@ void LoadExecutor::execute(const bpo::variables_map& ns, const std::string& comm
     std::string regex = ns["row_regex"].as<std::string>();
     EncodingLevel encodingLevel = EncodingLevel::from(ns["encoding_level"].as<int>());
     bool nullPadding = ns["nulls_padding"].as<bool>();
+    int consumerThreadNum = std::max(1, ns["consumer_thread_num"].as<int>());
+    int writerThreadNum = std::max(1, ns["writer_thread_num"].as<int>());
+    int rowGroupSize = ns["row_group_size"].as<int>();
+    long fileSize = ns["file_size"].as<long>();
 
     if(origin.back() != '/') {
         origin += "/";
     }
 
-    Parameters parameters(schema, rowNum, regex, target, encodingLevel, nullPadding);
+    Parameters parameters(schema, rowNum, regex, target, encodingLevel, nullPadding,
+                          consumerThreadNum, writerThreadNum, rowGroupSize, fileSize);
     LocalFS localFs;
     std::vector<std::string> fileList = localFs.listPaths(origin);
     std::vector<std::string> inputFiles, loadedFiles;
@@ -59,13 +65,13 @@ void LoadExecutor::execute(const bpo::variables_map& ns, const std::string& comm
     }
     auto endTime = std::chrono::system_clock::now();
     std::chrono::duration<double> elapsedSeconds = endTime - startTime;
-    std::cout << "Text file in " << origin << " are loaded by 1 thread in "
-                << elapsedSeconds.count() << " seconds." << std::endl;
+    // the reader thread is not counted, as it is mostly blocked by the parsers
+    std::cout << "Text file in " << origin << " are loaded by " << consumerThreadNum + writerThreadNum
+                << " threads in " << elapsedSeconds.count() << " seconds." << std::endl;
 }
 
 bool LoadExecutor::startConsumers(const std::vector<std::string> &inputFiles, Parameters parameters,
                                   const std::vector<std::string> &loadedFiles) {
     PixelsConsumer consumer(inputFiles, parameters, loadedFiles);
-    consumer.run();
-    return true;
+    return consumer.run();
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "load/DelimiterSplitter.h"
+#include "utils/CpuFeatures.h"
+#include <cctype>
+#include <cstdint>
+#include <immintrin.h>
+
+/**
+ * Split the fields of the line from p in blocks of 32 bytes with AVX2. It is only called if the
+ * running CPU supports AVX2, so the file doesn't need to be compiled with -mavx2.
+ * @return the beginning of the next line, or nullptr if the line doesn't end in the blocks
+ */
+__attribute__((target("avx2")))
+static const char *splitBlocksAvx2(const char *&p, const char *end, const char *&fieldBegin, char delimiter,
+                                   std::vector<TextField> &fields) {
+    const __m256i delimiters = _mm256_set1_epi8(delimiter);
+    const __m256i lineBreaks = _mm256_set1_epi8('\n');
+    for (; end - p >= 32; p += 32) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        // the bit i is set if the byte i is the delimiter or a line break
+        auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(
+                _mm256_or_si256(_mm256_cmpeq_epi8(bytes, delimiters), _mm256_cmpeq_epi8(bytes, lineBreaks))));
+        // visit the matches from the low addresses to the high ones
+        while (mask != 0) {
+            const char *hit = p + __builtin_ctz(mask);
+            fields.push_back(TextField{fieldBegin, static_cast<size_t>(hit - fieldBegin)});
+            if (*hit == '\n') {
+                return hit + 1;
+            }
+            fieldBegin = hit + 1;
+            mask &= mask - 1;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * The same as splitBlocksAvx2 in blocks of 16 bytes with SSE2, which every x86-64 CPU supports.
+ */
+static const char *splitBlocksSse2(const char *&p, const char *end, const char *&fieldBegin, char delimiter,
+                                   std::vector<TextField> &fields) {
+    const __m128i delimiters = _mm_set1_epi8(delimiter);
+    const __m128i lineBreaks = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, delimiters), _mm_cmpeq_epi8(bytes, lineBreaks))));
+        while (mask != 0) {
+            const char *hit = p + __builtin_ctz(mask);
+            fields.push_back(TextField{fieldBegin, static_cast<size_t>(hit - fieldBegin)});
+            if (*hit == '\n') {
+                return hit + 1;
+            }
+            fieldBegin = hit + 1;
+            mask &= mask - 1;
+        }
+    }
+    return nullptr;
+}
+
+DelimiterSplitter::DelimiterSplitter(char delimiter) : delimiter(delimiter) {
+    avx2 = CpuFeatures::HasAvx2();
+}
+
+const char *DelimiterSplitter::splitLine(const char *begin, const char *end, std::vector<TextField> &fields) const {
+    fields.clear();
+    const char *fieldBegin = begin;
+    const char *p = begin;
+    const char *next = avx2 ? splitBlocksAvx2(p, end, fieldBegin, delimiter, fields)
+                            : splitBlocksSse2(p, end, fieldBegin, delimiter, fields);
+    if (next != nullptr) {
+        return next;
+    }
+    for (; p < end; ++p) {
+        if (*p == '\n' || *p == delimiter) {
+            fields.push_back(TextField{fieldBegin, static_cast<size_t>(p - fieldBegin)});
+            if (*p == '\n') {
+                return p + 1;
+            }
+            fieldBegin = p + 1;
+        }
+    }
+    fields.push_back(TextField{fieldBegin, static_cast<size_t>(end - fieldBegin)});
+    return end;
+}
+
+bool DelimiterSplitter::toDelimiter(const std::string &regex, char &delimiter) {
+    if (regex.size() == 1) {
+        delimiter = regex[0];
+        return true;
+    }
+    if (regex.size() == 2 && regex[0] == '\\') {
+        if (regex[1] == 's') {
+            delimiter = ' ';
+            return true;
+        }
+        if (regex[1] == 't') {
+            delimiter = '\t';
+            return true;
+        }
+        // an escaped punctuation, e.g., "\\|", matches the punctuation itself
+        if (std::ispunct(static_cast<unsigned char>(regex[1]))) {
+            delimiter = regex[1];
+            return true;
+        }
+    }
+    return false;
+}
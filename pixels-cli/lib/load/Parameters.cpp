@@ -25,9 +25,12 @@
 #include <load/Parameters.h>
 
 Parameters::Parameters(const std::string &schema, int maxRowNum, const std::string &regex,
-                       const std::string &loadingPath, EncodingLevel encodingLevel, bool nullsPadding)
+                       const std::string &loadingPath, EncodingLevel encodingLevel, bool nullsPadding,
+                       int consumerThreadNum, int writerThreadNum, int rowGroupSize, long fileSize)
                        : schema(schema), maxRowNum(maxRowNum), regex(regex), loadingPath(loadingPath),
-                         encodingLevel(encodingLevel), nullsPadding(nullsPadding) {}
+                         encodingLevel(encodingLevel), nullsPadding(nullsPadding),
+                         consumerThreadNum(consumerThreadNum), writerThreadNum(writerThreadNum),
+                         rowGroupSize(rowGroupSize), fileSize(fileSize) {}
 
 std::string Parameters::getSchema() const {
     return this->schema;
@@ -51,4 +54,20 @@ EncodingLevel Parameters::getEncodingLevel() const {
 
 bool Parameters::isNullsPadding() const {
     return this->nullsPadding;
-}
\ No newline at end of file
+}
+
+int Parameters::getConsumerThreadNum() const {
+    return this->consumerThreadNum;
+}
+
+int Parameters::getWriterThreadNum() const {
+    return this->writerThreadNum;
+}
+
+int Parameters::getRowGroupSize() const {
+    return this->rowGroupSize;
+}
+
+long Parameters::getFileSize() const {
+    return this->fileSize;
+}
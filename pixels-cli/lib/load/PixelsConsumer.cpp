@@ -23,133 +23,253 @@
 //
 
 #include "load/PixelsConsumer.h"
+#include "load/DelimiterSplitter.h"
 #include "encoding/EncodingLevel.h"
 #include "utils/ConfigFactory.h"
-#include "TypeDescription.h"
 #include "vector/ColumnVector.h"
-#include "vector/VectorizedRowBatch.h"
-#include "physical/storage/LocalFS.h"
+#include "physical/FilePath.h"
+#include "physical/natives/MmapRandomAccessFile.h"
 #include "PixelsWriterImpl.h"
 #include <boost/regex.hpp>
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <chrono>
+#include <thread>
 
-int PixelsConsumer::GlobalTargetPathId = 0;
+// the text files are parsed in blocks of about this size, a block holds whole lines
+#define LOAD_BLOCK_SIZE (4 * 1024 * 1024)
+
+std::atomic<int> PixelsConsumer::GlobalTargetPathId(0);
 
 PixelsConsumer::PixelsConsumer(const std::vector <std::string> &queue, const Parameters &parameters,
                                const std::vector <std::string> &loadedFiles)
-                               : queue(queue), parameters(parameters), loadedFiles(loadedFiles) {}
+                               : queue(queue), parameters(parameters), loadedFiles(loadedFiles),
+                                 rowBatchSize(0), failed(false) {}
 
-void PixelsConsumer::run() {
+bool PixelsConsumer::run() {
     std::cout << "Start PixelsConsumer" << std::endl;
-    std::string targetPath = parameters.getLoadingPath();
+    targetPath = parameters.getLoadingPath();
     if (targetPath.back() != '/') {
         targetPath += '/';
     }
-    std::string schemaStr = parameters.getSchema();
-    int maxRowNum = parameters.getMaxRowNum();
-    std::string regex = parameters.getRegex();
-    EncodingLevel encodingLevel = parameters.getEncodingLevel();
-    bool nullPadding = parameters.isNullsPadding();
-    if (regex == "\\s") {
-        regex = " ";
-    }
-
-//    int pixelsStride = std::stoi(ConfigFactory::Instance().getProperty("pixel.stride"));
-//    int rowGroupSize = std::stoi(ConfigFactory::Instance().getProperty("row.group.size"));
-//    int64_t blockSize = std::stoll(ConfigFactory::Instance().getProperty("block.size"));
-    int pixelsStride = 2;
-    int rowGroupSize = 100;
-    int64_t blockSize = 1024;
+    schema = TypeDescription::fromString(parameters.getSchema());
+    // the column writers split the batches into pixels, so the batches don't have to be as small as
+    // the stride, but a batch must fit in a target file
+    rowBatchSize = std::max(1, std::min(VectorizedRowBatch::DEFAULT_SIZE, parameters.getMaxRowNum()));
 
-    short replication = static_cast<short>(std::stoi(ConfigFactory::Instance().getProperty("block.replication")));
+    int parserNum = parameters.getConsumerThreadNum();
+    int writerNum = parameters.getWriterThreadNum();
+    size_t rowBatchQueueCapacity = 2 * (parserNum + writerNum);
+    blockQueue = std::make_unique<BlockingQueue<std::shared_ptr<ByteBuffer>>>(2 * parserNum);
+    rowBatchQueue = std::make_unique<BlockingQueue<std::shared_ptr<VectorizedRowBatch>>>(rowBatchQueueCapacity);
+    // a new row batch is created only if no one is free, so the row batches are never more than the
+    // ones being filled, queued and written, and the free ones are never blocked
+    freeRowBatchQueue = std::make_unique<BlockingQueue<std::shared_ptr<VectorizedRowBatch>>>(
+            rowBatchQueueCapacity + parserNum + writerNum);
 
-    std::shared_ptr<TypeDescription> schema = TypeDescription::fromString(schemaStr);
-    std::shared_ptr<VectorizedRowBatch> rowBatch = schema->createRowBatch(pixelsStride);
-    std::vector<std::shared_ptr<ColumnVector>> columnVectors = rowBatch->cols;
+    std::thread reader(&PixelsConsumer::readFiles, this);
+    std::vector<std::thread> parsers;
+    std::vector<std::thread> writers;
+    for (int i = 0; i < parserNum; ++i) {
+        parsers.emplace_back(&PixelsConsumer::parseBlocks, this);
+    }
+    for (int i = 0; i < writerNum; ++i) {
+        writers.emplace_back(&PixelsConsumer::writeBatches, this);
+    }
+    reader.join();
+    for (auto &parser : parsers) {
+        parser.join();
+    }
+    // all the row batches are queued, let the writers close their files once the queue is drained
+    rowBatchQueue->close();
+    for (auto &writer : writers) {
+        writer.join();
+    }
+    std::cout << "Exit PixelsConsumer" << std::endl;
+    return !failed;
+}
 
-    std::ifstream reader;
-    std::string line;
+void PixelsConsumer::fail(const std::string &stage, const std::exception &e) {
+    std::cerr << "PixelsConsumer: failed to " << stage << ": " << e.what() << std::endl;
+    failed = true;
+    // unblock the other stages so that they exit
+    blockQueue->close();
+    rowBatchQueue->close();
+    freeRowBatchQueue->close();
+}
 
-    bool initPixelsFile = true;
-    std::string targetFileName = "";
-    std::string targetFilePath;
-    std::shared_ptr<PixelsWriter> pixelsWriter(nullptr);
-    int rowCounter = 0;
-
-    int count = 0;
-    for (std::string originalFilePath : queue) {
-        if (!originalFilePath.empty()) {
-            ++count;
-            LocalFS originStorage;
-            reader = originStorage.open(originalFilePath);
-            if (!reader.is_open()) {
+void PixelsConsumer::readFiles() {
+    try {
+        for (const std::string &originalFilePath : queue) {
+            if (originalFilePath.empty()) {
+                continue;
+            }
+            FilePath path(originalFilePath);
+            if (!path.valid) {
                 std::cerr << "Error opening file: " << originalFilePath << std::endl;
                 continue;
             }
+            // the blocks are views of the mapping, so the lines are parsed without being copied
+            MmapRandomAccessFile reader(path.realPath);
             std::cout << "loading data from: " << originalFilePath << std::endl;
+            long fileLength = reader.length();
+            long offset = 0;
+            while (offset < fileLength) {
+                long blockLength = std::min<long>(LOAD_BLOCK_SIZE, fileLength - offset);
+                // the file is mapped for random reads, so read this block and the next one ahead explicitly
+                reader.willNeed(offset, 2L * LOAD_BLOCK_SIZE);
+                while (offset + blockLength < fileLength) {
+                    reader.seek(offset);
+                    std::shared_ptr<ByteBuffer> probe = reader.readFully(blockLength);
+                    auto lastLineEnd = static_cast<const uint8_t *>(memrchr(probe->getPointer(), '\n', blockLength));
+                    if (lastLineEnd != nullptr) {
+                        blockLength = lastLineEnd - probe->getPointer() + 1;
+                        break;
+                    }
+                    // the line is longer than the block
+                    blockLength = std::min<long>(2 * blockLength, fileLength - offset);
+                }
+                reader.seek(offset);
+                if (!blockQueue->push(reader.readFully(blockLength))) {
+                    return;
+                }
+                offset += blockLength;
+            }
+            reader.close();
+        }
+        blockQueue->close();
+    } catch (const std::exception &e) {
+        fail("read the files", e);
+    }
+}
 
-            while (std::getline(reader, line)) {
-                if (line.empty()) {
+std::shared_ptr<VectorizedRowBatch> PixelsConsumer::takeRowBatch() {
+    std::shared_ptr<VectorizedRowBatch> rowBatch;
+    if (freeRowBatchQueue->tryPop(rowBatch)) {
+        return rowBatch;
+    }
+    return schema->createRowBatch(rowBatchSize);
+}
+
+void PixelsConsumer::parseBlocks() {
+    try {
+        char delimiter;
+        bool useSplitter = DelimiterSplitter::toDelimiter(parameters.getRegex(), delimiter);
+        DelimiterSplitter splitter(delimiter);
+        boost::regex regex;
+        if (!useSplitter) {
+            regex = boost::regex(parameters.getRegex());
+        }
+        std::vector<TextField> fields;
+        std::shared_ptr<VectorizedRowBatch> rowBatch = takeRowBatch();
+
+        std::shared_ptr<ByteBuffer> block;
+        while (blockQueue->pop(block)) {
+            // the string values refer to the block
+            rowBatch->holdBuffer(block);
+            auto next = reinterpret_cast<const char *>(block->getPointer());
+            const char *end = next + block->size();
+            while (next < end) {
+                if (useSplitter) {
+                    next = splitter.splitLine(next, end, fields);
+                } else {
+                    const char *lineBegin = next;
+                    auto lineEnd = static_cast<const char *>(memchr(lineBegin, '\n', end - lineBegin));
+                    lineEnd = lineEnd == nullptr ? end : lineEnd;
+                    next = lineEnd == end ? end : lineEnd + 1;
+                    fields.clear();
+                    boost::cregex_token_iterator it(lineBegin, lineEnd, regex, -1);
+                    for (; it != boost::cregex_token_iterator(); ++it) {
+                        fields.push_back(TextField{it->first, static_cast<size_t>(it->length())});
+                    }
+                }
+                if (fields.empty() || (fields.size() == 1 && fields[0].length == 0)) {
                     std::cout << "got empty line" << std::endl;
                     continue;
                 }
-                if (initPixelsFile) {
-                    LocalFS targetStorage;
-                    targetFileName = std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())) + ".pxl";
-                    targetFilePath = targetPath + targetFileName;
-                    pixelsWriter = std::make_shared<PixelsWriterImpl>(schema, pixelsStride, rowGroupSize, targetFilePath, blockSize,
-                                                                      true, encodingLevel, nullPadding,false, 1);
-                }
-                initPixelsFile = false;
 
-                ++rowBatch->rowCount;
-                ++rowCounter;
+                rowBatch->addTextRow(fields.data(), static_cast<int>(fields.size()));
 
-                std::vector<std::string> colsInLine;
-                boost::sregex_token_iterator it(line.begin(), line.end(), boost::regex(regex), -1);
-                for (; it != boost::sregex_token_iterator(); ++it) {
-                    colsInLine.push_back(*it);
-                }
-                for(int i = 0; i < columnVectors.size(); ++i) {
-                    if (i > colsInLine.size() || colsInLine[i].empty() || colsInLine[i] == "\\N") {
-                        columnVectors[i]->addNull();
-                    } else {
-                        columnVectors[i]->add(colsInLine[i]);
+                if (rowBatch->rowCount == rowBatch->getMaxSize()) {
+                    if (!rowBatchQueue->push(rowBatch)) {
+                        return;
                     }
+                    rowBatch = takeRowBatch();
+                    rowBatch->holdBuffer(block);
                 }
+            }
+        }
+        if (rowBatch->rowCount != 0) {
+            rowBatchQueue->push(rowBatch);
+        }
+    } catch (const std::exception &e) {
+        fail("parse the lines", e);
+    }
+}
 
-                if (rowBatch->rowCount == rowBatch->getMaxSize()) {
-                    std::cout << "writing row group to file: " << targetFilePath << " rowCount:"<<rowBatch->rowCount<<std::endl;
-                    pixelsWriter->addRowBatch(rowBatch);
+void PixelsConsumer::writeBatches() {
+    std::string targetFilePath;
+    try {
+        int maxRowNum = parameters.getMaxRowNum();
+        long fileSize = parameters.getFileSize();
+        EncodingLevel encodingLevel = parameters.getEncodingLevel();
+        bool nullPadding = parameters.isNullsPadding();
 
-                    rowBatch->reset();
-                }
+        // the stride must be the same as the one the files are scanned by
+        int pixelsStride = std::stoi(ConfigFactory::Instance().getProperty("pixel.stride"));
+        int rowGroupSize = parameters.getRowGroupSize() > 0 ? parameters.getRowGroupSize() :
+                std::stoi(ConfigFactory::Instance().getProperty("row.group.size"));
+        int64_t blockSize = std::stoll(ConfigFactory::Instance().getProperty("block.size"));
+        if (fileSize > 0 && fileSize < rowGroupSize) {
+            // a file holds at least one row group
+            rowGroupSize = static_cast<int>(fileSize);
+        }
 
-                // 创建一个新的文件
-                if (rowCounter >= maxRowNum) {
-                    if (rowBatch->rowCount != 0) {
-                        pixelsWriter->addRowBatch(rowBatch);
-                        rowBatch->reset();
-                    }
-                    pixelsWriter->close();
+        short replication = static_cast<short>(std::stoi(ConfigFactory::Instance().getProperty("block.replication")));
+
+        std::shared_ptr<PixelsWriter> pixelsWriter(nullptr);
+        int rowCounter = 0;
+        bool fileFull = false;
+        std::shared_ptr<VectorizedRowBatch> rowBatch;
+        while (rowBatchQueue->pop(rowBatch)) {
+            // 创建一个新的文件
+            if (pixelsWriter != nullptr && (fileFull || rowCounter + rowBatch->rowCount > maxRowNum)) {
+                pixelsWriter->close();
+                {
+                    std::lock_guard<std::mutex> lock(loadedFilesMutex);
                     this->loadedFiles.push_back(targetFilePath);
-                    rowCounter = 0;
-                    initPixelsFile = true;
                 }
+                pixelsWriter = nullptr;
+                rowCounter = 0;
+                fileFull = false;
             }
-        }
-    }
-    // 剩余line写入文件
-    if (rowCounter > 0) {
-        if (rowBatch->rowCount != 0) {
-            pixelsWriter->addRowBatch(rowBatch);
+            if (pixelsWriter == nullptr) {
+                // the writers may create their files in the same second
+                std::string targetFileName = std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())) +
+                        "_" + std::to_string(GlobalTargetPathId++) + ".pxl";
+                targetFilePath = targetPath + targetFileName;
+                pixelsWriter = std::make_shared<PixelsWriterImpl>(schema, pixelsStride, rowGroupSize, targetFilePath, blockSize,
+                                                                  true, encodingLevel, nullPadding, false, 1);
+            }
+            std::cout << "writing row group to file: " << targetFilePath << " rowCount:" << rowBatch->rowCount << std::endl;
+            // the row groups are cut by the encoded bytes of the columns, so the file is checked
+            // against the target size once a row group is written
+            bool rowGroupWritten = !pixelsWriter->addRowBatch(rowBatch);
+            fileFull = rowGroupWritten && fileSize > 0 && pixelsWriter->getCompletedBytes() >= fileSize;
+            rowCounter += rowBatch->rowCount;
             rowBatch->reset();
+            freeRowBatchQueue->push(rowBatch);
         }
-        pixelsWriter->close();
-        this->loadedFiles.push_back(targetFilePath);
+        // 剩余line写入文件
+        if (pixelsWriter != nullptr) {
+            pixelsWriter->close();
+            std::lock_guard<std::mutex> lock(loadedFilesMutex);
+            this->loadedFiles.push_back(targetFilePath);
+        }
+    } catch (const std::exception &e) {
+        fail("write " + targetFilePath, e);
     }
-    std::cout << "Exit PixelsConsumer" << std::endl;
-}
\ No newline at end of file
+}
@@ -25,6 +25,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <boost/program_options.hpp>
 #include <executor/LoadExecutor.h>
@@ -96,7 +98,16 @@ int main () {
                     ("row_num,n", bpo::value<int>()->required(), "specify the max number of rows to write in a file")
                     ("row_regex,r", bpo::value<std::string>()->required(), "specify the split regex of each row in a file")
                     ("encoding_level,e", bpo::value<int>()->default_value(2), "specify the encoding level for data loading")
-                    ("nulls_padding,p", bpo::value<bool>()->default_value(false), "specify whether nulls padding is enabled");
+                    ("nulls_padding,p", bpo::value<bool>()->default_value(false), "specify whether nulls padding is enabled")
+                    ("consumer_thread_num,c", bpo::value<int>()->default_value(
+                            static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))),
+                            "specify the number of threads to parse the rows")
+                    ("writer_thread_num,w", bpo::value<int>()->default_value(1),
+                            "specify the number of threads to write the target files, each thread writes its own files")
+                    ("row_group_size,g", bpo::value<int>()->default_value(0),
+                            "specify the size in bytes of the row groups, row.group.size is used if it is 0")
+                    ("file_size,f", bpo::value<long>()->default_value(0),
+                            "specify the target size in bytes of the target files, 0 to roll the files by row_num only");
 
             bpo::variables_map vm;
             try {
@@ -14,30 +14,69 @@
 #include "utils/ColumnSizeCSVReader.h"
 #include <map>
 
-// when allocating buffer pool, we use the size of the first pxl file. Consider that
-// the remaining pxl file has larger size than the first file, we allocate some extra
-// size (10MB) to each column.
-// TODO: how to evaluate the maximal pool size
-#define EXTRA_POOL_SIZE 3*1024*1024
+#include <atomic>
+
+// the size of the smallest buffer, each larger size class doubles the size
+#define MIN_POOL_BUFFER_SIZE (64 * 1024)
 
 class DirectUringRandomAccessFile;
-// This class is global class. The variable is shared by each thread
+// This class is global class. The variable is shared by each thread.
+// The pool consists of slots, and each slot holds one buffer per column of a row group. A record
+// reader takes a slot to read the column chunks of a row group, so that the row groups prefetched
+// by the scan thread don't overwrite each other. At most pixel.prefetch.depth + 2 slots are taken
+// at the same time by a thread.
+// The buffers are direct-I/O-aligned and their sizes are powers of two. The buffers of a released
+// slot are cached per size class and reused by the later slots of the thread. The bytes of all the
+// buffers of all the threads are bounded by pixel.prefetch.memory.budget, a thread drops its
+// cached buffers when a new buffer would exceed the budget. The cached buffers are kept when
+// the scan ends, so that the buffers registered to io_uring are reused by the next scans, and
+// are given back to the budget when the thread exits.
 class BufferPool {
 public:
-	static void Initialize(std::vector<uint32_t> colIds, std::vector<uint64_t> bytes, std::vector<std::string> columnNames);
-	static std::shared_ptr<ByteBuffer> GetBuffer(uint32_t colId);
-    static int64_t GetBufferId(uint32_t index);
-    static void Switch();
+	/**
+	 * Take a slot with a buffer for each column, the buffers can hold at least the given bytes.
+	 * @return the slot, or -1 if the thread takes too many slots or the memory budget is exhausted
+	 */
+	static int AcquireSlot(const std::vector<uint32_t>& colIds, const std::vector<uint64_t>& bytes,
+	                       const std::vector<std::string>& columnNames);
+	static void ReleaseSlot(int slot);
+	/**
+	 * @return the number of slots the thread can still take
+	 */
+	static int GetFreeSlotNum();
+	static std::shared_ptr<ByteBuffer> GetBuffer(int slot, uint32_t colId);
+	/**
+	 * @return the index of the buffer registered to io_uring, or -1 if it is not registered
+	 */
+    static int64_t GetBufferId(int slot, uint32_t colId);
 	static void Reset();
 private:
 	BufferPool() = default;
-	static thread_local int colCount;
-	static thread_local std::map<uint32_t, uint64_t> nrBytes;
-	static thread_local bool isInitialized;
-	static thread_local std::map<uint32_t, std::shared_ptr<ByteBuffer>> buffers[2];
+	struct PoolBuffer {
+		std::shared_ptr<ByteBuffer> buffer;
+		int sizeClass;
+		// the index of the buffer registered to io_uring, -1 if it is not registered
+		int registeredIndex;
+	};
+	static int GetSizeClass(uint64_t bytes);
+	static std::shared_ptr<ByteBuffer> AllocateBuffer(int sizeClass);
+	static void ReleaseCachedBuffers();
+	static int GetMaxSlotNum();
+	// the buffers of each slot, arranged by column id
+	static thread_local std::vector<std::map<uint32_t, PoolBuffer>> slots;
+	static thread_local std::vector<bool> slotInUse;
+	// the cached buffers of the released slots, arranged by size class
+	static thread_local std::vector<std::vector<PoolBuffer>> freeBuffers;
+	// whether buffers are allocated or freed since they were registered to io_uring
+	static thread_local bool registrationDirty;
+	// the bytes of the buffers allocated by the thread, given back to the budget when the thread exits
+	struct ThreadBytes {
+		uint64_t bytes = 0;
+		~ThreadBytes();
+	};
+	static thread_local ThreadBytes threadBytes;
+	static std::atomic<uint64_t> allocatedBytes;
 	static std::shared_ptr<DirectIoLib> directIoLib;
-    static thread_local int currBufferIdx;
-    static thread_local int nextBufferIdx;
     friend class DirectUringRandomAccessFile;
 };
 #endif // DUCKDB_BUFFERPOOL_H
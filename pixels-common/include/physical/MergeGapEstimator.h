@@ -0,0 +1,43 @@
+#ifndef DUCKDB_MERGEGAPESTIMATOR_H
+#define DUCKDB_MERGEGAPESTIMATOR_H
+
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Estimate the max gap for SortMergeScheduler to merge two requests. Merging two requests saves
+ * the latency of one request but reads the gap in between, so merging pays off as long as the gap
+ * is read within the latency, i.e., the gap is smaller than latency * bandwidth.
+ * The latency and the bandwidth are fitted by a linear regression of the time of the reads on
+ * their sizes, in which the older samples decay. The gap is bounded by read.request.merge.gap,
+ * which is also used before enough reads are sampled.
+ */
+class MergeGapEstimator {
+public:
+	static MergeGapEstimator * Instance();
+	/**
+	 * Add the time of a read.
+	 * @param bytes the bytes of the read, including the merged gaps
+	 * @param seconds the time from the issue of the read to its completion
+	 */
+	void addSample(uint64_t bytes, double seconds);
+	int getMergeGap();
+	/**
+	 * @return the configured upper bound of the gap
+	 */
+	int getMaxMergeGap() const;
+private:
+	MergeGapEstimator();
+	static MergeGapEstimator * instance;
+	std::mutex m;
+	int maxGap;
+	int gap;
+	// the decayed sums of the regression of seconds (y) on bytes (x)
+	double weight;
+	double sumX;
+	double sumY;
+	double sumXX;
+	double sumXY;
+	uint64_t sampleNum;
+};
+#endif // DUCKDB_MERGEGAPESTIMATOR_H
@@ -14,9 +14,17 @@
 #include <limits>
 #include <vector>
 
+// the max number of requests merged into one, which bounds the iovecs of a vectored read
+#define MAX_MERGED_REQUEST_SIZE 256
+
 class MergedRequest: public std::enable_shared_from_this<MergedRequest> {
 public:
     MergedRequest(Request first);
+    /**
+     * @param maxGap the requests farther than maxGap from this request are not merged, no request
+     * is merged if it is negative
+     */
+    MergedRequest(Request first, int maxGap);
     std::shared_ptr<MergedRequest> merge(Request curr);
     std::vector<std::shared_ptr<ByteBuffer>> complete(std::shared_ptr<ByteBuffer> buffer);
     long getStart();
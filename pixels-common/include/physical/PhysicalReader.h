@@ -34,6 +34,20 @@ public:
         return false;
     }
 
+    /**
+     * @return true if readFully returns the views of the file data, e.g. a memory-mapped
+     * file, so the buffers passed to readFully are not used.
+     */
+    virtual bool supportsZeroCopy() {
+        return false;
+    }
+
+    /**
+     * Hint that the range will be read soon. It is a no-op unless the reader supports zero copy.
+     */
+    virtual void willNeed(long offset, long length) {
+    }
+
     /**
      * readAsync does not affect the position of this reader, and is not affected by seek().
      * @param offset
@@ -49,7 +63,12 @@ public:
 //    virtual int readInt() = 0;
     virtual void close() = 0;
 
-//    virtual std::string getPath() = 0;
+    /**
+     * @return the path of the file, which is the name if the path is unknown.
+     */
+    virtual std::string getPath() {
+        return getName();
+    }
 
     /**
     * Get the last domain in path.
@@ -31,7 +31,7 @@
 
 class PhysicalWriterUtil {
 public:
-    static std::shared_ptr<PhysicalWriter> newPhysicalWriter(std::string path, int blockSize,
+    static std::shared_ptr<PhysicalWriter> newPhysicalWriter(std::string path, std::int64_t blockSize,
                                                              bool blockPadding, bool overwrite) {
         std::shared_ptr<PhysicalWriterOption> option = std::make_shared<PhysicalWriterOption>(blockSize, blockPadding, overwrite);
         LocalFSProvider provider;
@@ -0,0 +1,29 @@
+#ifndef DUCKDB_PREFETCHDEPTH_H
+#define DUCKDB_PREFETCHDEPTH_H
+
+#include <cstdint>
+
+/**
+ * The number of morsels a scan thread reads ahead of the one it scans. If the thread has to wait
+ * for the read of the first row group of a morsel, the pipeline is too short to hide the read
+ * latency, so it is deepened, up to pixel.prefetch.depth. It is shortened after the reads of
+ * several morsels in a row are done in time, so that fewer buffers and device queue slots are used.
+ */
+class PrefetchDepth {
+public:
+	PrefetchDepth();
+	explicit PrefetchDepth(int maxDepth);
+	/**
+	 * Adapt the depth to the wait of the thread for the read of the morsel it is about to scan.
+	 * @param waitMicros the time the thread waited for the first row group of the morsel
+	 */
+	void update(int64_t waitMicros);
+	int get() const;
+	int getMaxDepth() const;
+private:
+	int depth;
+	int maxDepth;
+	// the number of morsels in a row whose reads were done before they were scanned
+	int hitCount;
+};
+#endif // DUCKDB_PREFETCHDEPTH_H
@@ -7,24 +7,78 @@
 
 #include "utils/ConfigFactory.h"
 #include <vector>
+#include <string>
 #include <mutex>
 #include <unordered_map>
+#include <cstdint>
+
+/**
+ * A range of row groups in a file, which is the unit of work of a scan thread.
+ * rgLen is -1 if the range covers all the row groups of the file. weight is the
+ * estimated number of bytes to read for the morsel.
+ */
+struct ScanMorsel {
+    std::string file;
+    int rgStart;
+    int rgLen;
+    uint64_t weight;
+};
 
 class StorageArrayScheduler {
 public:
-    StorageArrayScheduler(std::vector<std::string>& files, int threadNum);
+    /**
+     * @param files the files to scan
+     * @param threadNum the number of scan threads
+     * @param rowGroupNums the number of row groups of each file. If it is not empty, each row
+     * group becomes a morsel, so that multiple threads can scan the same file. Otherwise,
+     * each file is a morsel.
+     */
+    StorageArrayScheduler(std::vector<std::string>& files, int threadNum,
+                          const std::vector<int>& rowGroupNums = {});
     int acquireDeviceId();
     int getDeviceSum();
 
+    /**
+     * Claim the next morsel to scan. The morsel is taken from the front of the queue of
+     * deviceID. If that queue is empty, the morsel is stolen from the back of the queue of
+     * the device with the most remaining bytes, as long as the number of in-flight morsels
+     * of that device is below storage.device.max.inflight.
+     * @param deviceID the home device of the caller, set to the device of the claimed morsel
+     * @param fileID set to the index of the claimed morsel in the device
+     * @return false if there is no morsel left that can be claimed
+     */
+    bool acquireMorsel(int& deviceID, int& fileID);
+    /**
+     * Mark a morsel claimed by acquireMorsel as finished.
+     */
+    void releaseMorsel(int deviceID);
+
+    // the fileID of the following methods is the index of the morsel in the device
     std::string getFileName(int deviceID, int fileID);
+    int getRGStart(int deviceID, int fileID);
+    int getRGLen(int deviceID, int fileID);
     uint64_t getFileSum(int deviceID);
     int getMaxFileSum();
+    /**
+     * @return the batch index of a morsel claimed by acquireMorsel. The batch indexes are
+     * handed out in the order of the claims, so that the morsels claimed by a thread have
+     * increasing batch indexes even if they are stolen from other devices.
+     */
     int getBatchID(int deviceID, int fileID);
 private:
     std::mutex m;
     int currentDeviceID;
     int devicesNum;
-    std::vector<std::vector<std::string>> filesVector;
+    std::vector<std::vector<ScanMorsel>> filesVector;
+    // the unclaimed morsels of device i are filesVector[i][queueFront[i], queueBack[i])
+    std::vector<int> queueFront;
+    std::vector<int> queueBack;
+    std::vector<uint64_t> remainingWeight;
+    std::vector<int> inFlight;
+    int maxInFlight;
+    // batchIDs[i][j] is the batch index of morsel j of device i, or -1 if it is not claimed
+    std::vector<std::vector<int>> batchIDs;
+    int nextBatchID;
 };
 
 #endif //DUCKDB_STORAGEARRAYSCHEDULER_H
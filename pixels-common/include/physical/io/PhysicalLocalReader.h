@@ -9,6 +9,8 @@
 #include "physical/storage/LocalFS.h"
 #include "physical/natives/DirectRandomAccessFile.h"
 #include "physical/natives/DirectUringRandomAccessFile.h"
+#include "physical/natives/DirectAioRandomAccessFile.h"
+#include "physical/natives/MmapRandomAccessFile.h"
 #include <iostream>
 #include <atomic>
 
@@ -19,6 +21,18 @@ public:
     std::shared_ptr<ByteBuffer> readFully(int length) override;
 	std::shared_ptr<ByteBuffer> readFully(int length, std::shared_ptr<ByteBuffer> bb) override;
 	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> bb, int index);
+	/**
+	 * Read the chunks into the buffers with one vectored read, the chunks are in ascending order.
+	 */
+	std::vector<std::shared_ptr<ByteBuffer>> readFullyVectored(const std::vector<long>& offsets,
+	                                                           const std::vector<int>& lengths,
+	                                                           const std::vector<std::shared_ptr<ByteBuffer>>& buffers);
+	/**
+	 * The asynchronous version of readFullyVectored, it is only supported by io_uring.
+	 */
+	std::vector<std::shared_ptr<ByteBuffer>> readAsyncVectored(const std::vector<long>& offsets,
+	                                                           const std::vector<int>& lengths,
+	                                                           const std::vector<std::shared_ptr<ByteBuffer>>& buffers);
 	void readAsyncSubmit(uint32_t size);
 	void readAsyncComplete(uint32_t size);
 	void readAsyncSubmitAndComplete(uint32_t size);
@@ -29,6 +43,9 @@ public:
     int readInt() override;
     char readChar() override;
     std::string getName() override;
+    std::string getPath() override;
+    bool supportsZeroCopy() override;
+    void willNeed(long offset, long length) override;
 private:
     std::shared_ptr<LocalFS> local;
     std::string path;
@@ -131,6 +131,12 @@ protected:
 	// should use free() to deallocate the buf
 	bool allocated_by_new;
 private:
+    /**
+     * Make room for len more bytes at the write position. The buffer grows if it owns the memory,
+     * otherwise writing past the end of the buffer throws.
+     */
+    void ensureWritable(uint32_t len);
+
     template<typename T> T read() {
         T data = read<T>(rpos);
         rpos += sizeof(T);
@@ -150,9 +156,7 @@ private:
     template<typename T> void append(T data) {
         uint32_t s = sizeof(data);
 
-        if (size() < (wpos + s)) {
-            throw std::runtime_error("Append exceeds the size of buffer");
-        }
+        ensureWritable(s);
         memcpy(&buf[wpos], (uint8_t*) &data, s);
         //printf("writing %c to %i\n", (uint8_t)data, wpos);
 
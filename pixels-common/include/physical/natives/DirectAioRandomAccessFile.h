@@ -0,0 +1,79 @@
+//
+// Created by agent on 10/18/26.
+//
+
+#ifndef DUCKDB_DIRECTAIORANDOMACCESSFILE_H
+#define DUCKDB_DIRECTAIORANDOMACCESSFILE_H
+
+#include <linux/aio_abi.h>
+#include "physical/natives/DirectRandomAccessFile.h"
+#include "exception/InvalidArgumentException.h"
+#include "DirectIoLib.h"
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The Linux AIO backend of the asynchronous read, used when localfs.async.lib is aio.
+ * It has the same submit/complete contract as DirectUringRandomAccessFile, for the hosts
+ * where io_uring is disabled. The AIO syscalls are invoked directly, so that no libaio
+ * is needed. The reads are only asynchronous if direct I/O is enabled. If the AIO context can't
+ * be created, e.g., when fs.aio-max-nr is exhausted, the reads are done synchronously on submit.
+ */
+class DirectAioRandomAccessFile: public DirectRandomAccessFile {
+public:
+	explicit DirectAioRandomAccessFile(const std::string& file);
+	/**
+	 * Create the AIO context of the thread if it doesn't exist or is too small for the scan.
+	 * The context holds the reads of the row groups that are in flight at the same time, i.e.,
+	 * the row groups of the prefetched morsels and the current and the next row group.
+	 * @param columnNum the number of columns read by the scan
+	 */
+	static void Initialize(int columnNum);
+	/**
+	 * Wait for the pending requests of the thread at the end of a scan.
+	 */
+	static void Reset();
+	/**
+	 * @param index it is not used, since AIO has no registered buffers
+	 */
+	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index);
+	void readAsyncSubmit(int size);
+	/**
+	 * Wait for the oldest submitted requests of this file. The context is shared by all the files
+	 * read by the thread, so the completions of the other files are only counted here.
+	 */
+	void readAsyncComplete(int size);
+	~DirectAioRandomAccessFile();
+private:
+	uint64_t currentTag() const;
+	static void reapCompletion();
+	/**
+	 * A prepared or submitted read, kept until the read completes.
+	 */
+	struct AioRead {
+		uint64_t tag;
+		struct iocb request;
+		// the bytes of the read before the end of the file
+		uint64_t expectedBytes;
+	};
+	/**
+	 * Read the rest of a read with plain reads, after the first bytes are read.
+	 */
+	static void finishRead(const AioRead &read, uint64_t bytes);
+	// the requests of one submission are tagged with the same data
+	uint64_t fileTag;
+	uint32_t batchSeq;
+	std::vector<AioRead> preparedRequests;
+	std::deque<std::pair<uint64_t, uint32_t>> submittedBatches;
+	static std::atomic<uint64_t> fileCount;
+	static thread_local std::unordered_map<uint64_t, uint32_t> pendingRequests;
+	// the reads in flight, by the data of their iocbs
+	static thread_local std::unordered_map<uint64_t, AioRead> reads;
+	static thread_local uint64_t nextReadId;
+	static thread_local aio_context_t context;
+	// the number of events the context can hold
+	static thread_local unsigned contextDepth;
+};
+#endif // DUCKDB_DIRECTAIORANDOMACCESSFILE_H
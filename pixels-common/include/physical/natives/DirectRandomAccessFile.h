@@ -10,9 +10,33 @@
 #include "physical/natives/DirectIoLib.h"
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/uio.h>
 #include "profiler/TimeProfiler.h"
 #include "physical/allocator/OrdinaryAllocator.h"
 
+/**
+ * A read of several column chunks of a file with a single vectored read. Each chunk is read into
+ * its own buffer, and the gaps between the chunks are read into a scratch buffer.
+ */
+struct VectoredRead {
+	// the bytes of a chunk that are read into the buffer of a later chunk. With direct I/O, the
+	// last block of a chunk is read into the buffer of the next chunk if they share the block
+	struct TailCopy {
+		uint8_t * dst;
+		uint8_t * src;
+		size_t length;
+	};
+	long fileOffset;
+	uint64_t bytes;
+	std::vector<struct iovec> iovecs;
+	std::vector<std::shared_ptr<ByteBuffer>> results;
+	std::vector<TailCopy> tailCopies;
+	/**
+	 * Copy the tails of the chunks into their buffers, it must be called after the read completes.
+	 */
+	void finish() const;
+};
+
 class DirectRandomAccessFile: public PixelsRandomAccessFile {
 public:
     explicit DirectRandomAccessFile(const std::string& file);
@@ -24,6 +48,16 @@ public:
     long readLong() override;
     char readChar() override;
     int readInt() override;
+	/**
+	 * Read the chunks into the buffers with one vectored read.
+	 * @param offsets the offsets of the chunks, in ascending order and not overlapped
+	 * @param buffers the buffers of the chunks, each holds at least the length of the chunk plus
+	 * two blocks if direct I/O is enabled
+	 * @return the chunks in the buffers
+	 */
+	std::vector<std::shared_ptr<ByteBuffer>> readFullyVectored(const std::vector<long>& offsets,
+	                                                           const std::vector<int>& lengths,
+	                                                           const std::vector<std::shared_ptr<ByteBuffer>>& buffers);
 private:
     void populatedBuffer();
 	std::shared_ptr<Allocator> allocator;
@@ -34,6 +68,10 @@ private:
     bool bufferValid;
 	long len;
 protected:
+	VectoredRead planVectoredRead(const std::vector<long>& offsets, const std::vector<int>& lengths,
+	                              const std::vector<std::shared_ptr<ByteBuffer>>& buffers);
+	// the gaps between the merged chunks are read into it, so its content is never used
+	static thread_local std::shared_ptr<ByteBuffer> gapBuffer;
 	int fd;
 	long offset;
 	std::shared_ptr<DirectIoLib> directIoLib;
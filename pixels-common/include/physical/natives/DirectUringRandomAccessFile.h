@@ -11,21 +11,115 @@
 #include "exception/InvalidArgumentException.h"
 #include "DirectIoLib.h"
 #include "physical/BufferPool.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 class DirectUringRandomAccessFile: public DirectRandomAccessFile {
 public:
 	explicit DirectUringRandomAccessFile(const std::string& file);
 	static void RegisterBuffer(std::vector<std::shared_ptr<ByteBuffer>> buffers);
-    static void RegisterBufferFromPool(std::vector<uint32_t> colIds);
+	/**
+	 * Register the buffers of BufferPool if they changed since the last registration. The
+	 * registered buffers can only be replaced when no read of the ring is in flight, so the
+	 * buffers allocated while reads are in flight are read without registration until the
+	 * next call that finds the ring idle.
+	 */
+	static void RegisterBufferFromPool();
+	/**
+	 * Create the ring of the thread if it doesn't exist. The ring is kept across the scans,
+	 * and is only destroyed by Destroy or when the thread exits.
+	 */
 	static void Initialize();
+	/**
+	 * Wait for the pending requests and unregister the files of the thread at the end of a scan.
+	 */
 	static void Reset();
+	static void Destroy();
+	/**
+	 * @param index the index of the registered buffer, or -1 if the buffer is not registered
+	 */
 	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index);
+	/**
+	 * Prepare one vectored read of the chunks, see DirectRandomAccessFile::readFullyVectored.
+	 * The chunks count as offsets.size() requests in readAsyncComplete.
+	 */
+	std::vector<std::shared_ptr<ByteBuffer>> readAsyncVectored(const std::vector<long>& offsets,
+	                                                           const std::vector<int>& lengths,
+	                                                           const std::vector<std::shared_ptr<ByteBuffer>>& buffers);
 	void readAsyncSubmit(int size);
+	/**
+	 * Wait for the oldest submitted requests of this file. The ring is shared by all the files
+	 * read by the thread, so the completions of the other files are only counted here.
+	 */
 	void readAsyncComplete(int size);
+	void close() override;
 	~DirectUringRandomAccessFile();
 private:
-	static thread_local struct io_uring * ring;
-	static thread_local bool isRegistered;
-	static thread_local struct iovec * iovecs;
-	static thread_local uint32_t iovecSize;
+	/**
+	 * @return the index of this file in the registered file table of the ring,
+	 * or -1 if the file cannot be registered
+	 */
+	int getFileIndex();
+	int registeredFileIndex;
+	struct io_uring * registeredRing;
+	uint64_t currentTag() const;
+	/**
+	 * Tag the sqe with a new read of the ring, which must fill the iovecs up to the end of the file.
+	 */
+	void prepareRead(struct io_uring_sqe * sqe, const struct iovec * iovecs, unsigned count, long fileOffset);
+	static void reapCompletion();
+	/**
+	 * A read of one sqe, kept until the read completes.
+	 */
+	struct UringRead {
+		uint64_t tag;
+		int fd;
+		long fileOffset;
+		std::vector<struct iovec> iovecs;
+		// the bytes of the read before the end of the file
+		uint64_t expectedBytes;
+	};
+	/**
+	 * Read the rest of a read that completed with less bytes than expected.
+	 */
+	static void finishShortRead(UringRead &read, uint64_t bytes);
+	struct SubmittedBatch {
+		uint64_t tag;
+		// the number of requests of the caller, a vectored read counts as all of its chunks
+		uint32_t requests;
+		uint64_t bytes;
+		std::chrono::steady_clock::time_point submitTime;
+		// the iovecs of the vectored reads must be kept until the reads complete
+		std::vector<VectoredRead> vectoredReads;
+	};
+	// the requests of one submission are tagged with the same user data
+	uint64_t fileTag;
+	uint32_t batchSeq;
+	uint32_t preparedRequests;
+	uint32_t preparedSqes;
+	uint64_t preparedBytes;
+	std::vector<VectoredRead> preparedVectoredReads;
+	std::deque<SubmittedBatch> submittedBatches;
+	static std::atomic<uint64_t> fileCount;
+	/**
+	 * The ring of a thread and the state that belongs to it. They are kept in one thread-local
+	 * object, so that they are still alive when the ring is destroyed at the thread exit.
+	 */
+	struct RingState {
+		struct io_uring * ring = nullptr;
+		bool isRegistered = false;
+		struct iovec * iovecs = nullptr;
+		uint32_t iovecSize = 0;
+		bool filesRegistered = false;
+		std::vector<bool> fileSlotUsed;
+		std::unordered_map<uint64_t, uint32_t> pendingRequests;
+		// the reads in flight, by the user data of their sqes
+		std::unordered_map<uint64_t, UringRead> reads;
+		uint64_t nextReadId = 0;
+		~RingState();
+	};
+	static thread_local RingState state;
 };
 #endif // DUCKDB_DIRECTURINGRANDOMACCESSFILE_H
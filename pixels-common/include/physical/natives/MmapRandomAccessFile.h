@@ -0,0 +1,43 @@
+#ifndef DUCKDB_MMAPRANDOMACCESSFILE_H
+#define DUCKDB_MMAPRANDOMACCESSFILE_H
+
+#include "physical/natives/PixelsRandomAccessFile.h"
+#include "physical/natives/ByteBuffer.h"
+#include <string>
+
+/**
+ * The whole file is mapped read-only, and readFully returns the ByteBuffer views of the
+ * mapping instead of copying the data, so it is suited to the datasets that are resident
+ * in the page cache. It is used when localfs.enable.mmap is true.
+ * The mapping is released after the file is closed and all the views are destroyed.
+ */
+class MmapRandomAccessFile: public PixelsRandomAccessFile {
+public:
+	explicit MmapRandomAccessFile(const std::string& file);
+	void close() override;
+	std::shared_ptr<ByteBuffer> readFully(int len) override;
+	/**
+	 * The data is not copied into bb, the view of the mapping is returned instead.
+	 */
+	std::shared_ptr<ByteBuffer> readFully(int len, std::shared_ptr<ByteBuffer> bb) override;
+	long length() override;
+	void seek(long off) override;
+	long readLong() override;
+	char readChar() override;
+	int readInt() override;
+	/**
+	 * Tell the kernel to read the range into the page cache in the background (madvise WILLNEED),
+	 * so that the range is not faulted in page by page when it is decoded.
+	 */
+	void willNeed(long off, long len);
+	~MmapRandomAccessFile();
+private:
+	class MappedRegion;
+	class MappedByteBuffer;
+	void checkRange(long len) const;
+	std::shared_ptr<MappedRegion> region;
+	uint8_t * data;
+	long len;
+	long offset;
+};
+#endif // DUCKDB_MMAPRANDOMACCESSFILE_H
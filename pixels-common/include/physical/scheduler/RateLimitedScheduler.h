@@ -0,0 +1,72 @@
+#ifndef DUCKDB_RATELIMITEDSCHEDULER_H
+#define DUCKDB_RATELIMITEDSCHEDULER_H
+
+#include "physical/Scheduler.h"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * The scheduler throttles the reads of each device with two token buckets, one of bytes per second
+ * (read.request.ratelimit.bytes) and one of requests per second (read.request.ratelimit.iops). A
+ * batch waits until both buckets of its device are not in debt, then takes its tokens and is
+ * executed by NoopScheduler, so a batch larger than the burst still makes progress.
+ * While the batches of different queries wait for the same device, the batches of the query with
+ * the higher priority are admitted first. The devices are told apart by the st_dev of the files.
+ */
+class RateLimitedScheduler : public Scheduler {
+public:
+	static Scheduler * Instance();
+	std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader,
+	                                                      RequestBatch batch, long queryId) override;
+	std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
+	                                                      std::vector<std::shared_ptr<ByteBuffer>> reuseBuffers, long queryId) override;
+	/**
+	 * Set the priority of the reads of the query, the default priority is 0. The larger the
+	 * priority is, the earlier the reads are admitted. Each scan of the query sets the priority
+	 * and clears it when it is done, the priority is kept until the last scan clears it.
+	 */
+	static void SetQueryPriority(long queryId, int priority);
+	static void ClearQueryPriority(long queryId);
+	~RateLimitedScheduler();
+private:
+	RateLimitedScheduler();
+	struct TokenBucket {
+		// tokens per second, no limit if it is not positive
+		double rate;
+		double capacity;
+		double tokens;
+		void refill(double seconds);
+		// the seconds until the bucket is out of debt
+		double waitSeconds() const;
+	};
+	struct DeviceThrottle {
+		TokenBucket bytes;
+		TokenBucket iops;
+		std::chrono::steady_clock::time_point lastRefill;
+		// the number of waiting batches of each priority
+		std::map<int, int> waiters;
+	};
+	void acquire(const std::string& path, int priority, uint64_t bytes, uint64_t requests);
+	uint64_t getDevice(const std::string& path);
+	static int getQueryPriority(long queryId);
+	static Scheduler * instance;
+	static std::mutex priorityMutex;
+	struct QueryPriority {
+		int priority;
+		// the number of the scans which set the priority and have not cleared it yet
+		int scans;
+	};
+	static std::unordered_map<long, QueryPriority> queryPriorities;
+	std::mutex m;
+	std::condition_variable cv;
+	std::unordered_map<uint64_t, DeviceThrottle> devices;
+	std::unordered_map<std::string, uint64_t> deviceOfPath;
+	double bytesPerSecond;
+	double iops;
+};
+
+#endif // DUCKDB_RATELIMITEDSCHEDULER_H
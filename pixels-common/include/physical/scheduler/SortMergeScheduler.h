@@ -10,11 +10,21 @@
 #include<algorithm>
 #include "exception/InvalidArgumentException.h"
 
+/**
+ * The scheduler sorts the requests by offsets, and merges the requests whose gap is below the gap
+ * estimated by MergeGapEstimator. If the buffers of the requests are given, a merged request is read
+ * into them with one vectored read, which is asynchronous if localfs.enable.async.io is true and
+ * localfs.async.lib is iouring. The requests are not merged for the other async libs.
+ */
 class SortMergeScheduler : public Scheduler {
     // TODO: logger
 public:
     static Scheduler * Instance();
 	std::vector<std::shared_ptr<MergedRequest>> sortMerge(RequestBatch batch, long queryId);
+	/**
+	 * @param order set to the indexes of the requests in the batch, sorted by the offsets
+	 */
+	std::vector<std::shared_ptr<MergedRequest>> sortMerge(RequestBatch batch, int maxGap, std::vector<int>& order);
 	std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader,
 	                                                                          RequestBatch batch, long queryId) override;
 	std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
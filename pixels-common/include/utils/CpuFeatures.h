@@ -0,0 +1,33 @@
+#ifndef PIXELS_CPUFEATURES_H
+#define PIXELS_CPUFEATURES_H
+
+/**
+ * The SIMD instruction sets of the running CPU. The kernels that use them are compiled with
+ * target attributes instead of a global compiler flag, so they must only be called if the
+ * instruction set is reported here.
+ */
+class CpuFeatures {
+public:
+    enum class SimdLevel {
+        SCALAR,
+        AVX2,
+        AVX512
+    };
+
+    /**
+     * @return the widest instruction set of the running CPU that the kernels use, it is
+     * detected once
+     */
+    static SimdLevel GetSimdLevel();
+
+    /**
+     * Limit the kernels to the instruction set, e.g. to compare the kernels of each level in the
+     * tests. The level is never raised above the one supported by the running CPU.
+     */
+    static void SetSimdLevel(SimdLevel level);
+
+    static bool HasAvx2() {
+        return GetSimdLevel() != SimdLevel::SCALAR;
+    }
+};
+#endif //PIXELS_CPUFEATURES_H
@@ -0,0 +1,37 @@
+#ifndef PIXELS_TEXTPARSER_H
+#define PIXELS_TEXTPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Parse the values of the text files in place, without building std::string for them.
+ * The text is not required to be null-terminated. Each function returns false if the
+ * text is not in the format it expects, so that the caller can fall back to the slower
+ * and more lenient parsing.
+ */
+class TextParser {
+public:
+    static bool parseLong(const char *text, size_t length, int64_t &value);
+    /**
+     * "true" and "false" in any case.
+     */
+    static bool parseBool(const char *text, size_t length, bool &value);
+    /**
+     * @param value the decimal multiplied by 10^scale, the extra fractional digits are truncated
+     */
+    static bool parseDecimal(const char *text, size_t length, int scale, int64_t &value);
+    /**
+     * yyyy-mm-dd.
+     * @param days the days since 1970-01-01
+     */
+    static bool parseDate(const char *text, size_t length, int &days);
+    /**
+     * yyyy-mm-dd hh:mm:ss[.fraction], the time is taken as UTC.
+     * @param value the time since the epoch in the unit of 10^-precision second,
+     * the extra fractional digits are truncated
+     */
+    static bool parseTimestamp(const char *text, size_t length, int precision, int64_t &value);
+};
+
+#endif //PIXELS_TEXTPARSER_H
@@ -0,0 +1,37 @@
+#ifndef PIXELS_THREADPOOL_H
+#define PIXELS_THREADPOOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed number of threads that run the submitted tasks in order. The tasks must not
+ * wait for the other tasks of the pool, otherwise the pool may be deadlocked.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threadNum the number of threads, all the CPU cores are used if it is not positive
+     */
+    explicit ThreadPool(int threadNum);
+    ~ThreadPool();
+    /**
+     * @return the future that is ready when the task is done, it rethrows the exception of the task
+     */
+    std::future<void> submit(std::function<void()> task);
+    int getThreadNum() const;
+private:
+    void run();
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::packaged_task<void()>> tasks;
+    std::vector<std::thread> threads;
+    bool stopped;
+};
+
+#endif //PIXELS_THREADPOOL_H
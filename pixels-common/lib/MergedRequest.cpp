@@ -14,7 +14,7 @@ std::shared_ptr<MergedRequest> MergedRequest::merge(Request curr) {
         throw InvalidArgumentException("MergedRequest: Can not merge requests from different queries (transactions).");
     }
     long gap = curr.start - this->end;
-    if(gap <= maxGap && this->length + gap + curr.length <= std::numeric_limits<int>::max()) {
+    if(gap <= maxGap && this->size < MAX_MERGED_REQUEST_SIZE && this->length + gap + curr.length <= std::numeric_limits<int>::max()) {
         this->offsets.emplace_back(this->length + (int) gap);
         this->lengths.emplace_back(curr.length);
         this->length += gap + curr.length;
@@ -22,14 +22,18 @@ std::shared_ptr<MergedRequest> MergedRequest::merge(Request curr) {
         this->size++;
         return shared_from_this();
     }
-    return std::make_shared<MergedRequest>(curr);
+    return std::make_shared<MergedRequest>(curr, maxGap);
 }
 
-MergedRequest::MergedRequest(Request first) {
+MergedRequest::MergedRequest(Request first)
+    : MergedRequest(first, std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.gap"))) {
+}
+
+MergedRequest::MergedRequest(Request first, int maxGap) {
     this->queryId = first.queryId;
     this->start = first.start;
     this->end = first.start + first.length;
-    this->maxGap = std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.gap"));
+    this->maxGap = maxGap;
     this->offsets.emplace_back(0);
     this->lengths.emplace_back(first.length);
     this->length = first.length;
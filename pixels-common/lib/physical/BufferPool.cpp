@@ -3,86 +3,152 @@
 //
 
 #include "physical/BufferPool.h"
+#include <algorithm>
+#include <mutex>
 
-thread_local int BufferPool::colCount = 0;
-thread_local std::map<uint32_t, uint64_t> BufferPool::nrBytes;
-thread_local bool BufferPool::isInitialized = false;
-thread_local std::map<uint32_t, std::shared_ptr<ByteBuffer>> BufferPool::buffers[2];
-// The currBufferIdx is set to 1. When executing the first file, this value is 0
-// since we call switch function first.
-thread_local int BufferPool::currBufferIdx = 1;
-thread_local int BufferPool::nextBufferIdx = 0;
+thread_local std::vector<std::map<uint32_t, BufferPool::PoolBuffer>> BufferPool::slots;
+thread_local std::vector<bool> BufferPool::slotInUse;
+thread_local std::vector<std::vector<BufferPool::PoolBuffer>> BufferPool::freeBuffers;
+thread_local bool BufferPool::registrationDirty = false;
+thread_local BufferPool::ThreadBytes BufferPool::threadBytes;
+std::atomic<uint64_t> BufferPool::allocatedBytes{0};
 std::shared_ptr<DirectIoLib> BufferPool::directIoLib;
 
-void BufferPool::Initialize(std::vector<uint32_t> colIds, std::vector<uint64_t> bytes, std::vector<std::string> columnNames) {
+// the slot and cached buffers of the thread are freed with the thread, the other threads
+// can use their bytes afterwards
+BufferPool::ThreadBytes::~ThreadBytes() {
+	BufferPool::allocatedBytes -= bytes;
+}
+
+int BufferPool::GetMaxSlotNum() {
+	// two slots for the row group being scanned and the next one in the same file, the others
+	// for the prefetched morsels
+	return std::stoi(ConfigFactory::Instance().getProperty("pixel.prefetch.depth")) + 2;
+}
+
+int BufferPool::GetSizeClass(uint64_t bytes) {
+	int sizeClass = 0;
+	while(((uint64_t)MIN_POOL_BUFFER_SIZE << sizeClass) < bytes) {
+		sizeClass++;
+	}
+	return sizeClass;
+}
+
+std::shared_ptr<ByteBuffer> BufferPool::AllocateBuffer(int sizeClass) {
+	static std::once_flag initFlag;
+	std::call_once(initFlag, []() {
+		int fsBlockSize = std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size"));
+		directIoLib = std::make_shared<DirectIoLib>(fsBlockSize);
+	});
+	uint64_t size = (uint64_t)MIN_POOL_BUFFER_SIZE << sizeClass;
+	uint64_t budget = std::stoull(ConfigFactory::Instance().getProperty("pixel.prefetch.memory.budget"));
+	if(allocatedBytes.fetch_add(size) + size > budget) {
+		// give the cached buffers of this thread back to the budget and try again
+		allocatedBytes -= size;
+		ReleaseCachedBuffers();
+		if(allocatedBytes.fetch_add(size) + size > budget) {
+			allocatedBytes -= size;
+			return nullptr;
+		}
+	}
+	registrationDirty = true;
+	threadBytes.bytes += size;
+	return directIoLib->allocateDirectBuffer((long)size);
+}
+
+void BufferPool::ReleaseCachedBuffers() {
+	for(int sizeClass = 0; sizeClass < freeBuffers.size(); sizeClass++) {
+		if(!freeBuffers[sizeClass].empty()) {
+			uint64_t bytes = ((uint64_t)MIN_POOL_BUFFER_SIZE << sizeClass) * freeBuffers[sizeClass].size();
+			allocatedBytes -= bytes;
+			threadBytes.bytes -= bytes;
+			freeBuffers[sizeClass].clear();
+			registrationDirty = true;
+		}
+	}
+}
+
+int BufferPool::AcquireSlot(const std::vector<uint32_t>& colIds, const std::vector<uint64_t>& bytes,
+                            const std::vector<std::string>& columnNames) {
 	assert(colIds.size() == bytes.size());
+	// give the maximal column size, which is stored in csv reader, so that the buffers
+	// are large enough for the column chunks of all the files
+	static std::shared_ptr<ColumnSizeCSVReader> csvReader = []() {
+		std::string columnSizePath = ConfigFactory::Instance().getProperty("pixel.column.size.path");
+		return columnSizePath.empty() ? nullptr : std::make_shared<ColumnSizeCSVReader>(columnSizePath);
+	}();
 	int fsBlockSize = std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size"));
-    std::string columnSizePath = ConfigFactory::Instance().getProperty("pixel.column.size.path");
-    std::shared_ptr<ColumnSizeCSVReader> csvReader;
-    if (!columnSizePath.empty()) {
-        csvReader = std::make_shared<ColumnSizeCSVReader>(columnSizePath);
-    }
 
-    // give the maximal column size, which is stored in csv reader
-	if(!BufferPool::isInitialized) {
-        currBufferIdx = 0;
-        nextBufferIdx = 1;
-		directIoLib = std::make_shared<DirectIoLib>(fsBlockSize);
-		for(int i = 0; i < colIds.size(); i++) {
-			uint32_t colId = colIds.at(i);
-            std::string columnName = columnNames[colId];
-            for(int idx = 0; idx < 2; idx++) {
-                std::shared_ptr<ByteBuffer> buffer;
-                if (columnSizePath.empty()) {
-                    buffer = BufferPool::directIoLib->allocateDirectBuffer(bytes.at(i) + EXTRA_POOL_SIZE);
-                } else {
-                    buffer = BufferPool::directIoLib->allocateDirectBuffer(csvReader->get(columnName));
-                }
+	int slot = -1;
+	for(int i = 0; i < slotInUse.size(); i++) {
+		if(!slotInUse[i]) {
+			slot = i;
+			break;
+		}
+	}
+	if(slot < 0) {
+		if(slotInUse.size() >= GetMaxSlotNum()) {
+			return -1;
+		}
+		slot = (int)slotInUse.size();
+		slotInUse.emplace_back(false);
+		slots.emplace_back();
+	}
+	slotInUse[slot] = true;
 
-                BufferPool::nrBytes[colId] = buffer->size();
-                BufferPool::buffers[idx][colId] = buffer;
-            }
+	auto &slotBuffers = slots[slot];
+	for(int i = 0; i < colIds.size(); i++) {
+		uint32_t colId = colIds.at(i);
+		// the direct read is aligned to the block size on both sides
+		uint64_t size = bytes.at(i) + 2 * fsBlockSize;
+		if(csvReader != nullptr) {
+			size = std::max<uint64_t>(size, csvReader->get(columnNames[colId]));
+		}
+		int sizeClass = GetSizeClass(size);
+		if(sizeClass >= freeBuffers.size()) {
+			freeBuffers.resize(sizeClass + 1);
+		}
+		if(!freeBuffers[sizeClass].empty()) {
+			slotBuffers[colId] = freeBuffers[sizeClass].back();
+			freeBuffers[sizeClass].pop_back();
+			continue;
 		}
-		BufferPool::colCount = colIds.size();
-		BufferPool::isInitialized = true;
-	} else {
-		// check if resize the buffer is needed
-		assert(colIds.size() == BufferPool::colCount);
-		for (int i = 0; i < colIds.size(); i++) {
-			uint32_t colId = colIds.at(i);
-			uint64_t byte = bytes.at(i);
-            std::string columnName = columnNames[colId];
-			if (BufferPool::nrBytes.find(colId) == BufferPool::nrBytes.end()) {
-				throw InvalidArgumentException("BufferPool::Initialize: no such the column id.");
-			}
-			// Note: this code should never happen in the pixels scenario
-			if (BufferPool::nrBytes[colId] < byte) {
-				throw InvalidArgumentException("the new buffer byte cannot larger than the previous buffer byte. ");
-			}
+		auto buffer = AllocateBuffer(sizeClass);
+		if(buffer == nullptr) {
+			ReleaseSlot(slot);
+			return -1;
 		}
+		slotBuffers[colId] = PoolBuffer{buffer, sizeClass, -1};
 	}
+	return slot;
 }
 
-int64_t BufferPool::GetBufferId(uint32_t index) {
-    return index + currBufferIdx * colCount;
+void BufferPool::ReleaseSlot(int slot) {
+	// the slot may be already released by Reset() when the scan thread ends
+	if(slot < 0 || slot >= slotInUse.size() || !slotInUse[slot]) {
+		return;
+	}
+	for(auto &entry: slots[slot]) {
+		freeBuffers[entry.second.sizeClass].emplace_back(entry.second);
+	}
+	slots[slot].clear();
+	slotInUse[slot] = false;
 }
 
-std::shared_ptr<ByteBuffer> BufferPool::GetBuffer(uint32_t colId) {
-	return BufferPool::buffers[currBufferIdx][colId];
+int BufferPool::GetFreeSlotNum() {
+	return GetMaxSlotNum() - (int)std::count(slotInUse.begin(), slotInUse.end(), true);
 }
 
-void BufferPool::Reset() {
-	BufferPool::isInitialized = false;
-	BufferPool::nrBytes.clear();
-    for(int idx = 0; idx < 2; idx++) {
-        BufferPool::buffers[idx].clear();
-    }
-	BufferPool::colCount = 0;
+int64_t BufferPool::GetBufferId(int slot, uint32_t colId) {
+    return slots.at(slot).at(colId).registeredIndex;
 }
 
-void BufferPool::Switch() {
-    currBufferIdx = 1 - currBufferIdx;
-    nextBufferIdx = 1 - nextBufferIdx;
+std::shared_ptr<ByteBuffer> BufferPool::GetBuffer(int slot, uint32_t colId) {
+	return slots.at(slot).at(colId).buffer;
 }
 
-
+void BufferPool::Reset() {
+	for(int slot = 0; slot < slotInUse.size(); slot++) {
+		ReleaseSlot(slot);
+	}
+}
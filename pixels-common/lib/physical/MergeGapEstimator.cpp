@@ -0,0 +1,71 @@
+#include "physical/MergeGapEstimator.h"
+#include "utils/ConfigFactory.h"
+#include <algorithm>
+#include <cmath>
+
+// the weight of the older samples is multiplied by this factor for every new sample
+#define MERGE_GAP_DECAY 0.98
+// the gap is estimated after this many samples
+#define MERGE_GAP_MIN_SAMPLES 16
+
+MergeGapEstimator * MergeGapEstimator::instance = nullptr;
+
+MergeGapEstimator * MergeGapEstimator::Instance() {
+	static std::once_flag flag;
+	std::call_once(flag, []() {
+		instance = new MergeGapEstimator();
+	});
+	return instance;
+}
+
+MergeGapEstimator::MergeGapEstimator() {
+	maxGap = std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.gap"));
+	gap = maxGap;
+	weight = 0;
+	sumX = 0;
+	sumY = 0;
+	sumXX = 0;
+	sumXY = 0;
+	sampleNum = 0;
+}
+
+void MergeGapEstimator::addSample(uint64_t bytes, double seconds) {
+	if(seconds <= 0) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(m);
+	auto x = (double)bytes;
+	weight = weight * MERGE_GAP_DECAY + 1;
+	sumX = sumX * MERGE_GAP_DECAY + x;
+	sumY = sumY * MERGE_GAP_DECAY + seconds;
+	sumXX = sumXX * MERGE_GAP_DECAY + x * x;
+	sumXY = sumXY * MERGE_GAP_DECAY + x * seconds;
+	sampleNum++;
+	if(sampleNum < MERGE_GAP_MIN_SAMPLES) {
+		return;
+	}
+	double varX = weight * sumXX - sumX * sumX;
+	// the reads are of the same size, so the latency and the bandwidth can't be told apart
+	if(varX <= 1e-9 * weight * sumXX) {
+		return;
+	}
+	double secondsPerByte = (weight * sumXY - sumX * sumY) / varX;
+	double latency = (sumY - secondsPerByte * sumX) / weight;
+	if(secondsPerByte <= 0) {
+		// the time doesn't grow with the size, so the reads are dominated by the latency
+		gap = maxGap;
+	} else if(latency <= 0) {
+		gap = 0;
+	} else {
+		gap = (int)std::min<double>(maxGap, std::floor(latency / secondsPerByte));
+	}
+}
+
+int MergeGapEstimator::getMergeGap() {
+	std::lock_guard<std::mutex> lock(m);
+	return gap;
+}
+
+int MergeGapEstimator::getMaxMergeGap() const {
+	return maxGap;
+}
@@ -0,0 +1,36 @@
+#include "physical/PrefetchDepth.h"
+#include "utils/ConfigFactory.h"
+#include <algorithm>
+
+// a wait longer than this for the first row group of a prefetched morsel deepens the prefetch pipeline
+#define PREFETCH_STALL_MICROS 100
+// the number of prefetched morsels read in time in a row before the prefetch pipeline is shortened
+#define PREFETCH_SHRINK_HITS 4
+
+PrefetchDepth::PrefetchDepth()
+	: PrefetchDepth(std::stoi(ConfigFactory::Instance().getProperty("pixel.prefetch.depth"))) {
+}
+
+PrefetchDepth::PrefetchDepth(int maxDepth) {
+	this->maxDepth = std::max(maxDepth, 1);
+	depth = 1;
+	hitCount = 0;
+}
+
+void PrefetchDepth::update(int64_t waitMicros) {
+	if (waitMicros > PREFETCH_STALL_MICROS) {
+		depth = std::min(depth + 1, maxDepth);
+		hitCount = 0;
+	} else if (++hitCount >= PREFETCH_SHRINK_HITS) {
+		depth = std::max(depth - 1, 1);
+		hitCount = 0;
+	}
+}
+
+int PrefetchDepth::get() const {
+	return depth;
+}
+
+int PrefetchDepth::getMaxDepth() const {
+	return maxDepth;
+}
@@ -2,14 +2,17 @@
 // Created by liyu on 1/21/24.
 //
 #include "physical/StorageArrayScheduler.h"
+#include <sys/stat.h>
 
 
-StorageArrayScheduler::StorageArrayScheduler(std::vector<std::string> &files, int threadNum) {
+StorageArrayScheduler::StorageArrayScheduler(std::vector<std::string> &files, int threadNum,
+                                             const std::vector<int> &rowGroupNums) {
     std::unordered_map<std::string, int> device2id;
     int storageDepth = std::stoi(ConfigFactory::Instance().getProperty("storage.directory.depth"));
     filesVector.clear();
 
-    for (auto& file: files) {
+    for (int fileIdx = 0; fileIdx < files.size(); fileIdx++) {
+        auto& file = files.at(fileIdx);
         std::string deviceName;
         std::string tmp = file.substr(1);
         for(int i = 0; i < storageDepth; i++) {
@@ -27,22 +30,39 @@ StorageArrayScheduler::StorageArrayScheduler(std::vector<std::string> &files, in
         }
         int id = device2id[deviceName];
         if (id >= filesVector.size()) {
-            filesVector.emplace_back(std::vector<std::string>{});
+            filesVector.emplace_back(std::vector<ScanMorsel>{});
+        }
+        // the file size is only an estimation of the work, so a missing file is not an error here
+        struct stat fileStat{};
+        uint64_t fileSize = stat(file.c_str(), &fileStat) == 0 ? (uint64_t)fileStat.st_size : 0;
+        if (rowGroupNums.empty()) {
+            filesVector[id].emplace_back(ScanMorsel{file, 0, -1, fileSize});
+        } else {
+            int rgNum = rowGroupNums.at(fileIdx);
+            for (int rg = 0; rg < rgNum; rg++) {
+                filesVector[id].emplace_back(ScanMorsel{file, rg, 1, fileSize / rgNum});
+            }
         }
-        filesVector[id].emplace_back(file);
     }
 
     devicesNum = (int)filesVector.size();
-    if (files.size() > threadNum && devicesNum % threadNum != 0 && threadNum % devicesNum != 0) {
-        throw InvalidArgumentException("StorageArrayScheduler::initialize: "
-                                       "if multiple devices are used, make sure "
-                                       "the thread count is divisible by device num or"
-                                       "the device num is divisible by the thread count. "
-                                       "Now the thread count is " + std::to_string(threadNum) +
-                                       " , and the storage device num is " + std::to_string(devicesNum) +
-                                       ". Otherwise the load balancing issue occurs. ");
+    // threads whose device runs out of morsels steal from other devices, so the
+    // thread count doesn't need to match the device count
+    queueFront.assign(devicesNum, 0);
+    queueBack.resize(devicesNum);
+    remainingWeight.assign(devicesNum, 0);
+    inFlight.assign(devicesNum, 0);
+    batchIDs.resize(devicesNum);
+    for (int i = 0; i < devicesNum; i++) {
+        queueBack[i] = (int)filesVector[i].size();
+        batchIDs[i].assign(filesVector[i].size(), -1);
+        for (auto &morsel: filesVector[i]) {
+            remainingWeight[i] += morsel.weight;
+        }
     }
+    maxInFlight = std::stoi(ConfigFactory::Instance().getProperty("storage.device.max.inflight"));
     currentDeviceID = 0;
+    nextBatchID = 0;
 }
 
 int StorageArrayScheduler::acquireDeviceId() {
@@ -53,6 +73,42 @@ int StorageArrayScheduler::acquireDeviceId() {
     return deviceId;
 }
 
+bool StorageArrayScheduler::acquireMorsel(int &deviceID, int &fileID) {
+    std::lock_guard<std::mutex> lock(m);
+    int device = deviceID;
+    if (queueFront[device] < queueBack[device]) {
+        fileID = queueFront[device]++;
+    } else {
+        // steal from the device with the most remaining bytes which is not saturated
+        device = -1;
+        for (int i = 0; i < devicesNum; i++) {
+            if (queueFront[i] >= queueBack[i]) {
+                continue;
+            }
+            if (maxInFlight > 0 && inFlight[i] >= maxInFlight) {
+                continue;
+            }
+            if (device < 0 || remainingWeight[i] > remainingWeight[device]) {
+                device = i;
+            }
+        }
+        if (device < 0) {
+            return false;
+        }
+        fileID = --queueBack[device];
+    }
+    remainingWeight[device] -= filesVector[device][fileID].weight;
+    inFlight[device]++;
+    batchIDs[device][fileID] = nextBatchID++;
+    deviceID = device;
+    return true;
+}
+
+void StorageArrayScheduler::releaseMorsel(int deviceID) {
+    std::lock_guard<std::mutex> lock(m);
+    inFlight[deviceID]--;
+}
+
 int StorageArrayScheduler::getDeviceSum() {
     return devicesNum;
 }
@@ -61,7 +117,15 @@ uint64_t StorageArrayScheduler::getFileSum(int deviceID) {
 }
 
 std::string StorageArrayScheduler::getFileName(int deviceID, int fileID) {
-    return filesVector.at(deviceID).at(fileID);
+    return filesVector.at(deviceID).at(fileID).file;
+}
+
+int StorageArrayScheduler::getRGStart(int deviceID, int fileID) {
+    return filesVector.at(deviceID).at(fileID).rgStart;
+}
+
+int StorageArrayScheduler::getRGLen(int deviceID, int fileID) {
+    return filesVector.at(deviceID).at(fileID).rgLen;
 }
 
 int StorageArrayScheduler::getMaxFileSum() {
@@ -73,11 +137,7 @@ int StorageArrayScheduler::getMaxFileSum() {
 }
 
 int StorageArrayScheduler::getBatchID(int deviceID, int fileID) {
-    int result = 0;
-    for(int i = 0; i < deviceID; i++) {
-        result += (int)filesVector[i].size();
-    }
-    result += fileID;
-    return result;
+    std::lock_guard<std::mutex> lock(m);
+    return batchIDs.at(deviceID).at(fileID);
 }
 
@@ -68,26 +68,71 @@ std::string PhysicalLocalReader::getName() {
     return path.substr(path.find_last_of('/') + 1);
 }
 
+std::string PhysicalLocalReader::getPath() {
+    return path;
+}
+
+bool PhysicalLocalReader::supportsZeroCopy() {
+	return std::dynamic_pointer_cast<MmapRandomAccessFile>(raf) != nullptr;
+}
+
+void PhysicalLocalReader::willNeed(long offset, long length) {
+	auto mmapRaf = std::dynamic_pointer_cast<MmapRandomAccessFile>(raf);
+	if(mmapRaf != nullptr) {
+		mmapRaf->willNeed(offset, length);
+	}
+}
+
 std::shared_ptr<ByteBuffer> PhysicalLocalReader::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index) {
 	numRequests++;
 	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
 		return directRaf->readAsync(length, std::move(buffer), index);
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
-		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+		auto aioRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		return aioRaf->readAsync(length, std::move(buffer), index);
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
 
 }
 
+std::vector<std::shared_ptr<ByteBuffer>> PhysicalLocalReader::readFullyVectored(const std::vector<long>& offsets,
+                                                                                const std::vector<int>& lengths,
+                                                                                const std::vector<std::shared_ptr<ByteBuffer>>& buffers) {
+	numRequests++;
+	auto directRaf = std::dynamic_pointer_cast<DirectRandomAccessFile>(raf);
+	if(directRaf != nullptr) {
+		return directRaf->readFullyVectored(offsets, lengths, buffers);
+	}
+	std::vector<std::shared_ptr<ByteBuffer>> results;
+	for(int i = 0; i < offsets.size(); i++) {
+		raf->seek(offsets[i]);
+		results.emplace_back(raf->readFully(lengths[i], buffers[i]));
+	}
+	return results;
+}
+
+std::vector<std::shared_ptr<ByteBuffer>> PhysicalLocalReader::readAsyncVectored(const std::vector<long>& offsets,
+                                                                                const std::vector<int>& lengths,
+                                                                                const std::vector<std::shared_ptr<ByteBuffer>>& buffers) {
+	numRequests++;
+	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
+		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
+		return directRaf->readAsyncVectored(offsets, lengths, buffers);
+	} else {
+		throw InvalidArgumentException("PhysicalLocalReader::readAsyncVectored: the vectored async read is only supported by io_uring. ");
+	}
+}
+
 void PhysicalLocalReader::readAsyncSubmit(uint32_t size) {
 	numRequests++;
 	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
 		directRaf->readAsyncSubmit(size);
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
-		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+		auto aioRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		aioRaf->readAsyncSubmit(size);
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
@@ -99,7 +144,8 @@ void PhysicalLocalReader::readAsyncComplete(uint32_t size) {
 		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
 		directRaf->readAsyncComplete(size);
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
-		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+		auto aioRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		aioRaf->readAsyncComplete(size);
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
@@ -114,7 +160,11 @@ void PhysicalLocalReader::readAsyncSubmitAndComplete(uint32_t size){
 		directRaf->readAsyncComplete(size);
 		::TimeProfiler::Instance().End("async wait");
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
-		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+		auto aioRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		aioRaf->readAsyncSubmit(size);
+		::TimeProfiler::Instance().Start("async wait");
+		aioRaf->readAsyncComplete(size);
+		::TimeProfiler::Instance().End("async wait");
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
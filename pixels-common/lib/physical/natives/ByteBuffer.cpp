@@ -14,6 +14,7 @@
  Modfied 2015 by Ashley Davis (SgtCoDFish)
  */
 
+#include <algorithm>
 #include <utility>
 
 #include "physical/natives/ByteBuffer.h"
@@ -215,17 +216,35 @@ void ByteBuffer::put(uint8_t b, uint32_t index) {
 }
 
 void ByteBuffer::putBytes(uint8_t* b, uint32_t len) {
-    // Insert the data one byte at a time into the internal buffer at position i+starting index
-    for (uint32_t i = 0; i < len; i++)
-        append<uint8_t>(b[i]);
+    if (len == 0) {
+        return;
+    }
+    ensureWritable(len);
+    memcpy(buf + wpos, b, len);
+    wpos += len;
 }
 
 void ByteBuffer::putBytes(uint8_t* b, uint32_t len, uint32_t index) {
     wpos = index;
+    putBytes(b, len);
+}
 
-    // Insert the data one byte at a time into the internal buffer at position i+starting index
-    for (uint32_t i = 0; i < len; i++)
-        append<uint8_t>(b[i]);
+void ByteBuffer::ensureWritable(uint32_t len) {
+    if (wpos + len <= bufSize) {
+        return;
+    }
+    if (fromOtherBB || !allocated_by_new) {
+        throw std::runtime_error("Append exceeds the size of buffer");
+    }
+    // double the buffer, so that the cost of the copies is amortized over the appends
+    uint32_t newSize = std::max<uint32_t>(bufSize * 2, wpos + len);
+    auto newBuf = new uint8_t[newSize];
+    if (buf != nullptr) {
+        memcpy(newBuf, buf, wpos);
+        delete[] buf;
+    }
+    buf = newBuf;
+    bufSize = newSize;
 }
 
 void ByteBuffer::putChar(char value) {
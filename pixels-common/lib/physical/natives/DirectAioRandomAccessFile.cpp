@@ -0,0 +1,215 @@
+//
+// Created by agent on 10/18/26.
+//
+#include "physical/natives/DirectAioRandomAccessFile.h"
+#include "utils/ConfigFactory.h"
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+thread_local aio_context_t DirectAioRandomAccessFile::context = 0;
+thread_local unsigned DirectAioRandomAccessFile::contextDepth = 0;
+std::atomic<uint64_t> DirectAioRandomAccessFile::fileCount{0};
+thread_local std::unordered_map<uint64_t, uint32_t> DirectAioRandomAccessFile::pendingRequests;
+thread_local std::unordered_map<uint64_t, DirectAioRandomAccessFile::AioRead> DirectAioRandomAccessFile::reads;
+thread_local uint64_t DirectAioRandomAccessFile::nextReadId = 0;
+
+// besides the row groups of the prefetched morsels, a reader reads its current and its next row group
+#define AIO_EXTRA_ROW_GROUPS 2
+
+namespace {
+int ioSetup(unsigned nrEvents, aio_context_t *ctx) {
+	return (int)syscall(SYS_io_setup, nrEvents, ctx);
+}
+
+int ioDestroy(aio_context_t ctx) {
+	return (int)syscall(SYS_io_destroy, ctx);
+}
+
+int ioSubmit(aio_context_t ctx, long nr, struct iocb **iocbs) {
+	return (int)syscall(SYS_io_submit, ctx, nr, iocbs);
+}
+
+int ioGetEvents(aio_context_t ctx, long minNr, long maxNr, struct io_event *events) {
+	return (int)syscall(SYS_io_getevents, ctx, minNr, maxNr, events, nullptr);
+}
+
+// destroys the AIO context of the thread when the thread exits
+struct AioContextGuard {
+	aio_context_t *context;
+	~AioContextGuard() {
+		if(*context != 0) {
+			ioDestroy(*context);
+			*context = 0;
+		}
+	}
+};
+}
+
+DirectAioRandomAccessFile::DirectAioRandomAccessFile(const std::string &file) : DirectRandomAccessFile(file) {
+	fileTag = fileCount++;
+	batchSeq = 0;
+}
+
+void DirectAioRandomAccessFile::Initialize(int columnNum) {
+	static thread_local AioContextGuard guard{&context};
+	(void)guard;
+	int depth = std::stoi(ConfigFactory::Instance().getProperty("pixel.prefetch.depth"));
+	unsigned events = (unsigned)(std::max(depth, 1) + AIO_EXTRA_ROW_GROUPS) * (unsigned)std::max(columnNum, 1);
+	if(context != 0 && (contextDepth >= events || !pendingRequests.empty())) {
+		return;
+	}
+	if(context != 0) {
+		ioDestroy(context);
+		context = 0;
+	}
+	// the events of all the contexts are bounded by fs.aio-max-nr, the reads are done
+	// synchronously if the context can't be created
+	if(ioSetup(events, &context) < 0) {
+		context = 0;
+		contextDepth = 0;
+		return;
+	}
+	contextDepth = events;
+}
+
+void DirectAioRandomAccessFile::Reset() {
+	// the buffers of the pending requests may be reused by the next scan
+	while(context != 0 && !pendingRequests.empty()) {
+		reapCompletion();
+	}
+}
+
+DirectAioRandomAccessFile::~DirectAioRandomAccessFile() {
+
+}
+
+std::shared_ptr<ByteBuffer> DirectAioRandomAccessFile::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index) {
+	struct iocb request{};
+	request.aio_lio_opcode = IOCB_CMD_PREAD;
+	request.aio_fildes = fd;
+	request.aio_buf = (uint64_t)(uintptr_t)buffer->getPointer();
+	request.aio_data = nextReadId++;
+	std::shared_ptr<ByteBuffer> result;
+	if(enableDirect) {
+		// the file will be read from blockStart(fileOffset), and the first fileDelta bytes should be ignored.
+		uint64_t fileOffsetAligned = directIoLib->blockStart(offset);
+		request.aio_nbytes = directIoLib->blockEnd(offset + length) - directIoLib->blockStart(offset);
+		request.aio_offset = (int64_t)fileOffsetAligned;
+		result = std::make_shared<ByteBuffer>(*buffer, offset - fileOffsetAligned, length);
+	} else {
+		request.aio_nbytes = length;
+		request.aio_offset = offset;
+		result = std::make_shared<ByteBuffer>(*buffer, 0, length);
+	}
+	// with direct I/O, the last block of the read may be beyond the end of the file
+	uint64_t expectedBytes = std::min<uint64_t>(request.aio_nbytes,
+	                                            (uint64_t)std::max<long>(this->length() - (long)request.aio_offset, 0));
+	preparedRequests.emplace_back(AioRead{currentTag(), request, expectedBytes});
+	seek(offset + length);
+	return result;
+}
+
+uint64_t DirectAioRandomAccessFile::currentTag() const {
+	return (fileTag << 24) | (batchSeq & 0xFFFFFF);
+}
+
+void DirectAioRandomAccessFile::readAsyncSubmit(int size) {
+	if(preparedRequests.size() != size) {
+		throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncSubmit: submit fails");
+	}
+	if(context == 0) {
+		// no AIO context, so the reads are done now and readAsyncComplete has nothing to wait for
+		for(auto &read : preparedRequests) {
+			finishRead(read, 0);
+		}
+	} else {
+		std::vector<struct iocb *> requests;
+		for(auto &read : preparedRequests) {
+			requests.emplace_back(&read.request);
+			reads.emplace(read.request.aio_data, read);
+		}
+		// io_submit may take only a part of the requests if the context is busy
+		int submitted = 0;
+		while(submitted < size) {
+			int ret = ioSubmit(context, size - submitted, requests.data() + submitted);
+			if(ret < 0 && errno == EAGAIN && !pendingRequests.empty()) {
+				reapCompletion();
+				continue;
+			}
+			if(ret <= 0) {
+				for(int i = submitted; i < size; i++) {
+					reads.erase(requests[i]->aio_data);
+				}
+				throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncSubmit: submit fails");
+			}
+			submitted += ret;
+			pendingRequests[currentTag()] += ret;
+		}
+	}
+	if(size > 0) {
+		submittedBatches.emplace_back(currentTag(), size);
+		batchSeq++;
+	}
+	preparedRequests.clear();
+}
+
+void DirectAioRandomAccessFile::reapCompletion() {
+	struct io_event event{};
+	int ret;
+	do {
+		ret = ioGetEvents(context, 1, 1, &event);
+	} while(ret < 0 && errno == EINTR);
+	if(ret != 1) {
+		throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: get events fails");
+	}
+	auto it = reads.find(event.data);
+	if(it == reads.end()) {
+		throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: unknown completion");
+	}
+	AioRead read = it->second;
+	reads.erase(it);
+	auto pending = pendingRequests.find(read.tag);
+	if(pending != pendingRequests.end() && --pending->second == 0) {
+		pendingRequests.erase(pending);
+	}
+	if(event.res < 0) {
+		throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: read fails");
+	}
+	if((uint64_t)event.res < read.expectedBytes) {
+		finishRead(read, (uint64_t)event.res);
+	}
+}
+
+void DirectAioRandomAccessFile::finishRead(const AioRead &read, uint64_t bytes) {
+	// the rest of the read is read until the end of the read, like readFullyVectored does
+	auto buffer = (uint8_t *)(uintptr_t)read.request.aio_buf;
+	while(bytes < read.expectedBytes) {
+		ssize_t ret = pread((int)read.request.aio_fildes, buffer + bytes, read.request.aio_nbytes - bytes,
+		                    (off_t)(read.request.aio_offset + bytes));
+		if(ret == -1) {
+			if(errno == EINTR) {
+				continue;
+			}
+			throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: read fails");
+		}
+		if(ret == 0) {
+			throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: the file ends before the read");
+		}
+		bytes += (uint64_t)ret;
+	}
+}
+
+void DirectAioRandomAccessFile::readAsyncComplete(int size) {
+	int remaining = size;
+	while(remaining > 0 && !submittedBatches.empty()) {
+		auto batch = submittedBatches.front();
+		while(pendingRequests.count(batch.first)) {
+			reapCompletion();
+		}
+		submittedBatches.pop_front();
+		remaining -= (int)batch.second;
+	}
+}
@@ -12,6 +12,14 @@
 #include "profiler/TimeProfiler.h"
 #include "physical/allocator/OrdinaryAllocator.h"
 #include "physical/allocator/BufferPoolAllocator.h"
+#include "physical/MergeGapEstimator.h"
+#include "exception/InvalidArgumentException.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+
+thread_local std::shared_ptr<ByteBuffer> DirectRandomAccessFile::gapBuffer = nullptr;
+
 DirectRandomAccessFile::DirectRandomAccessFile(const std::string& file) {
     FILE * fp = fopen(file.c_str(), "r");
     // checking if the file exist or not
@@ -141,7 +149,109 @@ void DirectRandomAccessFile::populatedBuffer() {
 
 }
 
+VectoredRead DirectRandomAccessFile::planVectoredRead(const std::vector<long>& offsets,
+                                                      const std::vector<int>& lengths,
+                                                      const std::vector<std::shared_ptr<ByteBuffer>>& buffers) {
+	int n = (int)offsets.size();
+	if(n == 0 || lengths.size() != n || buffers.size() != n) {
+		throw InvalidArgumentException("DirectRandomAccessFile::planVectoredRead: the chunks don't match the buffers. ");
+	}
+	if(gapBuffer == nullptr) {
+		long size = std::max<long>(directIoLib->blockEnd(MergeGapEstimator::Instance()->getMaxMergeGap()), fsBlockSize);
+		gapBuffer = directIoLib->allocateDirectBuffer(size);
+	}
+	// buffer i receives the file range [starts[i], ends[i]). With direct I/O, the ranges are aligned
+	// to blocks, so a chunk that shares its last block with the next chunk leaves the block to the next one
+	std::vector<long> starts(n);
+	std::vector<long> ends(n);
+	for(int i = 0; i < n; i++) {
+		starts[i] = enableDirect ? directIoLib->blockStart(offsets[i]) : offsets[i];
+	}
+	for(int i = 0; i < n; i++) {
+		long chunkEnd = offsets[i] + lengths[i];
+		ends[i] = enableDirect ? directIoLib->blockEnd(chunkEnd) : chunkEnd;
+		if(i + 1 < n) {
+			ends[i] = std::min(ends[i], starts[i + 1]);
+		}
+		if(starts[i] > ends[i] || (long)buffers[i]->size() < std::max(ends[i], chunkEnd) - starts[i]) {
+			throw InvalidArgumentException("DirectRandomAccessFile::planVectoredRead: the buffer is too small. ");
+		}
+	}
+	VectoredRead read;
+	read.fileOffset = starts[0];
+	read.results.resize(n);
+	for(int i = 0; i < n; i++) {
+		if(ends[i] > starts[i]) {
+			read.iovecs.push_back({buffers[i]->getPointer(), (size_t)(ends[i] - starts[i])});
+		}
+		if(i + 1 < n) {
+			long gap = starts[i + 1] - ends[i];
+			while(gap > 0) {
+				long piece = std::min<long>(gap, gapBuffer->size());
+				read.iovecs.push_back({gapBuffer->getPointer(), (size_t)piece});
+				gap -= piece;
+			}
+		}
+		read.results[i] = std::make_shared<ByteBuffer>(*buffers[i], offsets[i] - starts[i], lengths[i]);
+		// the rest of the chunk is in the ranges of the later buffers
+		long from = std::max(offsets[i], ends[i]);
+		long to = offsets[i] + lengths[i];
+		for(int j = i + 1; j < n && from < to; j++) {
+			long copyStart = std::max(from, starts[j]);
+			long copyEnd = std::min(to, ends[j]);
+			if(copyStart < copyEnd) {
+				read.tailCopies.push_back({buffers[i]->getPointer() + (copyStart - starts[i]),
+				                           buffers[j]->getPointer() + (copyStart - starts[j]),
+				                           (size_t)(copyEnd - copyStart)});
+				from = copyEnd;
+			}
+		}
+	}
+	read.bytes = ends[n - 1] - starts[0];
+	return read;
+}
 
+void VectoredRead::finish() const {
+	for(auto& copy: tailCopies) {
+		memcpy(copy.dst, copy.src, copy.length);
+	}
+}
 
-
-
+std::vector<std::shared_ptr<ByteBuffer>> DirectRandomAccessFile::readFullyVectored(const std::vector<long>& offsets,
+                                                                                   const std::vector<int>& lengths,
+                                                                                   const std::vector<std::shared_ptr<ByteBuffer>>& buffers) {
+	auto read = planVectoredRead(offsets, lengths, buffers);
+	// preadv takes at most IOV_MAX iovecs and may read less than requested, so the rest
+	// of the iovecs are read until the end of the range or the end of the file
+	auto iovecs = read.iovecs;
+	size_t first = 0;
+	long fileOffset = read.fileOffset;
+	while(first < iovecs.size()) {
+		int count = (int)std::min<size_t>(iovecs.size() - first, IOV_MAX);
+		ssize_t bytes = preadv(fd, iovecs.data() + first, count, fileOffset);
+		if(bytes == -1) {
+			if(errno == EINTR) {
+				continue;
+			}
+			throw std::runtime_error("preadv fail");
+		}
+		// with direct I/O, the last block of the range may be beyond the end of the file
+		if(bytes == 0) {
+			break;
+		}
+		fileOffset += bytes;
+		while(bytes > 0) {
+			if((size_t)bytes >= iovecs[first].iov_len) {
+				bytes -= (ssize_t)iovecs[first].iov_len;
+				first++;
+			} else {
+				iovecs[first].iov_base = (uint8_t *)iovecs[first].iov_base + bytes;
+				iovecs[first].iov_len -= bytes;
+				bytes = 0;
+			}
+		}
+	}
+	read.finish();
+	seek(offsets.back() + lengths.back());
+	return read.results;
+}
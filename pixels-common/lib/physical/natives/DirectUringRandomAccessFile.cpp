@@ -2,115 +2,248 @@
 // Created by liyu on 5/28/23.
 //
 #include "physical/natives/DirectUringRandomAccessFile.h"
+#include "physical/MergeGapEstimator.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 
-thread_local struct io_uring * DirectUringRandomAccessFile::ring = nullptr;
-thread_local bool DirectUringRandomAccessFile::isRegistered = false;
-thread_local struct iovec * DirectUringRandomAccessFile::iovecs = nullptr;
-thread_local uint32_t DirectUringRandomAccessFile::iovecSize = 0;
+std::atomic<uint64_t> DirectUringRandomAccessFile::fileCount{0};
+thread_local DirectUringRandomAccessFile::RingState DirectUringRandomAccessFile::state;
 
-DirectUringRandomAccessFile::DirectUringRandomAccessFile(const std::string &file) : DirectRandomAccessFile(file) {
+// the number of files that can be registered to the ring of a thread at the same time
+#define URING_FILE_TABLE_SIZE 1024
+#define URING_QUEUE_DEPTH 4096
 
+// destroys the ring of the thread when the thread exits
+DirectUringRandomAccessFile::RingState::~RingState() {
+	DirectUringRandomAccessFile::Destroy();
 }
 
-void DirectUringRandomAccessFile::RegisterBufferFromPool(std::vector<uint32_t> colIds) {
-    std::vector<std::shared_ptr<ByteBuffer>> tmpBuffers;
-    if(!isRegistered) {
-        for(auto buffer : ::BufferPool::buffers) {
-            for(auto colId : colIds) {
-                tmpBuffers.emplace_back(buffer[colId]);
-            }
-        }
-        iovecs = (iovec *)calloc(tmpBuffers.size() ,sizeof(struct iovec));
-        iovecSize = tmpBuffers.size();
-        for(auto i = 0; i < tmpBuffers.size(); i++) {
-            auto buffer = tmpBuffers.at(i);
-            iovecs[i].iov_base = buffer->getPointer();
-            iovecs[i].iov_len = buffer->size();
-            memset(iovecs[i].iov_base, 0, buffer->size());
-        }
-        int ret = io_uring_register_buffers(ring, iovecs, iovecSize);
-        if(ret != 0) {
-            throw InvalidArgumentException("DirectUringRandomAccessFile::RegisterBuffer: register buffer fails. ");
-        }
-        isRegistered = true;
-    }
+DirectUringRandomAccessFile::DirectUringRandomAccessFile(const std::string &file) : DirectRandomAccessFile(file) {
+	fileTag = fileCount++;
+	batchSeq = 0;
+	preparedRequests = 0;
+	preparedSqes = 0;
+	preparedBytes = 0;
+	registeredFileIndex = -1;
+	registeredRing = nullptr;
 }
 
-
+void DirectUringRandomAccessFile::RegisterBufferFromPool() {
+	// the registered buffers can't be replaced under the reads in flight
+	if(state.ring == nullptr || !::BufferPool::registrationDirty || !state.pendingRequests.empty()) {
+		return;
+	}
+	std::vector<::BufferPool::PoolBuffer *> poolBuffers;
+	for(auto &slot : ::BufferPool::slots) {
+		for(auto &entry : slot) {
+			poolBuffers.emplace_back(&entry.second);
+		}
+	}
+	for(auto &sizeClass : ::BufferPool::freeBuffers) {
+		for(auto &poolBuffer : sizeClass) {
+			poolBuffers.emplace_back(&poolBuffer);
+		}
+	}
+	if(state.isRegistered) {
+		io_uring_unregister_buffers(state.ring);
+		state.isRegistered = false;
+	}
+	if(state.iovecs != nullptr) {
+		free(state.iovecs);
+		state.iovecs = nullptr;
+	}
+	for(auto poolBuffer : poolBuffers) {
+		poolBuffer->registeredIndex = -1;
+	}
+	::BufferPool::registrationDirty = false;
+	if(poolBuffers.empty()) {
+		return;
+	}
+	state.iovecs = (iovec *)calloc(poolBuffers.size(), sizeof(struct iovec));
+	state.iovecSize = poolBuffers.size();
+	for(int i = 0; i < poolBuffers.size(); i++) {
+		state.iovecs[i].iov_base = poolBuffers[i]->buffer->getPointer();
+		state.iovecs[i].iov_len = poolBuffers[i]->buffer->size();
+	}
+	// the buffers are read with plain reads if they cannot be registered, e.g., due to RLIMIT_MEMLOCK
+	if(io_uring_register_buffers(state.ring, state.iovecs, state.iovecSize) == 0) {
+		for(int i = 0; i < poolBuffers.size(); i++) {
+			poolBuffers[i]->registeredIndex = i;
+		}
+		state.isRegistered = true;
+	}
+}
 
 void DirectUringRandomAccessFile::RegisterBuffer(std::vector<std::shared_ptr<ByteBuffer>> buffers) {
-	if(!isRegistered) {
-		iovecs = (iovec *)calloc(buffers.size() ,sizeof(struct iovec));
-		iovecSize = buffers.size();
+	if(!state.isRegistered) {
+		state.iovecs = (iovec *)calloc(buffers.size() ,sizeof(struct iovec));
+		state.iovecSize = buffers.size();
 		for(auto i = 0; i < buffers.size(); i++) {
 			auto buffer = buffers.at(i);
-			iovecs[i].iov_base = buffer->getPointer();
-			iovecs[i].iov_len = buffer->size();
-			memset(iovecs[i].iov_base, 0, buffer->size());
+			state.iovecs[i].iov_base = buffer->getPointer();
+			state.iovecs[i].iov_len = buffer->size();
+			memset(state.iovecs[i].iov_base, 0, buffer->size());
 		}
-		int ret = io_uring_register_buffers(ring, iovecs, iovecSize);
+		int ret = io_uring_register_buffers(state.ring, state.iovecs, state.iovecSize);
 		if(ret != 0) {
 			throw InvalidArgumentException("DirectUringRandomAccessFile::RegisterBuffer: register buffer fails. ");
 		}
-		isRegistered = true;
+		state.isRegistered = true;
 	}
 }
 
 void DirectUringRandomAccessFile::Initialize() {
 	// initialize io_uring ring
-	if(ring == nullptr) {
-		ring = new io_uring();
-		if(io_uring_queue_init(4096, ring, 0) < 0) {
+	if(state.ring == nullptr) {
+		state.ring = new io_uring();
+		int ret = -1;
+		if(ConfigFactory::Instance().boolCheckProperty("localfs.iouring.sqpoll")) {
+			// a kernel thread polls the submission queue, so that submitting needs no syscall
+			struct io_uring_params params{};
+			params.flags = IORING_SETUP_SQPOLL;
+			params.sq_thread_idle = std::stoi(ConfigFactory::Instance().getProperty("localfs.iouring.sqpoll.idle"));
+			ret = io_uring_queue_init_params(URING_QUEUE_DEPTH, state.ring, &params);
+		}
+		// SQPOLL may be not permitted for the user, so fall back to the normal ring
+		if(ret < 0 && io_uring_queue_init(URING_QUEUE_DEPTH, state.ring, 0) < 0) {
+			delete(state.ring);
+			state.ring = nullptr;
 			throw InvalidArgumentException("DirectRandomAccessFile: initialize io_uring fails.");
 		}
+		// register a sparse file table, the files are put into it when they are read
+		std::vector<int> fds(URING_FILE_TABLE_SIZE, -1);
+		state.filesRegistered = io_uring_register_files(state.ring, fds.data(), URING_FILE_TABLE_SIZE) == 0;
+		state.fileSlotUsed.assign(URING_FILE_TABLE_SIZE, false);
 	}
+	RegisterBufferFromPool();
 }
 
 void DirectUringRandomAccessFile::Reset() {
     // Important! Because sometimes ring is nullptr here.
-    // For example, two threads A and B share the same global state. If A finish all files while B just starts,
-    // B would execute Reset function from InitLocal. If we don't set this 'if' branch, ring would be double freed.
-    if(ring != nullptr) {
-        // We don't use this function anymore since it slows down the speed
-        //		if(io_uring_unregister_buffers(ring) != 0) {
-        //			throw InvalidArgumentException("DirectUringRandomAccessFile::UnregisterBuffer: unregister buffer fails. ");
-        //		}
-        io_uring_queue_exit(ring);
-        delete(ring);
-        ring = nullptr;
-        isRegistered = false;
+    // For example, two threads A and B share the same global  If A finish all files while B just starts,
+    // B would execute Reset function from InitLocal.
+    if(state.ring == nullptr) {
+        return;
+    }
+    // the buffers of the pending requests may be reused by the next scan
+    while(!state.pendingRequests.empty()) {
+        reapCompletion();
+    }
+    // the closed files are already removed from the file table, the remaining ones won't be
+    // read by this thread anymore
+    int empty = -1;
+    for(int i = 0; i < state.fileSlotUsed.size(); i++) {
+        if(state.fileSlotUsed[i]) {
+            io_uring_register_files_update(state.ring, i, &empty, 1);
+            state.fileSlotUsed[i] = false;
+        }
+    }
+}
+
+void DirectUringRandomAccessFile::Destroy() {
+    if(state.ring != nullptr) {
+        io_uring_queue_exit(state.ring);
+        delete(state.ring);
+        state.ring = nullptr;
+        state.isRegistered = false;
+        state.filesRegistered = false;
+        state.fileSlotUsed.clear();
     }
-    if(iovecs != nullptr) {
-        free(iovecs);
-        iovecs = nullptr;
+    state.pendingRequests.clear();
+    state.reads.clear();
+    if(state.iovecs != nullptr) {
+        free(state.iovecs);
+        state.iovecs = nullptr;
     }
 }
 
+int DirectUringRandomAccessFile::getFileIndex() {
+	if(!state.filesRegistered) {
+		return -1;
+	}
+	if(registeredRing == state.ring && registeredFileIndex >= 0) {
+		return registeredFileIndex;
+	}
+	auto it = std::find(state.fileSlotUsed.begin(), state.fileSlotUsed.end(), false);
+	if(it == state.fileSlotUsed.end()) {
+		return -1;
+	}
+	int index = (int)(it - state.fileSlotUsed.begin());
+	if(io_uring_register_files_update(state.ring, index, &fd, 1) != 1) {
+		return -1;
+	}
+	state.fileSlotUsed[index] = true;
+	registeredFileIndex = index;
+	registeredRing = state.ring;
+	return index;
+}
+
+void DirectUringRandomAccessFile::close() {
+	// the file table only belongs to the ring of the thread that registered the file
+	if(registeredFileIndex >= 0 && registeredRing == state.ring && state.ring != nullptr) {
+		int empty = -1;
+		io_uring_register_files_update(state.ring, registeredFileIndex, &empty, 1);
+		state.fileSlotUsed[registeredFileIndex] = false;
+	}
+	registeredFileIndex = -1;
+	registeredRing = nullptr;
+	DirectRandomAccessFile::close();
+}
+
 DirectUringRandomAccessFile::~DirectUringRandomAccessFile() {
 
 }
 
 std::shared_ptr<ByteBuffer> DirectUringRandomAccessFile::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index) {
 	if(enableDirect) {
-		struct io_uring_sqe * sqe = io_uring_get_sqe(ring);
-//		if(length > iovecs[index].iov_len) {
+		struct io_uring_sqe * sqe = io_uring_get_sqe(state.ring);
+//		if(length > state.iovecs[index].iov_len) {
 //			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsync: the length is larger than buffer length.");
 //		}
 		// the file will be read from blockStart(fileOffset), and the first fileDelta bytes should be ignored.
 		uint64_t fileOffsetAligned = directIoLib->blockStart(offset);
 		uint64_t toRead = directIoLib->blockEnd(offset + length) - directIoLib->blockStart(offset);
-        io_uring_prep_read_fixed(sqe, fd, buffer->getPointer(), toRead,
-		                         fileOffsetAligned, index);
+		int fileIndex = getFileIndex();
+		int target = fileIndex >= 0 ? fileIndex : fd;
+		if(index >= 0) {
+			io_uring_prep_read_fixed(sqe, target, buffer->getPointer(), toRead,
+			                         fileOffsetAligned, index);
+		} else {
+			io_uring_prep_read(sqe, target, buffer->getPointer(), toRead, fileOffsetAligned);
+		}
+		if(fileIndex >= 0) {
+			io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+		}
+		struct iovec iov{buffer->getPointer(), toRead};
+		prepareRead(sqe, &iov, 1, (long)fileOffsetAligned);
+		preparedRequests++;
+		preparedSqes++;
+		preparedBytes += toRead;
 		auto bb = std::make_shared<ByteBuffer>(*buffer,
 		                                       offset - fileOffsetAligned, length);
 		seek(offset + length);
 		return bb;
 	} else {
-		struct io_uring_sqe * sqe = io_uring_get_sqe(ring);
-//		if(length > iovecs[index].iov_len) {
+		struct io_uring_sqe * sqe = io_uring_get_sqe(state.ring);
+//		if(length > state.iovecs[index].iov_len) {
 //			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsync: the length is larger than buffer length.");
 //		}
-		io_uring_prep_read_fixed(sqe, fd, buffer->getPointer(), length, offset, index);
+		int fileIndex = getFileIndex();
+		int target = fileIndex >= 0 ? fileIndex : fd;
+		if(index >= 0) {
+			io_uring_prep_read_fixed(sqe, target, buffer->getPointer(), length, offset, index);
+		} else {
+			io_uring_prep_read(sqe, target, buffer->getPointer(), length, offset);
+		}
+		if(fileIndex >= 0) {
+			io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+		}
+		struct iovec iov{buffer->getPointer(), (size_t)length};
+		prepareRead(sqe, &iov, 1, offset);
+		preparedRequests++;
+		preparedSqes++;
+		preparedBytes += length;
 		seek(offset + length);
 		auto result = std::make_shared<ByteBuffer>(*buffer, 0, length);
 		return result;
@@ -119,23 +252,154 @@ std::shared_ptr<ByteBuffer> DirectUringRandomAccessFile::readAsync(int length, s
 }
 
 
+std::vector<std::shared_ptr<ByteBuffer>> DirectUringRandomAccessFile::readAsyncVectored(const std::vector<long>& offsets,
+                                                                                       const std::vector<int>& lengths,
+                                                                                       const std::vector<std::shared_ptr<ByteBuffer>>& buffers) {
+	auto read = planVectoredRead(offsets, lengths, buffers);
+	int fileIndex = getFileIndex();
+	int target = fileIndex >= 0 ? fileIndex : fd;
+	// a readv takes at most IOV_MAX iovecs, so a long plan is split into several readvs
+	long fileOffset = read.fileOffset;
+	for(size_t first = 0; first < read.iovecs.size(); first += IOV_MAX) {
+		unsigned count = (unsigned)std::min<size_t>(read.iovecs.size() - first, IOV_MAX);
+		struct io_uring_sqe * sqe = io_uring_get_sqe(state.ring);
+		// the registered buffers can't be used by readv
+		io_uring_prep_readv(sqe, target, read.iovecs.data() + first, count, fileOffset);
+		if(fileIndex >= 0) {
+			io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+		}
+		prepareRead(sqe, read.iovecs.data() + first, count, fileOffset);
+		preparedSqes++;
+		for(size_t i = first; i < first + count; i++) {
+			fileOffset += (long)read.iovecs[i].iov_len;
+		}
+	}
+	preparedRequests += offsets.size();
+	preparedBytes += read.bytes;
+	seek(offsets.back() + lengths.back());
+	auto results = read.results;
+	// moving the vector keeps the address of the iovecs in the sqe
+	preparedVectoredReads.emplace_back(std::move(read));
+	return results;
+}
+
+uint64_t DirectUringRandomAccessFile::currentTag() const {
+	return (fileTag << 24) | (batchSeq & 0xFFFFFF);
+}
+
+void DirectUringRandomAccessFile::prepareRead(struct io_uring_sqe * sqe, const struct iovec * iovecs,
+                                              unsigned count, long fileOffset) {
+	UringRead read{currentTag(), fd, fileOffset, std::vector<struct iovec>(iovecs, iovecs + count), 0};
+	uint64_t bytes = 0;
+	for(auto &iovec : read.iovecs) {
+		bytes += iovec.iov_len;
+	}
+	// with direct I/O, the last block of the read may be beyond the end of the file
+	read.expectedBytes = std::min<uint64_t>(bytes, (uint64_t)std::max<long>(length() - fileOffset, 0));
+	uint64_t id = state.nextReadId++;
+	state.reads.emplace(id, std::move(read));
+	io_uring_sqe_set_data(sqe, (void *)(uintptr_t)id);
+}
+
 void DirectUringRandomAccessFile::readAsyncSubmit(int size) {
-	int ret = io_uring_submit(ring);
-	if(ret != size) {
+	// the merged requests are submitted as one vectored read, so fewer sqes than size may be submitted
+	int ret = io_uring_submit(state.ring);
+	if(ret != (int)preparedSqes) {
 		throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncSubmit: submit fails");
 	}
+	if(preparedSqes > 0) {
+		state.pendingRequests[currentTag()] += preparedSqes;
+		submittedBatches.push_back(SubmittedBatch{currentTag(), preparedRequests, preparedBytes,
+		                                          std::chrono::steady_clock::now(),
+		                                          std::move(preparedVectoredReads)});
+		batchSeq++;
+		preparedRequests = 0;
+		preparedSqes = 0;
+		preparedBytes = 0;
+		preparedVectoredReads.clear();
+	}
 }
 
-void DirectUringRandomAccessFile::readAsyncComplete(int size) {
+void DirectUringRandomAccessFile::reapCompletion() {
 	// Important! We cannot write the code as io_uring_wait_cqe_nr(ring, &cqe, iovecSize).
 	// The reason is unclear, but some random bugs would happen. It takes me nearly a week to find this bug
 	struct io_uring_cqe *cqe;
-	for(int i = 0; i < size; i++) {
-		if(io_uring_wait_cqe_nr(ring, &cqe, 1) != 0) {
-			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: wait cqe fails");
-		}
-		io_uring_cqe_seen(ring, cqe);
+	if(io_uring_wait_cqe_nr(state.ring, &cqe, 1) != 0) {
+		throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: wait cqe fails");
+	}
+	auto id = (uint64_t)(uintptr_t)io_uring_cqe_get_data(cqe);
+	int res = cqe->res;
+	io_uring_cqe_seen(state.ring, cqe);
+	auto it = state.reads.find(id);
+	if(it == state.reads.end()) {
+		throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: unknown completion");
+	}
+	UringRead read = std::move(it->second);
+	state.reads.erase(it);
+	auto pending = state.pendingRequests.find(read.tag);
+	if(pending != state.pendingRequests.end() && --pending->second == 0) {
+		state.pendingRequests.erase(pending);
+	}
+	if(res < 0) {
+		throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: read fails");
+	}
+	if((uint64_t)res < read.expectedBytes) {
+		finishShortRead(read, (uint64_t)res);
 	}
 }
 
+void DirectUringRandomAccessFile::finishShortRead(UringRead &read, uint64_t bytes) {
+	// the rest of the iovecs are read until the end of the read, like readFullyVectored does
+	size_t first = 0;
+	uint64_t done = 0;
+	long fileOffset = read.fileOffset;
+	while(true) {
+		done += bytes;
+		fileOffset += (long)bytes;
+		while(bytes > 0) {
+			if(bytes >= read.iovecs[first].iov_len) {
+				bytes -= read.iovecs[first].iov_len;
+				first++;
+			} else {
+				read.iovecs[first].iov_base = (uint8_t *)read.iovecs[first].iov_base + bytes;
+				read.iovecs[first].iov_len -= bytes;
+				bytes = 0;
+			}
+		}
+		if(done >= read.expectedBytes) {
+			return;
+		}
+		ssize_t ret = preadv(read.fd, read.iovecs.data() + first, (int)(read.iovecs.size() - first), fileOffset);
+		if(ret == -1) {
+			if(errno == EINTR) {
+				continue;
+			}
+			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: read fails");
+		}
+		if(ret == 0) {
+			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: the file ends before the read");
+		}
+		bytes = (uint64_t)ret;
+	}
+}
 
+void DirectUringRandomAccessFile::readAsyncComplete(int size) {
+	int remaining = size;
+	while(remaining > 0 && !submittedBatches.empty()) {
+		auto& batch = submittedBatches.front();
+		bool waited = state.pendingRequests.count(batch.tag) > 0;
+		while(state.pendingRequests.count(batch.tag)) {
+			reapCompletion();
+		}
+		// the completion time is only known if the batch completes while it is waited for
+		if(waited) {
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - batch.submitTime).count();
+			MergeGapEstimator::Instance()->addSample(batch.bytes, seconds);
+		}
+		for(auto& read: batch.vectoredReads) {
+			read.finish();
+		}
+		remaining -= (int)batch.requests;
+		submittedBatches.pop_front();
+	}
+}
@@ -0,0 +1,132 @@
+#include "physical/natives/MmapRandomAccessFile.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <algorithm>
+
+/**
+ * The mapping shared by the file and the views handed out by it.
+ */
+class MmapRandomAccessFile::MappedRegion {
+public:
+	MappedRegion(uint8_t * addr, size_t size): addr(addr), size(size) {}
+	~MappedRegion() {
+		if(addr != nullptr) {
+			munmap(addr, size);
+		}
+	}
+	uint8_t * addr;
+	size_t size;
+};
+
+/**
+ * A view of the mapping, which keeps the mapping alive but never frees the memory itself.
+ */
+class MmapRandomAccessFile::MappedByteBuffer: public ByteBuffer {
+public:
+	MappedByteBuffer(std::shared_ptr<MappedRegion> region, uint8_t * addr, uint32_t size)
+	    : ByteBuffer(addr, size, false), region(std::move(region)) {
+		fromOtherBB = true;
+	}
+private:
+	std::shared_ptr<MappedRegion> region;
+};
+
+MmapRandomAccessFile::MmapRandomAccessFile(const std::string& file) {
+	int fd = open(file.c_str(), O_RDONLY);
+	if(fd == -1) {
+		throw std::runtime_error("MmapRandomAccessFile: File not found or fd exceeds the limitation. ");
+	}
+	struct stat st{};
+	if(fstat(fd, &st) != 0) {
+		::close(fd);
+		throw std::runtime_error("MmapRandomAccessFile: failed to stat " + file);
+	}
+	len = st.st_size;
+	offset = 0;
+	data = nullptr;
+	if(len > 0) {
+		void * addr = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+		if(addr == MAP_FAILED) {
+			::close(fd);
+			throw std::runtime_error("MmapRandomAccessFile: failed to map " + file);
+		}
+		data = (uint8_t *) addr;
+		// only the target column chunks are read, so the readahead of the kernel is
+		// mostly wasted on the other columns. The chunks are hinted by willNeed() instead
+		madvise(addr, len, MADV_RANDOM);
+	}
+	// the mapping stays valid after the descriptor is closed
+	::close(fd);
+	region = std::make_shared<MappedRegion>(data, (size_t) len);
+}
+
+void MmapRandomAccessFile::close() {
+	region.reset();
+	data = nullptr;
+	offset = 0;
+	len = 0;
+}
+
+void MmapRandomAccessFile::checkRange(long size) const {
+	if(data == nullptr || size < 0 || offset < 0 || offset + size > len) {
+		throw std::runtime_error("MmapRandomAccessFile: read beyond the end of the file");
+	}
+}
+
+std::shared_ptr<ByteBuffer> MmapRandomAccessFile::readFully(int size) {
+	checkRange(size);
+	auto buffer = std::make_shared<MappedByteBuffer>(region, data + offset, (uint32_t) size);
+	seek(offset + size);
+	return buffer;
+}
+
+std::shared_ptr<ByteBuffer> MmapRandomAccessFile::readFully(int size, std::shared_ptr<ByteBuffer> bb) {
+	return readFully(size);
+}
+
+long MmapRandomAccessFile::length() {
+	return len;
+}
+
+void MmapRandomAccessFile::seek(long off) {
+	offset = off;
+}
+
+long MmapRandomAccessFile::readLong() {
+	checkRange(sizeof(long));
+	long value;
+	memcpy(&value, data + offset, sizeof(long));
+	offset += sizeof(long);
+	return value;
+}
+
+int MmapRandomAccessFile::readInt() {
+	checkRange(sizeof(int));
+	int value;
+	memcpy(&value, data + offset, sizeof(int));
+	offset += sizeof(int);
+	return value;
+}
+
+char MmapRandomAccessFile::readChar() {
+	checkRange(sizeof(char));
+	char value = (char) data[offset];
+	offset += sizeof(char);
+	return value;
+}
+
+void MmapRandomAccessFile::willNeed(long off, long size) {
+	if(data == nullptr || off < 0 || size <= 0 || off >= len) {
+		return;
+	}
+	size = std::min(size, len - off);
+	// madvise needs an address aligned to the page
+	static const long pageSize = sysconf(_SC_PAGESIZE);
+	long alignedOff = off / pageSize * pageSize;
+	madvise(data + alignedOff, size + off - alignedOff, MADV_WILLNEED);
+}
+
+MmapRandomAccessFile::~MmapRandomAccessFile() = default;
@@ -0,0 +1,141 @@
+#include "physical/scheduler/RateLimitedScheduler.h"
+#include "physical/scheduler/NoopScheduler.h"
+#include "utils/ConfigFactory.h"
+#include <sys/stat.h>
+#include <algorithm>
+
+// the buckets hold at most this many seconds of tokens, which bounds the burst after an idle period
+#define RATE_LIMIT_BURST_SECONDS 0.1
+// the waiting batches check the buckets at least this often, since a batch of a higher priority may leave
+#define RATE_LIMIT_MAX_WAIT_MICROS 10000
+#define RATE_LIMIT_MIN_WAIT_MICROS 50
+
+Scheduler * RateLimitedScheduler::instance = nullptr;
+std::mutex RateLimitedScheduler::priorityMutex;
+std::unordered_map<long, RateLimitedScheduler::QueryPriority> RateLimitedScheduler::queryPriorities;
+
+Scheduler * RateLimitedScheduler::Instance() {
+	if(instance == nullptr) {
+		instance = new RateLimitedScheduler();
+	}
+	return instance;
+}
+
+RateLimitedScheduler::RateLimitedScheduler() {
+	bytesPerSecond = std::stod(ConfigFactory::Instance().getProperty("read.request.ratelimit.bytes"));
+	iops = std::stod(ConfigFactory::Instance().getProperty("read.request.ratelimit.iops"));
+}
+
+void RateLimitedScheduler::SetQueryPriority(long queryId, int priority) {
+	std::lock_guard<std::mutex> lock(priorityMutex);
+	auto &queryPriority = queryPriorities[queryId];
+	queryPriority.priority = priority;
+	queryPriority.scans++;
+}
+
+void RateLimitedScheduler::ClearQueryPriority(long queryId) {
+	std::lock_guard<std::mutex> lock(priorityMutex);
+	auto it = queryPriorities.find(queryId);
+	if(it != queryPriorities.end() && --it->second.scans <= 0) {
+		queryPriorities.erase(it);
+	}
+}
+
+int RateLimitedScheduler::getQueryPriority(long queryId) {
+	std::lock_guard<std::mutex> lock(priorityMutex);
+	auto it = queryPriorities.find(queryId);
+	return it == queryPriorities.end() ? 0 : it->second.priority;
+}
+
+void RateLimitedScheduler::TokenBucket::refill(double seconds) {
+	if(rate > 0) {
+		tokens = std::min(capacity, tokens + rate * seconds);
+	}
+}
+
+double RateLimitedScheduler::TokenBucket::waitSeconds() const {
+	if(rate <= 0 || tokens >= 0) {
+		return 0;
+	}
+	return -tokens / rate;
+}
+
+uint64_t RateLimitedScheduler::getDevice(const std::string& path) {
+	auto it = deviceOfPath.find(path);
+	if(it != deviceOfPath.end()) {
+		return it->second;
+	}
+	// the files which can't be stated share one bucket
+	struct stat fileStat{};
+	uint64_t device = stat(path.c_str(), &fileStat) == 0 ? (uint64_t)fileStat.st_dev : 0;
+	deviceOfPath[path] = device;
+	return device;
+}
+
+void RateLimitedScheduler::acquire(const std::string& path, int priority, uint64_t bytes, uint64_t requests) {
+	std::unique_lock<std::mutex> lock(m);
+	uint64_t deviceId = getDevice(path);
+	auto it = devices.find(deviceId);
+	if(it == devices.end()) {
+		DeviceThrottle throttle;
+		throttle.bytes = TokenBucket{bytesPerSecond, bytesPerSecond * RATE_LIMIT_BURST_SECONDS,
+		                             bytesPerSecond * RATE_LIMIT_BURST_SECONDS};
+		throttle.iops = TokenBucket{iops, std::max(1.0, iops * RATE_LIMIT_BURST_SECONDS),
+		                            std::max(1.0, iops * RATE_LIMIT_BURST_SECONDS)};
+		throttle.lastRefill = std::chrono::steady_clock::now();
+		it = devices.emplace(deviceId, throttle).first;
+	}
+	DeviceThrottle& device = it->second;
+	device.waiters[priority]++;
+	while(true) {
+		auto now = std::chrono::steady_clock::now();
+		double elapsed = std::chrono::duration<double>(now - device.lastRefill).count();
+		device.bytes.refill(elapsed);
+		device.iops.refill(elapsed);
+		device.lastRefill = now;
+		double waitSeconds = std::max(device.bytes.waitSeconds(), device.iops.waitSeconds());
+		bool highest = device.waiters.rbegin()->first <= priority;
+		if(highest && waitSeconds <= 0) {
+			break;
+		}
+		long waitMicros = highest ? (long)(waitSeconds * 1e6) : RATE_LIMIT_MAX_WAIT_MICROS;
+		waitMicros = std::min<long>(std::max<long>(waitMicros, RATE_LIMIT_MIN_WAIT_MICROS),
+		                            RATE_LIMIT_MAX_WAIT_MICROS);
+		cv.wait_for(lock, std::chrono::microseconds(waitMicros));
+	}
+	if(--device.waiters[priority] == 0) {
+		device.waiters.erase(priority);
+	}
+	// the bucket may go into debt, which is paid by the next batches
+	if(device.bytes.rate > 0) {
+		device.bytes.tokens -= (double)bytes;
+	}
+	if(device.iops.rate > 0) {
+		device.iops.tokens -= (double)requests;
+	}
+	lock.unlock();
+	// the batches of the lower priorities may be admitted now
+	cv.notify_all();
+}
+
+std::vector<std::shared_ptr<ByteBuffer>> RateLimitedScheduler::executeBatch(std::shared_ptr<PhysicalReader> reader,
+                                                                            RequestBatch batch, long queryId) {
+	return executeBatch(reader, batch, {}, queryId);
+}
+
+std::vector<std::shared_ptr<ByteBuffer>> RateLimitedScheduler::executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
+                                                      std::vector<std::shared_ptr<ByteBuffer>> reuseBuffers, long queryId) {
+	if((bytesPerSecond > 0 || iops > 0) && batch.getSize() > 0) {
+		uint64_t bytes = 0;
+		for(auto& request: batch.getRequests()) {
+			bytes += request.length;
+		}
+		acquire(reader->getPath(), getQueryPriority(queryId), bytes, (uint64_t)batch.getSize());
+	}
+	return NoopScheduler::Instance()->executeBatch(reader, batch, reuseBuffers, queryId);
+}
+
+RateLimitedScheduler::~RateLimitedScheduler() {
+	delete instance;
+	instance = nullptr;
+}
@@ -5,6 +5,9 @@
 #include "physical/scheduler/SortMergeScheduler.h"
 #include "utils/ConfigFactory.h"
 #include "exception/InvalidArgumentException.h"
+#include "physical/MergeGapEstimator.h"
+#include "physical/io/PhysicalLocalReader.h"
+#include <chrono>
 
 Scheduler * SortMergeScheduler::instance = nullptr;
 
@@ -24,16 +27,65 @@ std::vector<std::shared_ptr<ByteBuffer>> SortMergeScheduler::executeBatch(std::s
 
 std::vector<std::shared_ptr<ByteBuffer>> SortMergeScheduler::executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
                                                       std::vector<std::shared_ptr<ByteBuffer>> reuseBuffers, long queryId) {
-    if(batch.getSize() < 0) {
+    if(batch.getSize() <= 0) {
         return std::vector<std::shared_ptr<ByteBuffer>>{};
     }
-    auto mergeRequests = sortMerge(batch, queryId);
-    std::vector<std::shared_ptr<ByteBuffer>> bbs;
+    auto requests = batch.getRequests();
+    bool async = ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io") && !reuseBuffers.empty();
+    auto localReader = std::dynamic_pointer_cast<PhysicalLocalReader>(reader);
+    int maxGap = MergeGapEstimator::Instance()->getMergeGap();
+    if(!reuseBuffers.empty() && (localReader == nullptr ||
+       (async && ConfigFactory::Instance().getProperty("localfs.async.lib") != "iouring"))) {
+        // the requests are read into their own buffers, which needs the vectored read
+        maxGap = -1;
+    }
+    std::vector<int> order;
+    auto mergeRequests = sortMerge(batch, maxGap, order);
+    // the buffers are returned in the order of the requests in the batch
+    std::vector<std::shared_ptr<ByteBuffer>> bbs(batch.getSize());
+    int next = 0;
     for(auto merged : mergeRequests) {
-        reader->seek(merged->getStart());
-        auto buffer = reader->readFully(merged->getLength());
-        auto separateBuffers = merged->complete(buffer);
-        bbs.insert(bbs.end(), separateBuffers.begin(), separateBuffers.end());
+        int first = next;
+        next += merged->getSize();
+        auto startTime = std::chrono::steady_clock::now();
+        if(reuseBuffers.empty()) {
+            reader->seek(merged->getStart());
+            auto buffer = reader->readFully(merged->getLength());
+            auto separateBuffers = merged->complete(buffer);
+            for(int i = 0; i < merged->getSize(); i++) {
+                bbs.at(order[first + i]) = separateBuffers.at(i);
+            }
+        } else if(merged->getSize() == 1 || localReader == nullptr) {
+            auto& request = requests.at(order[first]);
+            reader->seek(request.start);
+            if(async) {
+                bbs.at(order[first]) = localReader->readAsync(request.length, reuseBuffers.at(order[first]), request.bufferId);
+            } else {
+                bbs.at(order[first]) = reader->readFully(request.length, reuseBuffers.at(order[first]));
+            }
+        } else {
+            std::vector<long> offsets;
+            std::vector<int> lengths;
+            std::vector<std::shared_ptr<ByteBuffer>> buffers;
+            for(int i = first; i < next; i++) {
+                offsets.emplace_back(requests.at(order[i]).start);
+                lengths.emplace_back(requests.at(order[i]).length);
+                buffers.emplace_back(reuseBuffers.at(order[i]));
+            }
+            auto separateBuffers = async ? localReader->readAsyncVectored(offsets, lengths, buffers) :
+                                   localReader->readFullyVectored(offsets, lengths, buffers);
+            for(int i = 0; i < merged->getSize(); i++) {
+                bbs.at(order[first + i]) = separateBuffers.at(i);
+            }
+        }
+        // the async reads are sampled when they complete
+        if(!async) {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            MergeGapEstimator::Instance()->addSample(merged->getLength(), seconds);
+        }
+    }
+    if(async) {
+        localReader->readAsyncSubmit(batch.getSize());
     }
     return bbs;
 }
@@ -43,16 +95,26 @@ SortMergeScheduler::SortMergeScheduler() {
 }
 
 std::vector<std::shared_ptr<MergedRequest>> SortMergeScheduler::sortMerge(RequestBatch batch, long queryId) {
+    std::vector<int> order;
+    return sortMerge(batch, MergeGapEstimator::Instance()->getMergeGap(), order);
+}
+
+std::vector<std::shared_ptr<MergedRequest>> SortMergeScheduler::sortMerge(RequestBatch batch, int maxGap,
+                                                                          std::vector<int>& order) {
     auto requests = batch.getRequests();
-    std::sort(requests.begin(), requests.end(), [](const Request& lhs, const Request& rhs) {
-        return lhs.start < rhs.start;
+    order.resize(requests.size());
+    for(int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&requests](int lhs, int rhs) {
+        return requests[lhs].start < requests[rhs].start;
     });
 
     std::vector<std::shared_ptr<MergedRequest>> mergedRequests;
-    auto mr1 = std::make_shared<MergedRequest>(requests.at(0));
+    auto mr1 = std::make_shared<MergedRequest>(requests.at(order.at(0)), maxGap);
     auto mr2 = mr1;
     for(int i = 1; i < batch.getSize(); i++) {
-        mr2 = mr1->merge(requests.at(i));
+        mr2 = mr1->merge(requests.at(order.at(i)));
         if(mr1 == mr2) {
             continue;
         }
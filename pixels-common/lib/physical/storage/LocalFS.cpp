@@ -5,6 +5,8 @@
 #include "physical/storage/LocalFS.h"
 #include "physical/natives/DirectRandomAccessFile.h"
 #include "physical/natives/DirectUringRandomAccessFile.h"
+#include "physical/natives/DirectAioRandomAccessFile.h"
+#include "physical/natives/MmapRandomAccessFile.h"
 #include "physical/FilePath.h"
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -31,11 +33,13 @@ std::string LocalFS::ensureSchemePrefix(const std::string &path) const {
 }
 
 std::shared_ptr<PixelsRandomAccessFile> LocalFS::openRaf(const std::string& path) {
-    if(true) {
-        // TODO: change this class to mmap class in the future.
-        return std::make_shared<DirectUringRandomAccessFile>(path);
+    if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.mmap")) {
+        return std::make_shared<MmapRandomAccessFile>(path);
+    } else if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io") &&
+       ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+        return std::make_shared<DirectAioRandomAccessFile>(path);
     } else {
-        return std::make_shared<DirectRandomAccessFile>(path);
+        return std::make_shared<DirectUringRandomAccessFile>(path);
     }
 }
 
@@ -0,0 +1,26 @@
+#include "utils/CpuFeatures.h"
+#include <algorithm>
+#include <atomic>
+
+static CpuFeatures::SimdLevel DetectSimdLevel() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return CpuFeatures::SimdLevel::AVX512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        return CpuFeatures::SimdLevel::AVX2;
+    }
+    return CpuFeatures::SimdLevel::SCALAR;
+}
+
+static std::atomic<CpuFeatures::SimdLevel> &CurrentSimdLevel() {
+    static std::atomic<CpuFeatures::SimdLevel> level{DetectSimdLevel()};
+    return level;
+}
+
+CpuFeatures::SimdLevel CpuFeatures::GetSimdLevel() {
+    return CurrentSimdLevel().load(std::memory_order_relaxed);
+}
+
+void CpuFeatures::SetSimdLevel(SimdLevel level) {
+    CurrentSimdLevel().store(std::min(level, DetectSimdLevel()), std::memory_order_relaxed);
+}
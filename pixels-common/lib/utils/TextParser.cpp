@@ -0,0 +1,143 @@
+#include "utils/TextParser.h"
+#include <charconv>
+#include <cctype>
+
+// the digits of an int64 that never overflow
+#define TEXT_PARSER_MAX_DIGITS 18
+
+static const int64_t POWERS_OF_TEN[] = {
+        1L, 10L, 100L, 1000L, 10000L, 100000L, 1000000L, 10000000L, 100000000L, 1000000000L,
+        10000000000L, 100000000000L, 1000000000000L, 10000000000000L, 100000000000000L,
+        1000000000000000L, 10000000000000000L, 100000000000000000L, 1000000000000000000L};
+
+// parse exactly n digits
+static inline bool parseDigits(const char *text, int n, int &value) {
+    value = 0;
+    for (int i = 0; i < n; ++i) {
+        auto digit = static_cast<unsigned>(text[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + static_cast<int>(digit);
+    }
+    return true;
+}
+
+// the days from 1970-01-01 to the date in the proleptic Gregorian calendar
+static inline int daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+bool TextParser::parseLong(const char *text, size_t length, int64_t &value) {
+    auto result = std::from_chars(text, text + length, value);
+    return result.ec == std::errc() && result.ptr == text + length;
+}
+
+bool TextParser::parseBool(const char *text, size_t length, bool &value) {
+    static const char *TRUE_TEXT = "true";
+    static const char *FALSE_TEXT = "false";
+    const char *expected = length == 4 ? TRUE_TEXT : (length == 5 ? FALSE_TEXT : nullptr);
+    if (expected == nullptr) {
+        return false;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (std::tolower(static_cast<unsigned char>(text[i])) != expected[i]) {
+            return false;
+        }
+    }
+    value = length == 4;
+    return true;
+}
+
+bool TextParser::parseDecimal(const char *text, size_t length, int scale, int64_t &value) {
+    if (scale < 0 || scale > TEXT_PARSER_MAX_DIGITS) {
+        return false;
+    }
+    const char *p = text;
+    const char *end = text + length;
+    bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) {
+        ++p;
+    }
+    int64_t unscaled = 0;
+    int digits = 0;
+    int fractionDigits = 0;
+    bool hasPoint = false;
+    bool hasDigit = false;
+    for (; p < end; ++p) {
+        if (*p == '.' && !hasPoint) {
+            hasPoint = true;
+            continue;
+        }
+        auto digit = static_cast<unsigned>(*p - '0');
+        if (digit > 9) {
+            return false;
+        }
+        hasDigit = true;
+        if (hasPoint) {
+            if (fractionDigits == scale) {
+                // truncated
+                continue;
+            }
+            fractionDigits++;
+        }
+        if (unscaled != 0 || digit != 0) {
+            if (++digits > TEXT_PARSER_MAX_DIGITS) {
+                return false;
+            }
+        }
+        unscaled = unscaled * 10 + digit;
+    }
+    if (!hasDigit || digits + scale - fractionDigits > TEXT_PARSER_MAX_DIGITS) {
+        return false;
+    }
+    unscaled *= POWERS_OF_TEN[scale - fractionDigits];
+    value = negative ? -unscaled : unscaled;
+    return true;
+}
+
+bool TextParser::parseDate(const char *text, size_t length, int &days) {
+    int year, month, day;
+    if (length != 10 || text[4] != '-' || text[7] != '-' ||
+        !parseDigits(text, 4, year) || !parseDigits(text + 5, 2, month) || !parseDigits(text + 8, 2, day) ||
+        month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    days = daysFromCivil(year, month, day);
+    return true;
+}
+
+bool TextParser::parseTimestamp(const char *text, size_t length, int precision, int64_t &value) {
+    int days, hour, minute, second;
+    if (precision < 0 || precision > 9 || length < 19 || (text[10] != ' ' && text[10] != 'T') ||
+        text[13] != ':' || text[16] != ':' || !parseDate(text, 10, days) ||
+        !parseDigits(text + 11, 2, hour) || !parseDigits(text + 14, 2, minute) ||
+        !parseDigits(text + 17, 2, second) || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+    int64_t fraction = 0;
+    int fractionDigits = 0;
+    if (length > 19) {
+        if (text[19] != '.' || length == 20) {
+            return false;
+        }
+        for (size_t i = 20; i < length; ++i) {
+            auto digit = static_cast<unsigned>(text[i] - '0');
+            if (digit > 9) {
+                return false;
+            }
+            if (fractionDigits < precision) {
+                fraction = fraction * 10 + digit;
+                fractionDigits++;
+            }
+        }
+    }
+    int64_t seconds = static_cast<int64_t>(days) * 86400 + hour * 3600 + minute * 60 + second;
+    value = seconds * POWERS_OF_TEN[precision] + fraction * POWERS_OF_TEN[precision - fractionDigits];
+    return true;
+}
@@ -0,0 +1,55 @@
+#include "utils/ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadNum) {
+    if (threadNum <= 0) {
+        threadNum = (int) std::max(1u, std::thread::hardware_concurrency());
+    }
+    stopped = false;
+    for (int i = 0; i < threadNum; i++) {
+        threads.emplace_back(&ThreadPool::run, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stopped = true;
+    }
+    cv.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> packagedTask(std::move(task));
+    std::future<void> future = packagedTask.get_future();
+    {
+        std::lock_guard<std::mutex> lock(m);
+        tasks.push_back(std::move(packagedTask));
+    }
+    cv.notify_one();
+    return future;
+}
+
+int ThreadPool::getThreadNum() const {
+    return (int) threads.size();
+}
+
+void ThreadPool::run() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [this] { return stopped || !tasks.empty(); });
+            // the tasks left are still run, their futures may be waited for
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -32,7 +32,26 @@ public:
     void set();
     void set(long index, uint8_t value);
     void setByteAligned(long index, uint8_t value);
+    /**
+     * Clear the bits in [from, to).
+     */
+    void clear(long from, long to);
     uint8_t get(long index);
+    /**
+     * @return the index of the first set bit in [from, to), or to if there is none
+     */
+    long nextSetBit(long from, long to);
+    /**
+     * @return the index of the first clear bit in [from, to), or to if there is none
+     */
+    long nextClearBit(long from, long to);
+    /**
+     * Write the positions (relative to offset) of the set bits in [offset, offset + count)
+     * into the selection array, which must hold at least count entries.
+     *
+     * @return the number of set bits
+     */
+    long toSelection(long offset, long count, uint32_t * selection);
 };
 
 #endif //DUCKDB_PIXELSBITMASK_H
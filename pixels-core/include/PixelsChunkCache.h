@@ -0,0 +1,58 @@
+#ifndef PIXELS_PIXELSCHUNKCACHE_H
+#define PIXELS_PIXELSCHUNKCACHE_H
+
+#include "physical/natives/ByteBuffer.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * The process-wide cache of the column chunks read by the record readers, keyed by the file, the row
+ * group and the column. The bytes of the chunks are cached rather than the decoded vectors, because the
+ * column readers decode the chunks into the vectors of DuckDB batch by batch.
+ * A chunk is only admitted after it is looked up pixel.chunk.cache.admit.count times, so that a scan
+ * over cold data doesn't evict the hot chunks. The least recently used chunks are evicted once the
+ * bytes of the chunks exceed pixel.chunk.cache.size, and the cache is disabled if it is 0.
+ */
+class PixelsChunkCache {
+public:
+	static PixelsChunkCache * Instance();
+	static std::string chunkId(const std::string& fileId, int rgId, int colId);
+	bool isEnabled() const;
+	/**
+	 * Look up the chunk and count the access for the admission.
+	 * @return a view of the cached chunk that keeps the chunk alive, or nullptr if it is not cached
+	 */
+	std::shared_ptr<ByteBuffer> get(const std::string& id);
+	/**
+	 * Copy the chunk into the cache if it is accessed frequently enough.
+	 * The buffer must hold the complete chunk, i.e., the read of the chunk is done.
+	 */
+	void admit(const std::string& id, const std::shared_ptr<ByteBuffer>& chunk);
+	uint64_t getHitCount() const;
+	uint64_t getMissCount() const;
+	void clear();
+private:
+	PixelsChunkCache();
+	struct Entry {
+		std::string id;
+		std::shared_ptr<ByteBuffer> chunk;
+	};
+	typedef std::list<Entry> EntryList;
+	std::mutex m;
+	uint64_t capacity;
+	uint32_t admitCount;
+	uint64_t cachedBytes;
+	// the most recently used entries are at the front
+	EntryList entries;
+	std::unordered_map<std::string, EntryList::iterator> index;
+	// the accesses of the chunks that are not cached
+	std::unordered_map<std::string, uint32_t> accessCounts;
+	std::atomic<uint64_t> hitCount;
+	std::atomic<uint64_t> missCount;
+};
+
+#endif // PIXELS_PIXELSCHUNKCACHE_H
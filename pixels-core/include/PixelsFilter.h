@@ -12,9 +12,13 @@
 #include "duckdb/planner/filter/null_filter.hpp"
 #include "duckdb/planner/filter/conjunction_filter.hpp"
 #include "duckdb/common/operator/comparison_operators.hpp"
+#include "duckdb/common/types/value.hpp"
+#include "pixels-common/pixels.pb.h"
 #include "PixelsBitMask.h"
 #include "vector/ColumnVector.h"
+#include "vector/BinaryColumnVector.h"
 #include "TypeDescription.h"
+#include "utils/CpuFeatures.h"
 #include <immintrin.h>
 #include <avxintrin.h>
 
@@ -26,17 +30,109 @@ public:
                             PixelsBitMask& filterMask,
                             std::shared_ptr<TypeDescription> type);
 
+    /**
+     * Compare 8 values with AVX2. The AVX2 kernels are compiled with target attributes, so
+     * they must only be called if CpuFeatures::HasAvx2().
+     */
     template <class T, class OP>
+    __attribute__((target("avx2")))
     static int CompareAvx2(void * data, T constant);
 
+    template <class T>
+    __attribute__((target("avx2")))
+    static int RangeAvx2(void * data, T lower, T upper);
+
+    /**
+     * Set the bits of the values in [start, end) that satisfy the comparison and clear the others.
+     */
+    template <class T, class OP>
+    static void FilterValues(const T * values, long start, long end, T constant, PixelsBitMask &filter_mask);
+
+    /**
+     * Set the bits of the values in [start, end) that are in [lower, upper] and clear the others.
+     */
+    template <class T>
+    static void FilterRange(const T * values, long start, long end, T lower, T upper,
+                            PixelsBitMask &filter_mask);
+
+    enum class RunMatch {
+        NONE,
+        ALL,
+        SOME
+    };
+
+    /**
+     * Decide how many values of a run, which are monotonic, satisfy the comparison.
+     */
+    template <class T, class OP>
+    static RunMatch TemplatedRunMatch(T minimum, T maximum, T constant);
+
+    /**
+     * Evaluate the filter once per run if the vector is a run-encoded integer vector.
+     * The runs that do not match at all are cleared, the runs that match as a whole are
+     * left as they are, and the remaining values in [start, end) are passed to the kernel.
+     */
+    template <class MATCH, class KERNEL>
+    static void FilterRuns(std::shared_ptr<ColumnVector> vector, std::shared_ptr<TypeDescription> type,
+                           PixelsBitMask &filter_mask, MATCH match, KERNEL kernel);
+
+    template <class T>
+    static T * GetValues(std::shared_ptr<ColumnVector> vector, std::shared_ptr<TypeDescription> type);
+
     template <class T, class OP>
     static void TemplatedFilterOperation(std::shared_ptr<ColumnVector> vector,
                             const duckdb::Value &constant, PixelsBitMask &filter_mask,
                             std::shared_ptr<TypeDescription> type);
 
+    /**
+     * Filter a dictionary encoded string vector on its dictionary ids, evaluating the
+     * comparison once per dictionary entry.
+     */
+    template <class OP>
+    static void FilterDictionary(std::shared_ptr<BinaryColumnVector> vector, duckdb::string_t constant,
+                                 PixelsBitMask &filter_mask);
+
     template <class OP>
     static void FilterOperationSwitch(std::shared_ptr<ColumnVector> vector, duckdb::Value &constant,
                                       PixelsBitMask &filter_mask, std::shared_ptr<TypeDescription> type);
 
+    template <class T>
+    static void TemplatedRangeFilter(std::shared_ptr<ColumnVector> vector, duckdb::ConstantFilter &lowerFilter,
+                                     duckdb::ConstantFilter &upperFilter, PixelsBitMask &filter_mask,
+                                     std::shared_ptr<TypeDescription> type);
+
+    /**
+     * Apply a conjunction of a lower and an upper bound on a numeric column as one fused pass.
+     *
+     * @return false if the filter is not such a range predicate, and nothing has been applied
+     */
+    static bool ApplyRangeFilter(std::shared_ptr<ColumnVector> vector, duckdb::ConjunctionAndFilter &filter,
+                                 PixelsBitMask &filterMask, std::shared_ptr<TypeDescription> type);
+
+    /**
+     * Keep only the null (isNull = true) or the non-null (isNull = false) values in the filter mask.
+     */
+    static void ApplyNullFilter(std::shared_ptr<ColumnVector> vector, PixelsBitMask &filterMask, bool isNull);
+
+    /**
+     * Check whether the values described by the statistic may satisfy the filter.
+     * Statistics that are absent (e.g. not written by the writer) are treated as
+     * "may match", so this method never excludes data that could pass the filter.
+     *
+     * @param filter the pushed down filter of the column
+     * @param statistic the statistic of a row group or a pixel of the column
+     * @param type the type of the column
+     * @return false only if no value described by the statistic can satisfy the filter
+     */
+    static bool StatisticMayMatch(duckdb::TableFilter &filter, const pixels::proto::ColumnStatistic &statistic,
+                                  std::shared_ptr<TypeDescription> type);
+
+    template <class T>
+    static bool TemplatedStatisticMayMatch(duckdb::ExpressionType comparisonType,
+                                           const T &minimum, const T &maximum, const T &constant);
+
+    static bool ConstantStatisticMayMatch(duckdb::ConstantFilter &filter,
+                                          const pixels::proto::ColumnStatistic &statistic,
+                                          std::shared_ptr<TypeDescription> type);
 };
 #endif //DUCKDB_PIXELSFILTER_H
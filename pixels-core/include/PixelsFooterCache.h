@@ -9,23 +9,72 @@
 #include <string>
 #include "pixels-common/pixels.pb.h"
 #include <unordered_map>
+#include <list>
+#include <mutex>
+#include <atomic>
 
 using namespace pixels::proto;
-typedef std::unordered_map<std::string, std::shared_ptr<FileTail>> FileTailTable;
-typedef std::unordered_map<std::string, std::shared_ptr<RowGroupFooter>> RGFooterTable;
 
+/**
+ * The cache of the parsed file tails and row group footers. It is thread-safe, and evicts the
+ * least recently used entries once the serialized size of the entries exceeds the capacity.
+ * The process-wide cache returned by Instance() is shared by all the queries, and is bounded by
+ * pixel.footer.cache.size. The ids should be built by fileId() and rgFooterId(), so that the
+ * entries of a file are not used after the file is rewritten.
+ */
 class PixelsFooterCache {
 public:
+    /**
+     * The cache is unbounded.
+     */
     PixelsFooterCache();
+    /**
+     * @param capacity the max bytes of the cached entries, unbounded if it is 0
+     */
+    explicit PixelsFooterCache(uint64_t capacity);
+    static std::shared_ptr<PixelsFooterCache> Instance();
+    /**
+     * @return the id of the file, which consists of the path, the modification time and the size of the file
+     */
+    static std::string fileId(const std::string& path);
+    static std::string rgFooterId(const std::string& fileId, int rgId);
     void putFileTail(const std::string& id, std::shared_ptr<FileTail> fileTail);
     bool containsFileTail(const std::string& id);
 	std::shared_ptr<FileTail> getFileTail(const std::string& id);
+    /**
+     * @return the file tail, or nullptr if it is not cached. The hits and misses are counted
+     */
+    std::shared_ptr<FileTail> findFileTail(const std::string& id);
     void putRGFooter(const std::string& id, std::shared_ptr<RowGroupFooter> footer);
     bool containsRGFooter(const std::string& id);
 	std::shared_ptr<RowGroupFooter> getRGFooter(const std::string& id);
+    /**
+     * @return the row group footer, or nullptr if it is not cached. The hits and misses are counted
+     */
+    std::shared_ptr<RowGroupFooter> findRGFooter(const std::string& id);
+    uint64_t getHitCount() const;
+    uint64_t getMissCount() const;
+    uint64_t getCachedBytes();
+    void clear();
 private:
-    FileTailTable fileTailCacheMap;
-    RGFooterTable rowGroupFooterCacheMap;
-
+    struct Entry {
+        std::string id;
+        std::shared_ptr<FileTail> fileTail;
+        std::shared_ptr<RowGroupFooter> rgFooter;
+        uint64_t bytes;
+    };
+    typedef std::list<Entry> EntryList;
+    void put(Entry entry);
+    // move the entry to the front of the list, it must be called with the lock
+    EntryList::iterator touch(const std::string& id);
+    void evict();
+    std::mutex m;
+    uint64_t capacity;
+    uint64_t cachedBytes;
+    // the most recently used entries are at the front
+    EntryList entries;
+    std::unordered_map<std::string, EntryList::iterator> index;
+    std::atomic<uint64_t> hitCount;
+    std::atomic<uint64_t> missCount;
 };
 #endif //PIXELS_PIXELSFOOTERCACHE_H
@@ -41,6 +41,11 @@ public:
 
     virtual void close() = 0;
 
+    /**
+     * Get the bytes of the row groups that have been written into this file.
+     */
+    virtual long getCompletedBytes() = 0;
+
 //    /**
 //     * Get schema of this file.
 //     *
@@ -55,7 +60,5 @@ public:
 //    virtual int getNumGroup();
 //
 //    virtual int getNumWriteRequests();
-//
-//    virtual long getCompletedBytes();
 };
 #endif //PIXELS_PIXELSWRITER_H
@@ -33,6 +33,7 @@
 #include "stats/StatsRecorder.h"
 #include "pixels-common/pixels.pb.h"
 #include "vector/VectorizedRowBatch.h"
+#include <future>
 #include <unicode/timezone.h>
 #include <unicode/unistr.h>
 #include <unicode/locid.h>
@@ -40,13 +41,18 @@
 class PixelsWriterImpl : public PixelsWriter {
 public:
     PixelsWriterImpl(std::shared_ptr<TypeDescription> schema, int pixelsStride, int rowGroupSize,
-                     const std::string &targetFilePath, int blockSize, bool blockPadding,
+                     const std::string &targetFilePath, std::int64_t blockSize, bool blockPadding,
                      EncodingLevel encodingLevel, bool nullsPadding,bool partitioned, int compressionBlockSize);
     bool addRowBatch(std::shared_ptr<VectorizedRowBatch> rowBatch) override;
     void writeColumnVectors(std::vector<std::shared_ptr<ColumnVector>> &columnVectors, int rowBatchSize);
+    /**
+     * Flush the column writers of the current row group, and write the row group in the background
+     * while the next row group is encoded into the spare column writers.
+     */
     void writeRowGroup();
     void writeFileTail();
     void close() override;
+    long getCompletedBytes() override;
 
 private:
     /**
@@ -58,6 +64,11 @@ private:
      */
     static const std::vector<uint8_t> CHUNK_PADDING_BUFFER;
 
+    /**
+     * Write the flushed column chunks, the row group footer, and reset the column writers.
+     */
+    void writeRowGroupContent(std::vector<std::shared_ptr<ColumnWriter>>& writers, std::int64_t numOfRows);
+
     std::shared_ptr<TypeDescription> schema;
     int rowGroupSize;
     pixels::proto::CompressionKind compressionKind;
@@ -65,10 +76,14 @@ private:
     // std::unique_ptr<icu::TimeZone> timeZone;
     std::shared_ptr<PixelsWriterOption> columnWriterOption;
     std::vector<std::shared_ptr<ColumnWriter>> columnWriters;
+    // the column writers of the row group that is being written
+    std::vector<std::shared_ptr<ColumnWriter>> spareColumnWriters;
     std::vector<StatsRecorder> fileColStatRecorders;
-    std::int64_t fileContentLength;
-    int fileRowNum;
+    std::int64_t fileContentLength = 0;
+    int fileRowNum = 0;
     std::int64_t writtenBytes = 0;
+    // the bytes of the row groups that are flushed, including the one being written
+    std::int64_t completedBytes = 0;
     std::int64_t curRowGroupOffset = 0;
     std::int64_t curRowGroupFooterOffset = 0;
     std::int64_t curRowGroupNumOfRows = 0;
@@ -80,6 +95,7 @@ private:
     std::vector<pixels::proto::RowGroupStatistic> rowGroupStatisticList;
     std::shared_ptr<PhysicalWriter> physicalWriter;
     std::vector<std::shared_ptr<TypeDescription>> children;
-
+    // it is the last member, so that the write is waited for before the other members are destroyed
+    std::future<void> rowGroupWriting;
 };
 #endif //PIXELS_PIXELSWRITERIMPL_H
@@ -0,0 +1,21 @@
+#ifndef PIXELS_INTEGERRUN_H
+#define PIXELS_INTEGERRUN_H
+
+/**
+ * A stretch of values that are decoded from the same run of the run-length encoding.
+ * The values of a run are monotonic, hence the minimum and the maximum are its first
+ * and last values.
+ */
+struct IntegerRun {
+    // the index of the first value in the column vector
+    int start;
+    int length;
+    long first;
+    long minimum;
+    long maximum;
+    // whether the values are first + i * delta, e.g. a repeated value if delta is 0
+    bool sequence;
+    long delta;
+};
+
+#endif //PIXELS_INTEGERRUN_H
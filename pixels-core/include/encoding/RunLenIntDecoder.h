@@ -7,9 +7,11 @@
 
 #include "utils/Constants.h"
 #include "encoding/Decoder.h"
+#include "encoding/IntegerRun.h"
 #include "encoding/RunLenIntEncoder.h"
 #include "exception/InvalidArgumentException.h"
 #include "utils/EncodingUtils.h"
+#include <vector>
 
 typedef RunLenIntEncoder::EncodingType EncodingType;
 class RunLenIntDecoder: public Decoder {
@@ -17,11 +19,32 @@ public:
     RunLenIntDecoder(const std::shared_ptr<ByteBuffer>& bb, bool isSigned);
     void close() override;
     long next() override;
+    /**
+     * Skip the next numValues values without returning them.
+     */
+    void skip(long numValues);
+    /**
+     * Decode the next n values into out. The runs that fit into out as a whole are
+     * expanded in place, without going through the literal buffer.
+     *
+     * @return the number of values decoded, which is less than n only if the input is exhausted
+     */
+    int decode(long * out, int n);
+    /**
+     * Same as decode, but narrows the values to T. If runs is not null, the runs expanded in
+     * place are also appended to it, where start is the index of out[0] in the column vector.
+     */
+    template <class T>
+    int decodeInto(T * out, int n, std::vector<IntegerRun> * runs = nullptr, int start = 0);
 	bool hasNext() override;
     ~RunLenIntDecoder();
 private:
 
     void readValues();
+    long skipRun(long maxValues);
+    template <class T>
+    int decodeRun(T * out, int maxValues, std::vector<IntegerRun> * runs, int start);
+    void addRun(std::vector<IntegerRun> * runs, const IntegerRun & run);
 	void readShortRepeatValues(int firstByte);
     void readDirectValues(int firstByte);
 	void readDeltaValues(int firstByte);
@@ -38,6 +38,11 @@ public:
     void encode(int* values, int offset, int length, byte* results, int& resultLength);
     void encode(long* values, byte* results, int length, int& resultLength);
     void encode(int* values, byte* results, int length, int& resultLength);
+    /**
+     * Encode the values and append the result to output. The internal buffer of the encoder
+     * is reused by the calls, so that no buffer is allocated for each call.
+     */
+    void encode(long* values, int length, const std::shared_ptr<ByteBuffer>& output);
     // -----------------------------------------------------------
     void determineEncoding();
     // -----------------------------------------------------------
@@ -44,8 +44,30 @@ public:
                       pixels::proto::ColumnChunkIndex & chunkIndex,
                       std::shared_ptr<PixelsBitMask> filterMask);
 
+    /**
+     * Skip values in the input buffer without decoding them into a vector.
+     * It moves the reading cursors in the same way as read() does, so that
+     * the values after the skipped ones can still be read correctly.
+     *
+     * @param input    input buffer
+     * @param encoding encoding type
+     * @param offset   starting offset of the values to skip
+     * @param size     number of values to skip
+     * @param pixelStride the stride (number of rows) in a pixels.
+     * @param chunkIndex the metadata of the column chunk to read.
+     */
+    virtual void skip(std::shared_ptr<ByteBuffer> input,
+                      pixels::proto::ColumnEncoding & encoding,
+                      int offset, int size, int pixelStride,
+                      pixels::proto::ColumnChunkIndex & chunkIndex);
+
     void setValid(const std::shared_ptr<ByteBuffer>& input, int pixelStride, const std::shared_ptr<ColumnVector>& columnVector, int pixelId, bool hasNull);
 
+    /**
+     * Move isNullOffset over the isNull bitmap of a pixel without setting the validity of any vector.
+     */
+    void skipValid(int pixelStride, int size, bool hasNull);
+
 protected:
     int elementIndex;
 	std::shared_ptr<TypeDescription> type;
@@ -7,6 +7,7 @@
 
 #include "reader/ColumnReader.h"
 #include "encoding/RunLenIntDecoder.h"
+#include "vector/LongColumnVector.h"
 
 class IntegerColumnReader: public ColumnReader{
 public:
@@ -18,7 +19,16 @@ public:
               int vectorIndex, std::shared_ptr<ColumnVector> vector,
               pixels::proto::ColumnChunkIndex & chunkIndex,
               std::shared_ptr<PixelsBitMask> filterMask) override;
+    void skip(std::shared_ptr<ByteBuffer> input,
+              pixels::proto::ColumnEncoding & encoding,
+              int offset, int size, int pixelStride,
+              pixels::proto::ColumnChunkIndex & chunkIndex) override;
 private:
+    /**
+     * Move the first valueNum values to the positions of the values that are not null.
+     */
+    template <class T>
+    void spreadValues(T * values, const std::shared_ptr<LongColumnVector> & columnVector, int size, int valueNum);
     /**
      * True if the data type of the values is long (int64), otherwise the data type is int32.
      */
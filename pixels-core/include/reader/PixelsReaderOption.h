@@ -32,6 +32,8 @@ public:
     bool isTolerantSchemaEvolution();
     void setEnableEncodedColumnVector(bool enabled);
     bool isEnableEncodedColumnVector();
+    void setEnableLateMaterialization(bool enabled);
+    bool isEnableLateMaterialization();
 private:
     std::vector<std::string> includedCols;
     duckdb::TableFilterSet * filter;
@@ -40,6 +42,7 @@ private:
     bool tolerantSchemaEvolution;     // this may lead to column missing due to schema evolution
     bool enableEncodedColumnVector;   // whether read encoded column vectors directly when possible
     bool enableFilterPushDown;        // if filter pushDown is enabled
+    bool enableLateMaterialization;   // whether decode non-filter columns only for the rows passing the filter
     long queryId;
     int batchSize;
     int rgStart;
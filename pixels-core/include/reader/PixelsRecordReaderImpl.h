@@ -12,6 +12,7 @@
 #include "physical/SchedulerFactory.h"
 #include "pixels-common/pixels.pb.h"
 #include "PixelsFooterCache.h"
+#include "PixelsChunkCache.h"
 #include "reader/PixelsReaderOption.h"
 #include "utils/String.h"
 #include "TypeDescription.h"
@@ -20,6 +21,7 @@
 #include "profiler/TimeProfiler.h"
 #include "physical/BufferPool.h"
 #include "physical/natives/DirectUringRandomAccessFile.h"
+#include "physical/natives/DirectAioRandomAccessFile.h"
 #include "PixelsFilter.h"
 
 class ChunkId {
@@ -39,13 +41,20 @@ public:
 
 class PixelsRecordReaderImpl: public PixelsRecordReader {
 public:
+    /**
+     * @param pixelsFileTail the file tail may be shared with other readers by the footer cache,
+     * so it is not copied
+     */
     explicit PixelsRecordReaderImpl(std::shared_ptr<PhysicalReader> reader,
-                                    const pixels::proto::PostScript& pixelsPostScript,
-                                    const pixels::proto::Footer& pixelsFooter,
+                                    std::shared_ptr<pixels::proto::FileTail> pixelsFileTail,
                                     const PixelsReaderOption& opt,
                                     std::shared_ptr<PixelsFooterCache> pixelsFooterCache
                                     );
     void asyncReadComplete(int requestSize);
+    /**
+     * Wait for the reads of the current row group, but not for the prefetched next row group.
+     */
+    void asyncReadCompleteCurrent();
     std::shared_ptr<VectorizedRowBatch> readBatch(bool reuse) override;
 	std::shared_ptr<TypeDescription> getResultSchema() override;
     bool read();
@@ -56,13 +65,60 @@ public:
 	uint32_t has_async_task_num_{0};
 private:
     std::vector<int64_t> bufferIds;
+    // the slot of BufferPool holding the column chunks of the current row group, -1 if no slot is taken
+    int bufferSlot;
+    // the next row group is read into another slot while the current one is decoded
+    int prefetchedBufferSlot;
+    int prefetchedRGIdx;
+    uint32_t prefetchedTaskNum;
+    std::vector<std::shared_ptr<ByteBuffer>> prefetchedChunkBuffers;
+    // the chunks to put into PixelsChunkCache once the reads of the row group are done
+    std::vector<std::pair<std::string, std::shared_ptr<ByteBuffer>>> chunkAdmissions;
+    std::vector<std::pair<std::string, std::shared_ptr<ByteBuffer>>> prefetchedChunkAdmissions;
+    // the id of the file in the footer cache and the chunk cache
+    std::string cacheFileId;
+    // the last row group hinted to the page cache, if the physical reader is zero-copy
+    int advisedRGIdx;
     void prepareRead();
+    /**
+     * Submit the reads of the column chunks of the row group into a new slot of BufferPool, the
+     * previous slot is released. The chunks cached by PixelsChunkCache are not read.
+     * @param admissions set to the chunks to put into PixelsChunkCache once they are read
+     * @return the number of asynchronous reads submitted
+     */
+    uint32_t readRowGroup(int rgIdx, int &slot, std::vector<std::shared_ptr<ByteBuffer>> &buffers,
+                          std::vector<std::pair<std::string, std::shared_ptr<ByteBuffer>>> &admissions);
+    void admitChunks(std::vector<std::pair<std::string, std::shared_ptr<ByteBuffer>>> &admissions);
+    /**
+     * Start reading the row group after the current one, if a slot of BufferPool is free.
+     * The zero-copy readers only get a hint of the row group instead.
+     */
+    void prefetchNextRowGroup();
+    /**
+     * Hint the physical reader to load the column chunks of the row group in the background.
+     */
+    void adviseRowGroup(int rgIdx);
     void checkBeforeRead();
 	std::shared_ptr<VectorizedRowBatch> createEmptyEOFRowBatch(int size);
 	void UpdateRowGroupInfo();
+    /**
+     * Check the pixel statistics of the filter columns to see whether
+     * any row in the next batch may pass the filter.
+     */
+    bool batchMayMatch(int curBatchSize);
+    /**
+     * Skip the next batch in all the result columns without decoding it.
+     */
+    void skipBatch(int curBatchSize);
+    /**
+     * Move the cursor forward by curBatchSize rows, and switch to the
+     * next row group if the current one is exhausted.
+     */
+    void moveToNextBatch(int curBatchSize);
     std::shared_ptr<PhysicalReader> physicalReader;
-    pixels::proto::Footer footer;
-    pixels::proto::PostScript postScript;
+    std::shared_ptr<pixels::proto::FileTail> fileTail;
+    const pixels::proto::Footer& footer;
+    const pixels::proto::PostScript& postScript;
 	std::shared_ptr<PixelsFooterCache> footerCache;
     PixelsReaderOption option;
     duckdb::TableFilterSet * filter;
@@ -80,6 +136,7 @@ private:
 	bool endOfFile;
 	int curRGRowCount;
     bool enabledFilterPushDown;
+    bool enableLateMaterialization;
     std::shared_ptr<PixelsBitMask> filterMask;
 	std::shared_ptr<pixels::proto::RowGroupFooter> curRGFooter;
 	std::vector<std::shared_ptr<pixels::proto::ColumnEncoding>> curEncoding;
@@ -7,6 +7,8 @@
 
 #include "reader/ColumnReader.h"
 #include "encoding/RunLenIntDecoder.h"
+#include "vector/BinaryColumnVector.h"
+#include <vector>
 
 class StringColumnReader: public ColumnReader {
 public:
@@ -19,6 +21,10 @@ public:
               int vectorIndex, std::shared_ptr<ColumnVector> vector,
               pixels::proto::ColumnChunkIndex & chunkIndex,
 			  std::shared_ptr<PixelsBitMask> filterMask) override;
+    void skip(std::shared_ptr<ByteBuffer> input,
+              pixels::proto::ColumnEncoding & encoding,
+              int offset, int size, int pixelStride,
+              pixels::proto::ColumnChunkIndex & chunkIndex) override;
 
 private:
     /**
@@ -45,6 +51,9 @@ private:
 
 	int * dictStarts;
     int startsLength;
+    // the values of the dictionary followed by a null entry, see BinaryColumnVector::dictIds
+    std::vector<duckdb::string_t> dictionary;
+    int dictionarySize;
     /**
      * In this method, we have reduced most of significant memory copies.
      */
@@ -32,9 +32,18 @@ class StatsRecorder {
 protected:
     long numberOfValues;
     bool hasNull;
+    // the type of the values, which decides the statistic that the range is serialized into
+    TypeDescription::Category category = TypeDescription::LONG;
+    // the range of the integer values, it is only valid if hasRange is set
+    bool hasRange = false;
+    long minimum = 0;
+    long maximum = 0;
+    long sum = 0;
+    bool sumOverflow = false;
 
 public:
     StatsRecorder();
+    explicit StatsRecorder(TypeDescription::Category category);
     explicit StatsRecorder(const pixels::proto::ColumnStatistic& statistic);
     virtual ~StatsRecorder();
 
@@ -53,6 +62,11 @@ public:
     virtual void updateTime(int value);
     virtual void updateTimestamp(long value);
     virtual void updateVector();
+    /**
+     * Record the min, max and sum of the integer values in batch. The values whose isNull is set
+     * are ignored, and all the values are recorded if isNull is nullptr.
+     */
+    void updateIntegers(const long *values, const uint8_t *isNull, int length);
 
     bool isStatsExists() const;
     void merge(const StatsRecorder& stats);
@@ -27,6 +27,14 @@ public:
     long readLongBE8(int rbOffset);
     void unrolledUnPackBytes(long *buffer, int offset, int len,
                              const std::shared_ptr<ByteBuffer> &input, int numBytes);
+    /**
+     * Unpack big endian values of 1, 2, 4 or 8 bytes from data with AVX2. It must only be
+     * called if CpuFeatures::HasAvx2().
+     *
+     * @return the number of values unpacked, which is len rounded down to a multiple of 4
+     */
+    __attribute__((target("avx2")))
+    int unPackBytesAvx2(long *buffer, const uint8_t *data, int len, int numBytes);
 	void unrolledUnPack1(long *buffer, int offset, int len,
 	                     const std::shared_ptr<ByteBuffer> &input);
 	void unrolledUnPack2(long *buffer, int offset, int len,
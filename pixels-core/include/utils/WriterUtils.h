@@ -0,0 +1,35 @@
+#ifndef PIXELS_WRITERUTILS_H
+#define PIXELS_WRITERUTILS_H
+
+#include <cstdint>
+#include "physical/natives/ByteOrder.h"
+
+/**
+ * The batch kernels of the column writers. The values of a pixel are gathered from the column
+ * vectors without branching on the nulls, and are encoded into the pixel buffer as a whole.
+ */
+class WriterUtils
+{
+private:
+    WriterUtils() {};
+
+public:
+    /**
+     * Gather the values into pixel. The nulls are padded with 0 if nullsPadding is set,
+     * otherwise they are skipped. pixel must have room for length values in both cases.
+     *
+     * @return the number of the values that are not null
+     */
+    static int gather(long *pixel, const long *values, const uint8_t *isNull, int length, bool nullsPadding);
+    static int gather(long *pixel, const int *values, const uint8_t *isNull, int length, bool nullsPadding);
+    /**
+     * Encode the values as 8-byte integers in the byte order into output.
+     */
+    static void encodeLongs(uint8_t *output, const long *values, int length, ByteOrder byteOrder);
+    /**
+     * Encode the values as 4-byte integers in the byte order into output, the values are truncated.
+     */
+    static void encodeInts(uint8_t *output, const long *values, int length, ByteOrder byteOrder);
+};
+
+#endif // PIXELS_WRITERUTILS_H
@@ -31,6 +31,15 @@
 class BinaryColumnVector: public ColumnVector {
 public:
     duckdb::string_t * vector;
+    /**
+     * If this is an encoded column vector and the column chunk is dictionary encoded, the values
+     * are not resolved into vector. dictIds holds the dictionary id of each value instead, and the
+     * ids of the null values refer to the extra null entry at dictionarySize. dictionary is null
+     * if the values are resolved.
+     */
+    uint32_t * dictIds;
+    duckdb::string_t * dictionary;
+    int dictionarySize;
 
     /**
     * Use this constructor by default. All column vectors
@@ -48,12 +57,21 @@ public:
      * @param length     length of source byte sequence
      */
     void setRef(int elementNum, uint8_t * const & sourceBuf, int start, int length);
+    /**
+     * Keep the values of this vector as ids of the dictionary, which has dictionarySize + 1
+     * entries and must outlive the use of this vector.
+     */
+    void setDictionary(duckdb::string_t * dictionary, int dictionarySize);
     void * current() override;
     void close() override;
     void print(int rowCount) override;
 
     void add(std::string value);
     void add(uint8_t* v,int length);
+    /**
+     * The value refers to the text instead of copying it, so the text must outlive the use of this vector.
+     */
+    void add(const char *value, size_t size) override;
     void setVal(int elemnetNum,uint8_t* sourceBuf);
     void setVal(int elementNum, uint8_t* sourceBuf, int start, int length);
 };
@@ -77,6 +77,11 @@ public:
     virtual void add(bool value);
     virtual void add(int64_t value);
     virtual void add(int value);
+    /**
+     * Parse the text and add the value, the text is not required to be null-terminated.
+     * It is parsed by add(std::string &) unless the sub-type parses it in place.
+     */
+    virtual void add(const char *value, size_t size);
     int getLength() {
      return length;
     }
@@ -31,6 +31,7 @@ public:
     void add(bool value) override;
     void add(int64_t value) override;
     void add(int value) override;
+    void add(const char *value, size_t size) override;
     void ensureSize(uint64_t size, bool preserveData) override;
 };
 
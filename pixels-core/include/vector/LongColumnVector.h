@@ -7,11 +7,20 @@
 
 #include "vector/ColumnVector.h"
 #include "vector/VectorizedRowBatch.h"
+#include "encoding/IntegerRun.h"
+#include <vector>
 
 class LongColumnVector: public ColumnVector {
 public:
     long * longVector;
+	// the int values are packed as int32, use it as an int array
 	long * intVector;
+    /**
+     * If this is an encoded column vector, the runs of the run-length encoding that are
+     * decoded as a whole, sorted by start. The values are still materialized, the runs
+     * allow the consumers to process each run at once.
+     */
+    std::vector<IntegerRun> runs;
     /**
     * Use this constructor by default. All column vectors
     * should normally be the default size.
@@ -25,6 +34,7 @@ public:
     void add(bool value) override;
     void add(int64_t value) override;
     void add(int value) override;
+    void add(const char *value, size_t size) override;
     void ensureSize(uint64_t size, bool preserveData) override;
     bool isLongVector();
 private:
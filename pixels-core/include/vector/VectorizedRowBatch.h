@@ -18,8 +18,17 @@
 #include <iostream>
 #include <vector>
 #include "vector/ColumnVector.h"
+#include "physical/natives/ByteBuffer.h"
 #include <memory>
 
+/**
+ * A field of a line in the text files.
+ */
+struct TextField {
+    const char *data;
+    size_t length;
+};
+
 class VectorizedRowBatch {
 public:
     int numCols;                                       // number of columns
@@ -42,8 +51,16 @@ public:
     bool isFull();
     int freeSlots();
     bool isEndOfFile();
+    /**
+     * Parse the text fields of a row into the columns in place. The fields beyond the columns
+     * are ignored, and the missing, empty or \N fields are nulls. The string values refer to
+     * the text, so the buffer of the text must be held by holdBuffer() until the batch is reset.
+     */
+    void addTextRow(const TextField *fields, int fieldNum);
+    void holdBuffer(const std::shared_ptr<ByteBuffer> &buffer);
 private:
 	bool closed;
+    std::vector<std::shared_ptr<ByteBuffer>> heldBuffers;
     int current;                                        // The current pointer of VectorizedRowBatch.
 };
 #endif //PIXELS_VECTORIZEDROWBATCH_H
@@ -54,6 +54,14 @@ public:
     virtual pixels::proto::ColumnChunkIndex getColumnChunkIndex();
     virtual std::shared_ptr<pixels::proto::ColumnChunkIndex> getColumnChunkIndexPtr();
     virtual pixels::proto::ColumnEncoding getColumnChunkEncoding();
+    /**
+     * The statistic of the values in the current column chunk, it is valid until reset().
+     */
+    virtual pixels::proto::ColumnStatistic getColumnChunkStat();
+    const StatsRecorder& getColumnChunkStatRecorder() const;
+    /**
+     * Reset the writer for the next row group, the subclasses also reset their encoders.
+     */
     virtual void reset();
     virtual void flush() ;
     virtual void close() ;
@@ -81,9 +89,12 @@ protected:
     StatsRecorder pixelStatRecorder;
     StatsRecorder columnChunkStatRecorder;
 bool hasNull = false;
-    const bool nullsPadding;
+    // decided by the subclasses, as decideNullsPadding can not be called in this constructor
+    bool nullsPadding;
     int curPixelVectorIndex = 0;
     const ByteOrder byteOrder;
     std::vector<bool> isNull{};
+    // the buffer that the pixels are encoded into, it is reused by the pixels
+    std::vector<uint8_t> encodingBuffer;
 };
 #endif //PIXELS_COLUMNWRITER_H
\ No newline at end of file
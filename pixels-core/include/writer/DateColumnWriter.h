@@ -34,6 +34,7 @@ public:
 
     int write(std::shared_ptr<ColumnVector> vector, int length) override;
     void close() override;
+    void reset() override;
     void newPixel() override;
     void writeCurPartTime(std::shared_ptr<ColumnVector> columnVector, int* values, int curPartLength, int curPartOffset);
     bool decideNullsPadding(std::shared_ptr<PixelsWriterOption> writerOption) override;
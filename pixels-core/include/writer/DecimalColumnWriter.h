@@ -32,7 +32,11 @@ class DecimalColumnWriter :public  ColumnWriter{
 public:
     DecimalColumnWriter(std::shared_ptr<TypeDescription> type,std::shared_ptr<PixelsWriterOption> writerOption);
     int write(std::shared_ptr<ColumnVector> vector, int length) override;
+    void newPixel() override;
+    void writeCurPartDecimal(std::shared_ptr<ColumnVector> columnVector, long* values, int curPartLength, int curPartOffset);
     bool decideNullsPadding(std::shared_ptr<PixelsWriterOption> writerOption) override;
+private:
+    std::vector<long> curPixelVector; // current pixel value vector haven't written out yet
 };
 
 #endif //DUCKDB_DECIMALCOLUMNWRITER_H
@@ -34,11 +34,15 @@ public:
 
     int write(std::shared_ptr<ColumnVector> vector, int length) override;
     void close() override;
+    void reset() override;
     void newPixel() override;
-    void writeCurPartLong(std::shared_ptr<ColumnVector> columnVector, long* values, int curPartLength, int curPartOffset);
+    template <class T>
+    void writeCurPartLong(std::shared_ptr<ColumnVector> columnVector, const T* values, int curPartLength, int curPartOffset);
     bool decideNullsPadding(std::shared_ptr<PixelsWriterOption> writerOption) override;
     pixels::proto::ColumnEncoding getColumnChunkEncoding();
 private:
+    template <class T>
+    int writeValues(std::shared_ptr<LongColumnVector> columnVector, const T* values, int size);
     bool isLong; //current column type is long or int, used for the first pixel
     bool runlengthEncoding;
     std::unique_ptr<RunLenIntEncoder> encoder;
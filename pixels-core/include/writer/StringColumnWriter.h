@@ -36,6 +36,7 @@ class StringColumnWriter : public ColumnWriter {
   // vector should be converted to BinaryColumnVector
   int write(std::shared_ptr<ColumnVector> vector,int length) override;
   void close() override;
+  void reset() override;
   void newPixels() ;
 
   bool decideNullsPadding(std::shared_ptr<PixelsWriterOption> writerOption) override;
@@ -3,7 +3,48 @@
 //
 
 #include "PixelsBitMask.h"
+#include "utils/CpuFeatures.h"
 #include <math.h>
+#include <immintrin.h>
+
+/**
+ * The positions of the set bits in each possible byte, used to turn
+ * 8 bits of the mask into selection indices at once.
+ */
+struct BitPositionTable {
+    uint8_t positions[256][8];
+    uint8_t counts[256];
+    BitPositionTable() {
+        for(int value = 0; value < 256; value++) {
+            int count = 0;
+            memset(positions[value], 0, 8);
+            for(int bit = 0; bit < 8; bit++) {
+                if(value & (1 << bit)) {
+                    positions[value][count++] = bit;
+                }
+            }
+            counts[value] = count;
+        }
+    }
+};
+
+static const BitPositionTable bitPositionTable;
+
+/**
+ * Turn the whole bytes of the mask from bit i into selection indices, storing 8 indices per
+ * byte with one AVX2 store. It is only called if CpuFeatures::HasAvx2().
+ */
+__attribute__((target("avx2")))
+static void ToSelectionAvx2(const uint8_t * mask, long offset, long count, long &i, long &size,
+                            uint32_t * selection) {
+    for(; i + 8 <= count; i += 8) {
+        uint8_t value = mask[(offset + i) / 8];
+        __m128i positions = _mm_loadl_epi64((const __m128i *)bitPositionTable.positions[value]);
+        __m256i indices = _mm256_add_epi32(_mm256_cvtepu8_epi32(positions), _mm256_set1_epi32((int)i));
+        _mm256_storeu_si256((__m256i *)(selection + size), indices);
+        size += bitPositionTable.counts[value];
+    }
+}
 
 PixelsBitMask::PixelsBitMask(long length) {
     this->maskLength = length;
@@ -74,6 +115,48 @@ uint8_t PixelsBitMask::get(long index) {
     return bool(byteMask & shiftMask);
 }
 
+void PixelsBitMask::clear(long from, long to) {
+    long i = from;
+    for(; i < to && i % 8 != 0; i++) {
+        set(i, 0);
+    }
+    if(i + 8 <= to) {
+        memset(mask + i / 8, 0, (to - i) / 8);
+        i += (to - i) / 8 * 8;
+    }
+    for(; i < to; i++) {
+        set(i, 0);
+    }
+}
+
+long PixelsBitMask::nextSetBit(long from, long to) {
+    long i = from;
+    while(i < to) {
+        uint8_t value = mask[i / 8] >> (i % 8);
+        if(value != 0) {
+            i += __builtin_ctz(value);
+            return std::min(i, to);
+        }
+        // no set bit in the rest of this byte
+        i = (i / 8 + 1) * 8;
+    }
+    return to;
+}
+
+long PixelsBitMask::nextClearBit(long from, long to) {
+    long i = from;
+    while(i < to) {
+        uint8_t value = (uint8_t) ~mask[i / 8] >> (i % 8);
+        if(value != 0) {
+            i += __builtin_ctz(value);
+            return std::min(i, to);
+        }
+        // no clear bit in the rest of this byte
+        i = (i / 8 + 1) * 8;
+    }
+    return to;
+}
+
 void PixelsBitMask::Or(long index, uint8_t value) {
     if(value == 1) {
         assert(index < maskLength);
@@ -97,3 +180,31 @@ void PixelsBitMask::setByteAligned(long index, uint8_t value) {
 }
 
 
+
+long PixelsBitMask::toSelection(long offset, long count, uint32_t * selection) {
+    long size = 0;
+    long i = 0;
+    // the bits before the first byte boundary
+    for(; i < count && (offset + i) % 8 != 0; i++) {
+        if(get(offset + i)) {
+            selection[size++] = i;
+        }
+    }
+    // size <= i always holds, so storing 8 indices never exceeds count entries
+    if(CpuFeatures::HasAvx2()) {
+        ToSelectionAvx2(mask, offset, count, i, size, selection);
+    }
+    for(; i + 8 <= count; i += 8) {
+        uint8_t value = mask[(offset + i) / 8];
+        for(int j = 0; j < 8; j++) {
+            selection[size + j] = bitPositionTable.positions[value][j] + (uint32_t)i;
+        }
+        size += bitPositionTable.counts[value];
+    }
+    for(; i < count; i++) {
+        if(get(offset + i)) {
+            selection[size++] = i;
+        }
+    }
+    return size;
+}
@@ -0,0 +1,103 @@
+#include "PixelsChunkCache.h"
+#include "utils/ConfigFactory.h"
+
+// the access counts are forgotten once this many uncached chunks are tracked, so that
+// the counts don't grow without bound and the chunks that were hot long ago age out
+#define CHUNK_CACHE_MAX_TRACKED_CHUNKS (1 << 20)
+
+namespace {
+// a view of a cached chunk. Each reader gets its own view, since the read position
+// of a ByteBuffer is not shared safely by the threads
+class CachedChunkView: public ByteBuffer {
+public:
+	explicit CachedChunkView(const std::shared_ptr<ByteBuffer>& chunk)
+	    : ByteBuffer(*chunk, 0, chunk->size()), chunk(chunk) {
+	}
+private:
+	std::shared_ptr<ByteBuffer> chunk;
+};
+}
+
+PixelsChunkCache * PixelsChunkCache::Instance() {
+	static PixelsChunkCache * instance = new PixelsChunkCache();
+	return instance;
+}
+
+PixelsChunkCache::PixelsChunkCache() {
+	capacity = std::stoull(ConfigFactory::Instance().getProperty("pixel.chunk.cache.size"));
+	admitCount = std::stoul(ConfigFactory::Instance().getProperty("pixel.chunk.cache.admit.count"));
+	cachedBytes = 0;
+	hitCount = 0;
+	missCount = 0;
+}
+
+std::string PixelsChunkCache::chunkId(const std::string& fileId, int rgId, int colId) {
+	return fileId + "-" + std::to_string(rgId) + "-" + std::to_string(colId);
+}
+
+bool PixelsChunkCache::isEnabled() const {
+	return capacity > 0;
+}
+
+std::shared_ptr<ByteBuffer> PixelsChunkCache::get(const std::string& id) {
+	std::lock_guard<std::mutex> lock(m);
+	auto it = index.find(id);
+	if(it == index.end()) {
+		missCount++;
+		if(accessCounts.size() >= CHUNK_CACHE_MAX_TRACKED_CHUNKS) {
+			accessCounts.clear();
+		}
+		accessCounts[id]++;
+		return nullptr;
+	}
+	hitCount++;
+	entries.splice(entries.begin(), entries, it->second);
+	return std::make_shared<CachedChunkView>(it->second->chunk);
+}
+
+void PixelsChunkCache::admit(const std::string& id, const std::shared_ptr<ByteBuffer>& chunk) {
+	uint32_t size = chunk->size();
+	if(size == 0 || size > capacity) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m);
+		auto it = accessCounts.find(id);
+		if(index.count(id) || it == accessCounts.end() || it->second < admitCount) {
+			return;
+		}
+		accessCounts.erase(it);
+	}
+	// copy the chunk out of the lock, the buffer of the reader is reused by the next row groups
+	auto copy = std::make_shared<ByteBuffer>(size);
+	memcpy(copy->getPointer(), chunk->getPointer(), size);
+	std::lock_guard<std::mutex> lock(m);
+	if(index.count(id)) {
+		return;
+	}
+	entries.push_front(Entry{id, copy});
+	index[id] = entries.begin();
+	cachedBytes += size;
+	while(cachedBytes > capacity) {
+		auto& victim = entries.back();
+		cachedBytes -= victim.chunk->size();
+		index.erase(victim.id);
+		entries.pop_back();
+	}
+}
+
+uint64_t PixelsChunkCache::getHitCount() const {
+	return hitCount;
+}
+
+uint64_t PixelsChunkCache::getMissCount() const {
+	return missCount;
+}
+
+void PixelsChunkCache::clear() {
+	std::lock_guard<std::mutex> lock(m);
+	entries.clear();
+	index.clear();
+	accessCounts.clear();
+	cachedBytes = 0;
+}
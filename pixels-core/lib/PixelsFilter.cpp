@@ -3,19 +3,25 @@
 //
 
 #include "PixelsFilter.h"
+#include <cmath>
+#include <limits>
 
 template<class T, class OP>
+__attribute__((target("avx2")))
 int PixelsFilter::CompareAvx2(void * data, T constant) {
     __m256i vector;
     __m256i vector_next;
     __m256i constants;
     __m256i mask;
     if constexpr(sizeof(T) == 4) {
-        vector = _mm256_load_si256((__m256i *)data);
+        vector = _mm256_loadu_si256((__m256i *)data);
         constants = _mm256_set1_epi32(constant);
         if constexpr(std::is_same<OP, duckdb::Equals>()) {
             mask = _mm256_cmpeq_epi32(vector, constants);
             return _mm256_movemask_ps((__m256)mask);
+        } else if constexpr(std::is_same<OP, duckdb::NotEquals>()) {
+            mask = _mm256_cmpeq_epi32(vector, constants);
+            return ~_mm256_movemask_ps((__m256)mask);
         } else if constexpr(std::is_same<OP, duckdb::LessThan>()) {
             mask = _mm256_cmpgt_epi32(constants, vector);
             return _mm256_movemask_ps((__m256)mask);
@@ -31,8 +37,8 @@ int PixelsFilter::CompareAvx2(void * data, T constant) {
         }
     } else if constexpr(sizeof(T) == 8) {
         constants = _mm256_set1_epi64x(constant);
-        vector = _mm256_load_si256((__m256i *)data);
-        vector_next = _mm256_load_si256((__m256i *)((uint8_t *)data + 32));
+        vector = _mm256_loadu_si256((__m256i *)data);
+        vector_next = _mm256_loadu_si256((__m256i *)((uint8_t *)data + 32));
         int result = 0;
         if constexpr(std::is_same<OP, duckdb::Equals>()) {
             mask = _mm256_cmpeq_epi64(vector, constants);
@@ -40,6 +46,12 @@ int PixelsFilter::CompareAvx2(void * data, T constant) {
             mask = _mm256_cmpeq_epi64(vector_next, constants);
             result += _mm256_movemask_pd((__m256d)mask) << 4;
             return result;
+        } else if constexpr(std::is_same<OP, duckdb::NotEquals>()) {
+            mask = _mm256_cmpeq_epi64(vector, constants);
+            result = _mm256_movemask_pd((__m256d)mask);
+            mask = _mm256_cmpeq_epi64(vector_next, constants);
+            result += _mm256_movemask_pd((__m256d)mask) << 4;
+            return ~result;
         } else if constexpr(std::is_same<OP, duckdb::LessThan>()) {
             mask = _mm256_cmpgt_epi64(constants, vector);
             result = _mm256_movemask_pd((__m256d)mask);
@@ -71,70 +83,336 @@ int PixelsFilter::CompareAvx2(void * data, T constant) {
 }
 
 
+/**
+ * The AVX2 and AVX-512 kernels are compiled with target attributes instead of a global compiler
+ * flag, so that they are only executed if CpuFeatures detects the instructions on the running CPU.
+ */
+template <class OP>
+struct Avx512Predicate;
+
+template <>
+struct Avx512Predicate<duckdb::Equals> { static constexpr int value = _MM_CMPINT_EQ; };
+template <>
+struct Avx512Predicate<duckdb::NotEquals> { static constexpr int value = _MM_CMPINT_NE; };
+template <>
+struct Avx512Predicate<duckdb::LessThan> { static constexpr int value = _MM_CMPINT_LT; };
+template <>
+struct Avx512Predicate<duckdb::LessThanEquals> { static constexpr int value = _MM_CMPINT_LE; };
+template <>
+struct Avx512Predicate<duckdb::GreaterThan> { static constexpr int value = _MM_CMPINT_NLE; };
+template <>
+struct Avx512Predicate<duckdb::GreaterThanEquals> { static constexpr int value = _MM_CMPINT_NLT; };
+
+/**
+ * Compare the values from start, which is a multiple of 8, in chunks of 64 bytes and write
+ * the comparison mask registers straight into the filter mask.
+ *
+ * @return the index of the first value that has not been compared
+ */
 template <class T, class OP>
-void PixelsFilter::TemplatedFilterOperation(std::shared_ptr<ColumnVector> vector,
-                              const duckdb::Value &constant, PixelsBitMask &filter_mask,
-                                            std::shared_ptr<TypeDescription> type) {
-    T constant_value = constant.template GetValueUnsafe<T>();
-    switch (type->getCategory()) {
-        case TypeDescription::SHORT:
-        case TypeDescription::INT: {
-            auto longColumnVector = std::static_pointer_cast<LongColumnVector>(vector);
-            int i = 0;
-#ifdef  ENABLE_SIMD_FILTER
-            for (; i < vector->length - vector->length % 8; i += 8) {
-                uint8_t mask = CompareAvx2<T, OP>(longColumnVector->intVector + i, constant_value);
-                filter_mask.setByteAligned(i, mask);
-            }
-#endif
-            for (; i < vector->length; i++) {
-                filter_mask.set(i, OP::Operation((T)longColumnVector->intVector[i],
-                                                                 constant_value));
-            }
-            break;
+__attribute__((target("avx512f,avx512bw")))
+static long FilterValuesAvx512(const T * values, long start, long end, T constant, PixelsBitMask &filter_mask) {
+    constexpr long lanes = 64 / sizeof(T);
+    constexpr int predicate = Avx512Predicate<OP>::value;
+    long i = start;
+    if constexpr(sizeof(T) == 2) {
+        __m512i constants = _mm512_set1_epi16(constant);
+        for (; i + lanes <= end; i += lanes) {
+            __mmask32 mask = _mm512_cmp_epi16_mask(_mm512_loadu_si512(values + i), constants, predicate);
+            memcpy(filter_mask.mask + i / 8, &mask, sizeof(mask));
         }
-        case TypeDescription::LONG: {
-            auto longColumnVector = std::static_pointer_cast<LongColumnVector>(vector);
-            int i = 0;
+    } else if constexpr(sizeof(T) == 4) {
+        __m512i constants = _mm512_set1_epi32(constant);
+        for (; i + lanes <= end; i += lanes) {
+            __mmask16 mask = _mm512_cmp_epi32_mask(_mm512_loadu_si512(values + i), constants, predicate);
+            memcpy(filter_mask.mask + i / 8, &mask, sizeof(mask));
+        }
+    } else if constexpr(sizeof(T) == 8) {
+        __m512i constants = _mm512_set1_epi64(constant);
+        for (; i + lanes <= end; i += lanes) {
+            __mmask8 mask = _mm512_cmp_epi64_mask(_mm512_loadu_si512(values + i), constants, predicate);
+            filter_mask.setByteAligned(i, mask);
+        }
+    }
+    return i;
+}
+
+/**
+ * Check lower <= value <= upper from start, which is a multiple of 8, in chunks of 64 bytes.
+ *
+ * @return the index of the first value that has not been compared
+ */
+template <class T>
+__attribute__((target("avx512f,avx512bw")))
+static long FilterRangeAvx512(const T * values, long start, long end, T lower, T upper,
+                              PixelsBitMask &filter_mask) {
+    constexpr long lanes = 64 / sizeof(T);
+    long i = start;
+    if constexpr(sizeof(T) == 2) {
+        __m512i lowers = _mm512_set1_epi16(lower);
+        __m512i uppers = _mm512_set1_epi16(upper);
+        for (; i + lanes <= end; i += lanes) {
+            __m512i vector = _mm512_loadu_si512(values + i);
+            __mmask32 mask = _mm512_cmp_epi16_mask(vector, lowers, _MM_CMPINT_NLT);
+            mask = _mm512_mask_cmp_epi16_mask(mask, vector, uppers, _MM_CMPINT_LE);
+            memcpy(filter_mask.mask + i / 8, &mask, sizeof(mask));
+        }
+    } else if constexpr(sizeof(T) == 4) {
+        __m512i lowers = _mm512_set1_epi32(lower);
+        __m512i uppers = _mm512_set1_epi32(upper);
+        for (; i + lanes <= end; i += lanes) {
+            __m512i vector = _mm512_loadu_si512(values + i);
+            __mmask16 mask = _mm512_cmp_epi32_mask(vector, lowers, _MM_CMPINT_NLT);
+            mask = _mm512_mask_cmp_epi32_mask(mask, vector, uppers, _MM_CMPINT_LE);
+            memcpy(filter_mask.mask + i / 8, &mask, sizeof(mask));
+        }
+    } else if constexpr(sizeof(T) == 8) {
+        __m512i lowers = _mm512_set1_epi64(lower);
+        __m512i uppers = _mm512_set1_epi64(upper);
+        for (; i + lanes <= end; i += lanes) {
+            __m512i vector = _mm512_loadu_si512(values + i);
+            __mmask8 mask = _mm512_cmp_epi64_mask(vector, lowers, _MM_CMPINT_NLT);
+            mask = _mm512_mask_cmp_epi64_mask(mask, vector, uppers, _MM_CMPINT_LE);
+            filter_mask.setByteAligned(i, mask);
+        }
+    }
+    return i;
+}
+
+/**
+ * Compare the values from start, which is a multiple of 8, in chunks of 32 bytes.
+ *
+ * @return the index of the first value that has not been compared
+ */
+template <class T, class OP>
+__attribute__((target("avx2")))
+static long FilterValuesAvx2(const T * values, long start, long end, T constant, PixelsBitMask &filter_mask) {
+    long i = start;
+    if constexpr(sizeof(T) == 4 || sizeof(T) == 8) {
+        for (; i + 8 <= end; i += 8) {
+            uint8_t mask = PixelsFilter::CompareAvx2<T, OP>((void *)(values + i), constant);
+            filter_mask.setByteAligned(i, mask);
+        }
+    }
+    return i;
+}
+
+/**
+ * Check lower <= value <= upper from start, which is a multiple of 8, in chunks of 32 bytes.
+ *
+ * @return the index of the first value that has not been compared
+ */
+template <class T>
+__attribute__((target("avx2")))
+static long FilterRangeAvx2(const T * values, long start, long end, T lower, T upper,
+                            PixelsBitMask &filter_mask) {
+    long i = start;
+    if constexpr(sizeof(T) == 4 || sizeof(T) == 8) {
+        for (; i + 8 <= end; i += 8) {
+            uint8_t mask = PixelsFilter::RangeAvx2<T>((void *)(values + i), lower, upper);
+            filter_mask.setByteAligned(i, mask);
+        }
+    }
+    return i;
+}
+
+// the filter kernels of the instruction set of the running CPU, undefine ENABLE_SIMD_FILTER to turn them off
+static CpuFeatures::SimdLevel FilterSimdLevel() {
 #ifdef ENABLE_SIMD_FILTER
-            for (; i < vector->length - vector->length % 8; i += 8) {
-                uint8_t mask = CompareAvx2<T, OP>(longColumnVector->longVector + i, constant_value);
-                filter_mask.setByteAligned(i, mask);
-            }
+    return CpuFeatures::GetSimdLevel();
+#else
+    return CpuFeatures::SimdLevel::SCALAR;
 #endif
-            for(; i < vector->length; i++) {
-                filter_mask.set(i, OP::Operation((T)longColumnVector->longVector[i],
-                                                 constant_value));
-            }
+}
+
+template<class T>
+__attribute__((target("avx2")))
+int PixelsFilter::RangeAvx2(void * data, T lower, T upper) {
+    // a value is in the range if it is neither less than lower nor greater than upper
+    if constexpr(sizeof(T) == 4) {
+        __m256i vector = _mm256_loadu_si256((__m256i *)data);
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(_mm256_set1_epi32(lower), vector),
+                                          _mm256_cmpgt_epi32(vector, _mm256_set1_epi32(upper)));
+        return ~_mm256_movemask_ps((__m256)outside);
+    } else if constexpr(sizeof(T) == 8) {
+        __m256i lowers = _mm256_set1_epi64x(lower);
+        __m256i uppers = _mm256_set1_epi64x(upper);
+        __m256i vector = _mm256_loadu_si256((__m256i *)data);
+        __m256i vector_next = _mm256_loadu_si256((__m256i *)((uint8_t *)data + 32));
+        __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi64(lowers, vector),
+                                          _mm256_cmpgt_epi64(vector, uppers));
+        __m256i outside_next = _mm256_or_si256(_mm256_cmpgt_epi64(lowers, vector_next),
+                                               _mm256_cmpgt_epi64(vector_next, uppers));
+        int result = _mm256_movemask_pd((__m256d)outside);
+        result += _mm256_movemask_pd((__m256d)outside_next) << 4;
+        return ~result;
+    } else {
+        throw InvalidArgumentException("We didn't support other sizes yet to do filter SIMD");
+    }
+}
+
+template <class T, class OP>
+void PixelsFilter::FilterValues(const T * values, long start, long end, T constant, PixelsBitMask &filter_mask) {
+    long i = start;
+    // the kernels write whole bytes of the mask
+    for (; i < end && i % 8 != 0; i++) {
+        filter_mask.set(i, OP::Operation(values[i], constant));
+    }
+    switch (FilterSimdLevel()) {
+        case CpuFeatures::SimdLevel::AVX512:
+            i = FilterValuesAvx512<T, OP>(values, i, end, constant, filter_mask);
+            break;
+        case CpuFeatures::SimdLevel::AVX2:
+            i = FilterValuesAvx2<T, OP>(values, i, end, constant, filter_mask);
+            break;
+        default:
             break;
+    }
+    for (; i + 8 <= end; i += 8) {
+        uint8_t mask = 0;
+        for (int j = 0; j < 8; j++) {
+            mask |= (uint8_t)OP::Operation(values[i + j], constant) << j;
         }
-        case TypeDescription::DATE: {
-            auto dateColumnVector = std::static_pointer_cast<DateColumnVector>(vector);
-            int i = 0;
-#ifdef ENABLE_SIMD_FILTER
-            for (; i < vector->length - vector->length % 8; i += 8) {
-                uint8_t mask = CompareAvx2<T, OP>(dateColumnVector->dates + i, constant_value);
-                filter_mask.setByteAligned(i, mask);
-            }
-#endif
-            for (; i < vector->length; i++) {
-                filter_mask.set(i, OP::Operation((T)dateColumnVector->dates[i],
-                                                                 constant_value));
-            }
+        filter_mask.setByteAligned(i, mask);
+    }
+    for (; i < end; i++) {
+        filter_mask.set(i, OP::Operation(values[i], constant));
+    }
+}
+
+template <class T>
+void PixelsFilter::FilterRange(const T * values, long start, long end, T lower, T upper,
+                               PixelsBitMask &filter_mask) {
+    long i = start;
+    // the kernels write whole bytes of the mask
+    for (; i < end && i % 8 != 0; i++) {
+        filter_mask.set(i, values[i] >= lower && values[i] <= upper);
+    }
+    switch (FilterSimdLevel()) {
+        case CpuFeatures::SimdLevel::AVX512:
+            i = FilterRangeAvx512<T>(values, i, end, lower, upper, filter_mask);
+            break;
+        case CpuFeatures::SimdLevel::AVX2:
+            i = FilterRangeAvx2<T>(values, i, end, lower, upper, filter_mask);
+            break;
+        default:
             break;
+    }
+    for (; i + 8 <= end; i += 8) {
+        uint8_t mask = 0;
+        for (int j = 0; j < 8; j++) {
+            mask |= (uint8_t)(values[i + j] >= lower && values[i + j] <= upper) << j;
         }
+        filter_mask.setByteAligned(i, mask);
+    }
+    for (; i < end; i++) {
+        filter_mask.set(i, values[i] >= lower && values[i] <= upper);
+    }
+}
+
+template <class T>
+T * PixelsFilter::GetValues(std::shared_ptr<ColumnVector> vector, std::shared_ptr<TypeDescription> type) {
+    switch (type->getCategory()) {
+        case TypeDescription::SHORT:
+        case TypeDescription::INT:
+            // int columns are stored as packed int32 values in intVector
+            return reinterpret_cast<T *>(std::static_pointer_cast<LongColumnVector>(vector)->intVector);
+        case TypeDescription::LONG:
+            return reinterpret_cast<T *>(std::static_pointer_cast<LongColumnVector>(vector)->longVector);
+        case TypeDescription::DATE:
+            return reinterpret_cast<T *>(std::static_pointer_cast<DateColumnVector>(vector)->dates);
+        case TypeDescription::TIMESTAMP:
+            return reinterpret_cast<T *>(std::static_pointer_cast<TimestampColumnVector>(vector)->times);
+        case TypeDescription::DECIMAL:
+            // short decimals are packed according to their physical type, see DecimalColumnReader
+            return reinterpret_cast<T *>(std::static_pointer_cast<DecimalColumnVector>(vector)->vector);
+        default:
+            throw InvalidArgumentException("Unsupported type for filter. ");
+    }
+}
+
+template <class T, class OP>
+PixelsFilter::RunMatch PixelsFilter::TemplatedRunMatch(T minimum, T maximum, T constant) {
+    if constexpr(std::is_same<OP, duckdb::Equals>()) {
+        if (constant < minimum || maximum < constant) {
+            return RunMatch::NONE;
+        }
+        return minimum == maximum ? RunMatch::ALL : RunMatch::SOME;
+    } else if constexpr(std::is_same<OP, duckdb::NotEquals>()) {
+        if (constant < minimum || maximum < constant) {
+            return RunMatch::ALL;
+        }
+        return minimum == maximum ? RunMatch::NONE : RunMatch::SOME;
+    } else {
+        // the other comparisons are monotonic, so the bounds of the run decide the whole run
+        bool minimumMatch = OP::Operation(minimum, constant);
+        bool maximumMatch = OP::Operation(maximum, constant);
+        if (minimumMatch && maximumMatch) {
+            return RunMatch::ALL;
+        } else if (!minimumMatch && !maximumMatch) {
+            return RunMatch::NONE;
+        }
+        return RunMatch::SOME;
+    }
+}
+
+template <class MATCH, class KERNEL>
+void PixelsFilter::FilterRuns(std::shared_ptr<ColumnVector> vector, std::shared_ptr<TypeDescription> type,
+                              PixelsBitMask &filter_mask, MATCH match, KERNEL kernel) {
+    long length = vector->length;
+    auto category = type->getCategory();
+    if (category != TypeDescription::SHORT && category != TypeDescription::INT &&
+        category != TypeDescription::LONG) {
+        kernel(0, length);
+        return;
+    }
+    auto longColumnVector = std::static_pointer_cast<LongColumnVector>(vector);
+    long i = 0;
+    for (auto &run : longColumnVector->runs) {
+        if (run.start >= length) {
+            break;
+        }
+        RunMatch result = match(run.minimum, run.maximum);
+        if (result == RunMatch::SOME) {
+            // evaluated row by row together with the values around it
+            continue;
+        }
+        long runEnd = std::min(length, (long) (run.start + run.length));
+        if (i < run.start) {
+            kernel(i, run.start);
+        }
+        if (result == RunMatch::NONE) {
+            filter_mask.clear(run.start, runEnd);
+        }
+        // the bits of the runs that match as a whole are left as they are
+        i = runEnd;
+    }
+    if (i < length) {
+        kernel(i, length);
+    }
+}
+
+template <class T, class OP>
+void PixelsFilter::TemplatedFilterOperation(std::shared_ptr<ColumnVector> vector,
+                              const duckdb::Value &constant, PixelsBitMask &filter_mask,
+                                            std::shared_ptr<TypeDescription> type) {
+    T constant_value = constant.template GetValueUnsafe<T>();
+    switch (type->getCategory()) {
+        case TypeDescription::SHORT:
+        case TypeDescription::INT:
+        case TypeDescription::LONG:
+        case TypeDescription::DATE:
+        case TypeDescription::TIMESTAMP:
         case TypeDescription::DECIMAL: {
-            auto decimalColumnVector = std::static_pointer_cast<DecimalColumnVector>(vector);
-            int i = 0;
-#ifdef ENABLE_SIMD_FILTER
-            for (; i < vector->length - vector->length % 8; i += 8) {
-                uint8_t mask = CompareAvx2<T, OP>(decimalColumnVector->vector + i, constant_value);
-                filter_mask.setByteAligned(i, mask);
-            }
-#endif
-            for (; i < vector->length; i++) {
-                filter_mask.set(i, OP::Operation((T)decimalColumnVector->vector[i],
-                                                                 constant_value));
+            if constexpr(std::is_integral<T>()) {
+                T * values = GetValues<T>(vector, type);
+                FilterRuns(vector, type, filter_mask,
+                           [&](long minimum, long maximum) {
+                               return TemplatedRunMatch<T, OP>((T) minimum, (T) maximum, constant_value);
+                           },
+                           [&](long start, long end) {
+                               FilterValues<T, OP>(values, start, end, constant_value, filter_mask);
+                           });
             }
             break;
         }
@@ -144,12 +422,55 @@ void PixelsFilter::TemplatedFilterOperation(std::shared_ptr<ColumnVector> vector
         case TypeDescription::CHAR:
         case TypeDescription::VARCHAR: {
             auto binaryColumnVector = std::static_pointer_cast<BinaryColumnVector>(vector);
+            if (binaryColumnVector->dictionary != nullptr) {
+                FilterDictionary<OP>(binaryColumnVector, (duckdb::string_t)constant_value, filter_mask);
+                break;
+            }
             for (int i = 0; i < vector->length; i++) {
-                filter_mask.set(i, OP::Operation((duckdb::string_t)binaryColumnVector->vector[i],
-                                                                 (duckdb::string_t)constant_value));
+                // the string reader does not materialize the values that are filtered out or null
+                if (filter_mask.get(i) && vector->checkValid(i)) {
+                    filter_mask.set(i, OP::Operation((duckdb::string_t)binaryColumnVector->vector[i],
+                                                     (duckdb::string_t)constant_value));
+                }
             }
             break;
         }
+        default:
+            throw InvalidArgumentException("Unsupported type for filter. ");
+    }
+}
+
+template <class OP>
+void PixelsFilter::FilterDictionary(std::shared_ptr<BinaryColumnVector> vector, duckdb::string_t constant,
+                                    PixelsBitMask &filter_mask) {
+    long length = vector->length;
+    const uint32_t * ids = vector->dictIds;
+    int dictionarySize = vector->dictionarySize;
+    if (dictionarySize > length) {
+        // the dictionary is larger than the batch, compare the values of the rows instead
+        for (long i = 0; i < length; i++) {
+            if (filter_mask.get(i) && vector->checkValid(i)) {
+                filter_mask.set(i, OP::Operation(vector->dictionary[ids[i]], constant));
+            }
+        }
+        return;
+    }
+    // evaluate the filter once for each dictionary entry, the null entry never qualifies
+    std::vector<uint8_t> qualified(dictionarySize + 1);
+    for (int id = 0; id < dictionarySize; id++) {
+        qualified[id] = OP::Operation(vector->dictionary[id], constant);
+    }
+    qualified[dictionarySize] = 0;
+    long i = 0;
+    for (; i + 8 <= length; i += 8) {
+        uint8_t mask = 0;
+        for (int j = 0; j < 8; j++) {
+            mask |= qualified[ids[i + j]] << j;
+        }
+        filter_mask.setByteAligned(i, mask);
+    }
+    for (; i < length; i++) {
+        filter_mask.set(i, qualified[ids[i]]);
     }
 }
 
@@ -160,28 +481,150 @@ void PixelsFilter::FilterOperationSwitch(std::shared_ptr<ColumnVector> vector, d
     if (filter_mask.isNone()) {
         return;
     }
+    PixelsBitMask resultMask(filter_mask);
     switch (type->getCategory()) {
         case TypeDescription::SHORT:
         case TypeDescription::INT:
         case TypeDescription::DATE:
-            TemplatedFilterOperation<int32_t, OP>(vector, constant, filter_mask, type);
+            TemplatedFilterOperation<int32_t, OP>(vector, constant, resultMask, type);
             break;
         case TypeDescription::LONG:
-            TemplatedFilterOperation<int64_t, OP>(vector, constant, filter_mask, type);
+        case TypeDescription::TIMESTAMP:
+            TemplatedFilterOperation<int64_t, OP>(vector, constant, resultMask, type);
             break;
         case TypeDescription::DECIMAL:
-            TemplatedFilterOperation<int64_t, OP>(vector, constant, filter_mask, type);
+            switch (constant.type().InternalType()) {
+                case duckdb::PhysicalType::INT16:
+                    TemplatedFilterOperation<int16_t, OP>(vector, constant, resultMask, type);
+                    break;
+                case duckdb::PhysicalType::INT32:
+                    TemplatedFilterOperation<int32_t, OP>(vector, constant, resultMask, type);
+                    break;
+                case duckdb::PhysicalType::INT64:
+                    TemplatedFilterOperation<int64_t, OP>(vector, constant, resultMask, type);
+                    break;
+                default:
+                    throw InvalidArgumentException("Unsupported decimal type for filter. ");
+            }
             break;
         case TypeDescription::STRING:
         case TypeDescription::BINARY:
         case TypeDescription::VARBINARY:
         case TypeDescription::CHAR:
         case TypeDescription::VARCHAR:
-            TemplatedFilterOperation<duckdb::string_t, OP>(vector, constant, filter_mask, type);
+            TemplatedFilterOperation<duckdb::string_t, OP>(vector, constant, resultMask, type);
             break;
         default:
             throw InvalidArgumentException("Unsupported type for filter. ");
     }
+    // comparisons with null never pass the filter
+    ApplyNullFilter(vector, resultMask, false);
+    filter_mask.And(resultMask);
+}
+
+void PixelsFilter::ApplyNullFilter(std::shared_ptr<ColumnVector> vector, PixelsBitMask &filterMask, bool isNull) {
+    auto * isValid = (uint8_t *)vector->isValid;
+    long byteSize = std::min(filterMask.arrayLength, (long)std::ceil(1.0 * vector->length / 8));
+    for (long i = 0; i < byteSize; i++) {
+        filterMask.mask[i] &= isNull ? ~isValid[i] : isValid[i];
+    }
+}
+
+template <class T>
+void PixelsFilter::TemplatedRangeFilter(std::shared_ptr<ColumnVector> vector, duckdb::ConstantFilter &lowerFilter,
+                                        duckdb::ConstantFilter &upperFilter, PixelsBitMask &filter_mask,
+                                        std::shared_ptr<TypeDescription> type) {
+    if (filter_mask.isNone()) {
+        return;
+    }
+    T lower = lowerFilter.constant.template GetValueUnsafe<T>();
+    T upper = upperFilter.constant.template GetValueUnsafe<T>();
+    // turn the bounds into inclusive ones
+    bool empty = false;
+    if (lowerFilter.comparison_type == duckdb::ExpressionType::COMPARE_GREATERTHAN) {
+        empty |= lower == std::numeric_limits<T>::max();
+        lower++;
+    }
+    if (upperFilter.comparison_type == duckdb::ExpressionType::COMPARE_LESSTHAN) {
+        empty |= upper == std::numeric_limits<T>::min();
+        upper--;
+    }
+    if (empty || upper < lower) {
+        memset(filter_mask.mask, 0, filter_mask.arrayLength);
+        return;
+    }
+    PixelsBitMask resultMask(filter_mask);
+    T * values = GetValues<T>(vector, type);
+    FilterRuns(vector, type, resultMask,
+               [&](long minimum, long maximum) {
+                   if ((T) maximum < lower || upper < (T) minimum) {
+                       return RunMatch::NONE;
+                   }
+                   return lower <= (T) minimum && (T) maximum <= upper ? RunMatch::ALL : RunMatch::SOME;
+               },
+               [&](long start, long end) {
+                   FilterRange<T>(values, start, end, lower, upper, resultMask);
+               });
+    // comparisons with null never pass the filter
+    ApplyNullFilter(vector, resultMask, false);
+    filter_mask.And(resultMask);
+}
+
+bool PixelsFilter::ApplyRangeFilter(std::shared_ptr<ColumnVector> vector, duckdb::ConjunctionAndFilter &filter,
+                                    PixelsBitMask &filterMask, std::shared_ptr<TypeDescription> type) {
+    if (filter.child_filters.size() != 2) {
+        return false;
+    }
+    duckdb::ConstantFilter * lowerFilter = nullptr;
+    duckdb::ConstantFilter * upperFilter = nullptr;
+    for (auto &childFilter : filter.child_filters) {
+        if (childFilter->filter_type != duckdb::TableFilterType::CONSTANT_COMPARISON) {
+            return false;
+        }
+        auto &constantFilter = (duckdb::ConstantFilter &)*childFilter;
+        switch (constantFilter.comparison_type) {
+            case duckdb::ExpressionType::COMPARE_GREATERTHAN:
+            case duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+                lowerFilter = &constantFilter;
+                break;
+            case duckdb::ExpressionType::COMPARE_LESSTHAN:
+            case duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO:
+                upperFilter = &constantFilter;
+                break;
+            default:
+                return false;
+        }
+    }
+    if (lowerFilter == nullptr || upperFilter == nullptr) {
+        return false;
+    }
+    switch (type->getCategory()) {
+        case TypeDescription::SHORT:
+        case TypeDescription::INT:
+        case TypeDescription::DATE:
+            TemplatedRangeFilter<int32_t>(vector, *lowerFilter, *upperFilter, filterMask, type);
+            return true;
+        case TypeDescription::LONG:
+        case TypeDescription::TIMESTAMP:
+            TemplatedRangeFilter<int64_t>(vector, *lowerFilter, *upperFilter, filterMask, type);
+            return true;
+        case TypeDescription::DECIMAL:
+            switch (lowerFilter->constant.type().InternalType()) {
+                case duckdb::PhysicalType::INT16:
+                    TemplatedRangeFilter<int16_t>(vector, *lowerFilter, *upperFilter, filterMask, type);
+                    return true;
+                case duckdb::PhysicalType::INT32:
+                    TemplatedRangeFilter<int32_t>(vector, *lowerFilter, *upperFilter, filterMask, type);
+                    return true;
+                case duckdb::PhysicalType::INT64:
+                    TemplatedRangeFilter<int64_t>(vector, *lowerFilter, *upperFilter, filterMask, type);
+                    return true;
+                default:
+                    return false;
+            }
+        default:
+            return false;
+    }
 }
 
 void PixelsFilter::ApplyFilter(std::shared_ptr<ColumnVector> vector, duckdb::TableFilter &filter,
@@ -190,16 +633,19 @@ void PixelsFilter::ApplyFilter(std::shared_ptr<ColumnVector> vector, duckdb::Tab
     switch (filter.filter_type) {
         case duckdb::TableFilterType::CONJUNCTION_AND: {
             auto &conjunction = (duckdb::ConjunctionAndFilter &)filter;
+            // a range predicate (e.g. BETWEEN) is evaluated in one pass
+            if (ApplyRangeFilter(vector, conjunction, filterMask, type)) {
+                break;
+            }
             for (auto &child_filter : conjunction.child_filters) {
-                PixelsBitMask childMask(filterMask.maskLength);
-                ApplyFilter(vector, *child_filter, childMask, type);
-                filterMask.And(childMask);
+                ApplyFilter(vector, *child_filter, filterMask, type);
             }
             break;
         }
         case duckdb::TableFilterType::CONJUNCTION_OR: {
             auto &conjunction = (duckdb::ConjunctionOrFilter &)filter;
             PixelsBitMask orMask(filterMask.maskLength);
+            memset(orMask.mask, 0, orMask.arrayLength);
             for (auto &childFilter : conjunction.child_filters) {
                 PixelsBitMask childMask(filterMask);
                 ApplyFilter(vector, *childFilter, childMask, type);
@@ -215,6 +661,10 @@ void PixelsFilter::ApplyFilter(std::shared_ptr<ColumnVector> vector, duckdb::Tab
                     FilterOperationSwitch<duckdb::Equals>(
                             vector, constant_filter.constant, filterMask, type);
                     break;
+                case duckdb::ExpressionType::COMPARE_NOTEQUAL:
+                    FilterOperationSwitch<duckdb::NotEquals>(
+                            vector, constant_filter.constant, filterMask, type);
+                    break;
                 case duckdb::ExpressionType::COMPARE_LESSTHAN:
                     FilterOperationSwitch<duckdb::LessThan>(
                             vector, constant_filter.constant, filterMask, type);
@@ -232,22 +682,154 @@ void PixelsFilter::ApplyFilter(std::shared_ptr<ColumnVector> vector, duckdb::Tab
                             vector, constant_filter.constant, filterMask, type);
                     break;
                 default:
-                    D_ASSERT(0);
+                    // a filter that is pushed down but not evaluated would return the rows it should drop
+                    throw InvalidArgumentException("Unsupported comparison type for filter. ");
             }
             break;
         }
         case duckdb::TableFilterType::IS_NOT_NULL:
-            // TODO: support is null
+            ApplyNullFilter(vector, filterMask, false);
             break;
         case duckdb::TableFilterType::IS_NULL:
-            // TODO: support is null
+            ApplyNullFilter(vector, filterMask, true);
             break;
         default:
-            D_ASSERT(0);
-            break;
+            throw InvalidArgumentException("Unsupported filter type for filter. ");
     }
 }
 
+template <class T>
+bool PixelsFilter::TemplatedStatisticMayMatch(duckdb::ExpressionType comparisonType,
+                                              const T &minimum, const T &maximum, const T &constant) {
+    switch (comparisonType) {
+        case duckdb::ExpressionType::COMPARE_EQUAL:
+            return !(constant < minimum) && !(maximum < constant);
+        case duckdb::ExpressionType::COMPARE_NOTEQUAL:
+            return !(minimum == constant && maximum == constant);
+        case duckdb::ExpressionType::COMPARE_LESSTHAN:
+            return minimum < constant;
+        case duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO:
+            return !(constant < minimum);
+        case duckdb::ExpressionType::COMPARE_GREATERTHAN:
+            return constant < maximum;
+        case duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+            return !(maximum < constant);
+        default:
+            return true;
+    }
+}
 
+bool PixelsFilter::ConstantStatisticMayMatch(duckdb::ConstantFilter &filter,
+                                             const pixels::proto::ColumnStatistic &statistic,
+                                             std::shared_ptr<TypeDescription> type) {
+    auto &constant = filter.constant;
+    switch (type->getCategory()) {
+        case TypeDescription::SHORT:
+        case TypeDescription::INT:
+        case TypeDescription::LONG: {
+            if (!statistic.has_intstatistics() || !statistic.intstatistics().has_minimum() ||
+                !statistic.intstatistics().has_maximum()) {
+                return true;
+            }
+            int64_t constantValue = type->getCategory() == TypeDescription::LONG ?
+                                    constant.GetValueUnsafe<int64_t>() : constant.GetValueUnsafe<int32_t>();
+            return TemplatedStatisticMayMatch<int64_t>(filter.comparison_type,
+                                                       statistic.intstatistics().minimum(),
+                                                       statistic.intstatistics().maximum(),
+                                                       constantValue);
+        }
+        case TypeDescription::DECIMAL: {
+            if (!statistic.has_intstatistics() || !statistic.intstatistics().has_minimum() ||
+                !statistic.intstatistics().has_maximum()) {
+                return true;
+            }
+            int64_t constantValue;
+            switch (constant.type().InternalType()) {
+                case duckdb::PhysicalType::INT16:
+                    constantValue = constant.GetValueUnsafe<int16_t>();
+                    break;
+                case duckdb::PhysicalType::INT32:
+                    constantValue = constant.GetValueUnsafe<int32_t>();
+                    break;
+                case duckdb::PhysicalType::INT64:
+                    constantValue = constant.GetValueUnsafe<int64_t>();
+                    break;
+                default:
+                    // long decimals are kept in int128 statistics, which we do not check yet
+                    return true;
+            }
+            return TemplatedStatisticMayMatch<int64_t>(filter.comparison_type,
+                                                       statistic.intstatistics().minimum(),
+                                                       statistic.intstatistics().maximum(),
+                                                       constantValue);
+        }
+        case TypeDescription::DATE: {
+            if (!statistic.has_datestatistics() || !statistic.datestatistics().has_minimum() ||
+                !statistic.datestatistics().has_maximum()) {
+                return true;
+            }
+            return TemplatedStatisticMayMatch<int32_t>(filter.comparison_type,
+                                                       statistic.datestatistics().minimum(),
+                                                       statistic.datestatistics().maximum(),
+                                                       constant.GetValueUnsafe<int32_t>());
+        }
+        case TypeDescription::TIMESTAMP: {
+            if (!statistic.has_timestampstatistics() || !statistic.timestampstatistics().has_minimum() ||
+                !statistic.timestampstatistics().has_maximum()) {
+                return true;
+            }
+            return TemplatedStatisticMayMatch<int64_t>(filter.comparison_type,
+                                                       statistic.timestampstatistics().minimum(),
+                                                       statistic.timestampstatistics().maximum(),
+                                                       constant.GetValueUnsafe<int64_t>());
+        }
+        case TypeDescription::STRING:
+        case TypeDescription::CHAR:
+        case TypeDescription::VARCHAR: {
+            if (!statistic.has_stringstatistics() || !statistic.stringstatistics().has_minimum() ||
+                !statistic.stringstatistics().has_maximum()) {
+                return true;
+            }
+            return TemplatedStatisticMayMatch<std::string>(filter.comparison_type,
+                                                           statistic.stringstatistics().minimum(),
+                                                           statistic.stringstatistics().maximum(),
+                                                           duckdb::StringValue::Get(constant));
+        }
+        default:
+            return true;
+    }
+}
 
-
+bool PixelsFilter::StatisticMayMatch(duckdb::TableFilter &filter, const pixels::proto::ColumnStatistic &statistic,
+                                     std::shared_ptr<TypeDescription> type) {
+    switch (filter.filter_type) {
+        case duckdb::TableFilterType::CONJUNCTION_AND: {
+            auto &conjunction = (duckdb::ConjunctionAndFilter &)filter;
+            for (auto &childFilter : conjunction.child_filters) {
+                if (!StatisticMayMatch(*childFilter, statistic, type)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case duckdb::TableFilterType::CONJUNCTION_OR: {
+            auto &conjunction = (duckdb::ConjunctionOrFilter &)filter;
+            for (auto &childFilter : conjunction.child_filters) {
+                if (StatisticMayMatch(*childFilter, statistic, type)) {
+                    return true;
+                }
+            }
+            return conjunction.child_filters.empty();
+        }
+        case duckdb::TableFilterType::CONSTANT_COMPARISON:
+            return ConstantStatisticMayMatch((duckdb::ConstantFilter &)filter, statistic, type);
+        case duckdb::TableFilterType::IS_NULL:
+            return !statistic.has_hasnull() || statistic.hasnull();
+        case duckdb::TableFilterType::IS_NOT_NULL:
+            // numberOfValues is not reliably recorded by every writer, so we can not
+            // tell whether all the values are null.
+            return true;
+        default:
+            return true;
+    }
+}
@@ -3,40 +3,156 @@
 //
 #include "PixelsFooterCache.h"
 #include "exception/InvalidArgumentException.h"
+#include "utils/ConfigFactory.h"
+#include <sys/stat.h>
 
-PixelsFooterCache::PixelsFooterCache() {
+PixelsFooterCache::PixelsFooterCache() : PixelsFooterCache(0) {
+}
+
+PixelsFooterCache::PixelsFooterCache(uint64_t capacity) {
+    this->capacity = capacity;
+    cachedBytes = 0;
+    hitCount = 0;
+    missCount = 0;
+}
+
+std::shared_ptr<PixelsFooterCache> PixelsFooterCache::Instance() {
+    static std::shared_ptr<PixelsFooterCache> instance = std::make_shared<PixelsFooterCache>(
+            std::stoull(ConfigFactory::Instance().getProperty("pixel.footer.cache.size")));
+    return instance;
+}
+
+std::string PixelsFooterCache::fileId(const std::string& path) {
+    std::string realPath = path;
+    if(realPath.rfind("file://", 0) != std::string::npos) {
+        realPath.erase(0, 7);
+    }
+    struct stat fileStat{};
+    if(stat(realPath.c_str(), &fileStat) != 0) {
+        return realPath;
+    }
+    long mtime = (long)fileStat.st_mtim.tv_sec * 1000000000L + fileStat.st_mtim.tv_nsec;
+    return realPath + "@" + std::to_string(mtime) + "@" + std::to_string((long)fileStat.st_size);
+}
+
+std::string PixelsFooterCache::rgFooterId(const std::string& fileId, int rgId) {
+    return fileId + "-" + std::to_string(rgId);
+}
+
+PixelsFooterCache::EntryList::iterator PixelsFooterCache::touch(const std::string& id) {
+    auto it = index.find(id);
+    if(it == index.end()) {
+        return entries.end();
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second;
+}
+
+void PixelsFooterCache::put(Entry entry) {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = index.find(entry.id);
+    if(it != index.end()) {
+        cachedBytes -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+    cachedBytes += entry.bytes;
+    std::string id = entry.id;
+    entries.push_front(std::move(entry));
+    index[id] = entries.begin();
+    evict();
+}
+
+void PixelsFooterCache::evict() {
+    // the entry just put is kept even if it is larger than the capacity
+    while(capacity > 0 && cachedBytes > capacity && entries.size() > 1) {
+        auto& victim = entries.back();
+        cachedBytes -= victim.bytes;
+        index.erase(victim.id);
+        entries.pop_back();
+    }
 }
 
 void PixelsFooterCache::putFileTail(const std::string& id, std::shared_ptr<FileTail> fileTail) {
-    fileTailCacheMap[id] = fileTail;
+    uint64_t bytes = fileTail->ByteSizeLong() + id.size();
+    put(Entry{id, std::move(fileTail), nullptr, bytes});
+}
+
+std::shared_ptr<FileTail> PixelsFooterCache::findFileTail(const std::string& id) {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = touch(id);
+    if(it == entries.end() || it->fileTail == nullptr) {
+        missCount++;
+        return nullptr;
+    }
+    hitCount++;
+    return it->fileTail;
 }
 
 std::shared_ptr<FileTail> PixelsFooterCache::getFileTail(const std::string& id) {
-    if(fileTailCacheMap.find(id) != fileTailCacheMap.end()) {
-        return fileTailCacheMap[id];
+    std::lock_guard<std::mutex> lock(m);
+    auto it = touch(id);
+    if(it != entries.end() && it->fileTail != nullptr) {
+        return it->fileTail;
     } else {
         throw InvalidArgumentException("No such a FileTail id.");
     }
 }
 
+bool PixelsFooterCache::containsFileTail(const std::string &id) {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = index.find(id);
+    return it != index.end() && it->second->fileTail != nullptr;
+}
+
 void PixelsFooterCache::putRGFooter(const std::string& id, std::shared_ptr<RowGroupFooter> footer) {
-    rowGroupFooterCacheMap[id] = footer;
+    uint64_t bytes = footer->ByteSizeLong() + id.size();
+    put(Entry{id, nullptr, std::move(footer), bytes});
 }
 
-bool PixelsFooterCache::containsFileTail(const std::string &id) {
-    return fileTailCacheMap.find(id) != fileTailCacheMap.end();
+std::shared_ptr<RowGroupFooter> PixelsFooterCache::findRGFooter(const std::string& id) {
+    std::lock_guard<std::mutex> lock(m);
+    auto it = touch(id);
+    if(it == entries.end() || it->rgFooter == nullptr) {
+        missCount++;
+        return nullptr;
+    }
+    hitCount++;
+    return it->rgFooter;
 }
 
 std::shared_ptr<RowGroupFooter> PixelsFooterCache::getRGFooter(const std::string& id) {
-    if(rowGroupFooterCacheMap.find(id) != rowGroupFooterCacheMap.end()) {
-        return rowGroupFooterCacheMap[id];
+    std::lock_guard<std::mutex> lock(m);
+    auto it = touch(id);
+    if(it != entries.end() && it->rgFooter != nullptr) {
+        return it->rgFooter;
     } else {
         throw InvalidArgumentException("No such a RGFooter id.");
     }
 }
 
 bool PixelsFooterCache::containsRGFooter(const std::string &id) {
-    return rowGroupFooterCacheMap.find(id) != rowGroupFooterCacheMap.end();
+    std::lock_guard<std::mutex> lock(m);
+    auto it = index.find(id);
+    return it != index.end() && it->second->rgFooter != nullptr;
+}
+
+uint64_t PixelsFooterCache::getHitCount() const {
+    return hitCount;
 }
 
+uint64_t PixelsFooterCache::getMissCount() const {
+    return missCount;
+}
+
+uint64_t PixelsFooterCache::getCachedBytes() {
+    std::lock_guard<std::mutex> lock(m);
+    return cachedBytes;
+}
 
+void PixelsFooterCache::clear() {
+    std::lock_guard<std::mutex> lock(m);
+    entries.clear();
+    index.clear();
+    cachedBytes = 0;
+}
@@ -33,11 +33,13 @@ std::shared_ptr<PixelsReader> PixelsReaderBuilder::build() {
     std::shared_ptr<PhysicalReader> fsReader =
 	    PhysicalReaderUtil::newPhysicalReader(builderStorage, builderPath);
     // try to get file tail from cache
-    std::string fileName = fsReader->getName();
     std::shared_ptr<pixels::proto::FileTail> fileTail;
-    if(builderPixelsFooterCache != nullptr && builderPixelsFooterCache->containsFileTail(fileName)) {
-        fileTail = builderPixelsFooterCache->getFileTail(fileName);
-    } else {
+    std::string fileId;
+    if(builderPixelsFooterCache != nullptr) {
+        fileId = PixelsFooterCache::fileId(fsReader->getPath());
+        fileTail = builderPixelsFooterCache->findFileTail(fileId);
+    }
+    if(fileTail == nullptr) {
         if(fsReader.get() == nullptr) {
             throw PixelsReaderException(
                     "Failed to create PixelsReader due to error of creating PhysicalReader");
@@ -64,7 +66,7 @@ std::shared_ptr<PixelsReader> PixelsReaderBuilder::build() {
             throw InvalidArgumentException("PixelsReaderBuilder::build: paring FileTail error!");
         }
 		if(builderPixelsFooterCache != nullptr) {
-			builderPixelsFooterCache->putFileTail(fileName, fileTail);
+			builderPixelsFooterCache->putFileTail(fileId, fileTail);
 		}
     }
 
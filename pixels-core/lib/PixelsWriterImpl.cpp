@@ -35,13 +35,30 @@
 #include "physical/PhysicalReader.h"
 #include "physical/PhysicalReaderUtil.h"
 #include "PixelsVersion.h"
+#include "utils/ThreadPool.h"
 
 const int PixelsWriterImpl::CHUNK_ALIGNMENT = std::stoi(ConfigFactory::Instance().getProperty("column.chunk.alignment"));
 
 const std::vector<uint8_t> PixelsWriterImpl::CHUNK_PADDING_BUFFER = std::vector<uint8_t>(CHUNK_ALIGNMENT, 0);
 
+// the threads that encode the columns, shared by all the writers
+static ThreadPool & encodingPool() {
+    static ThreadPool pool(std::stoi(ConfigFactory::Instance().getProperty("pixel.writer.threads")));
+    return pool;
+}
+
+// the tasks refer to the stack of the caller, so all of them are waited for before rethrowing
+static void waitAll(std::vector<std::future<void>> & futures) {
+    for (auto& future : futures) {
+        future.wait();
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 PixelsWriterImpl::PixelsWriterImpl(std::shared_ptr<TypeDescription> schema, int pixelsStride, int rowGroupSize,
-                                   const std::string &targetFilePath, int blockSize, bool blockPadding,
+                                   const std::string &targetFilePath, std::int64_t blockSize, bool blockPadding,
                                    EncodingLevel encodingLevel, bool nullsPadding, bool partitioned,int compressionBlockSize)
                                    : schema(schema), rowGroupSize(rowGroupSize), compressionBlockSize(compressionBlockSize) {
     this->columnWriterOption = std::make_shared<PixelsWriterOption>()->setPixelsStride(pixelsStride)->setEncodingLevel(encodingLevel)->setNullsPadding(nullsPadding);
@@ -53,11 +70,11 @@ PixelsWriterImpl::PixelsWriterImpl(std::shared_ptr<TypeDescription> schema, int
 
     for(int i=0;i<children.size();i++){
         columnWriters.push_back(ColumnWriterBuilder::newColumnWriter(children.at(i),columnWriterOption));
+        fileColStatRecorders.emplace_back(children.at(i)->getCategory());
     }
 }
 
 bool PixelsWriterImpl::addRowBatch(std::shared_ptr<VectorizedRowBatch> rowBatch) {
-    std::cout << "PixelsWriterImpl::addRowBatch" << std::endl;
     curRowGroupDataLength=0;
     curRowGroupNumOfRows+=rowBatch->count();
     writeColumnVectors(rowBatch->cols,rowBatch->count());
@@ -79,7 +96,7 @@ void PixelsWriterImpl::writeColumnVectors(std::vector<std::shared_ptr<ColumnVect
     // Writing regular columns
     for (int i = 0; i < commonColumnLength; ++i) {
        // dataLength += columnWriters[i]->write(columnVectors[i], rowBatchSize);
-       futures.emplace_back(std::async(std::launch::async, [this, columnVectors, rowBatchSize, i, &dataLength]() {
+       futures.emplace_back(encodingPool().submit([this, &columnVectors, rowBatchSize, i, &dataLength]() {
            try {
                dataLength += columnWriters[i]->write(columnVectors[i], rowBatchSize);
            } catch (const std::exception& e) {
@@ -88,15 +105,11 @@ void PixelsWriterImpl::writeColumnVectors(std::vector<std::shared_ptr<ColumnVect
        }));
     }
 
-
     // Wait for all futures to complete
-    for (auto& future : futures) {
-        future.get();  // Blocking until all tasks are completed
-    }
+    waitAll(futures);
 
     // Simulate curRowGroupDataLength accumulation
     curRowGroupDataLength += dataLength.load();
-    std::cout << "Data length written: " << curRowGroupDataLength << std::endl;
 }
 
 void PixelsWriterImpl::close(){
@@ -104,11 +117,17 @@ void PixelsWriterImpl::close(){
         if(curRowGroupNumOfRows!=0){
             writeRowGroup();
         }
+        if(rowGroupWriting.valid()){
+            rowGroupWriting.get();
+        }
         writeFileTail();
         physicalWriter->close();
         for(auto cw:columnWriters){
             cw->close();
         }
+        for(auto cw:spareColumnWriters){
+            cw->close();
+        }
     }
     catch (const std::exception& e){
         std::cerr <<e.what()<<std::endl;
@@ -116,18 +135,54 @@ void PixelsWriterImpl::close(){
     }
 }
 
+long PixelsWriterImpl::getCompletedBytes() {
+    return completedBytes;
+}
+
 void PixelsWriterImpl::writeRowGroup() {
-    // TODO
-    std::cout<<"Try to write rowGroup"<<std::endl;
+    // flush writes the last pixel and the isNull bit map into the internal output stream.
+    std::vector<std::future<void>> futures;
+    for(auto& writer:columnWriters){
+        futures.emplace_back(encodingPool().submit([&writer]() {
+            writer->flush();
+        }));
+    }
+    waitAll(futures);
+    // get current row group content size in bytes
+    int rowGroupDataLength = 0;
+    for(auto& writer:columnWriters){
+        rowGroupDataLength+=writer->getColumnChunkSize();
+        if(CHUNK_ALIGNMENT!=0&& rowGroupDataLength%CHUNK_ALIGNMENT!=0){
+            rowGroupDataLength+=CHUNK_ALIGNMENT-rowGroupDataLength%CHUNK_ALIGNMENT;
+        }
+    }
+    completedBytes += rowGroupDataLength;
+
+    // the previous row group has to be written before its column writers are reused
+    if(rowGroupWriting.valid()){
+        rowGroupWriting.get();
+    }
+    if(spareColumnWriters.empty()){
+        for(int i=0;i<children.size();i++){
+            spareColumnWriters.push_back(ColumnWriterBuilder::newColumnWriter(children.at(i),columnWriterOption));
+        }
+    }
+    // write this row group in the background while the next one is encoded into the spare writers
+    std::swap(columnWriters, spareColumnWriters);
+    std::int64_t numOfRows = curRowGroupNumOfRows;
+    rowGroupWriting = std::async(std::launch::async, [this, numOfRows]() {
+        writeRowGroupContent(spareColumnWriters, numOfRows);
+    });
+}
+
+void PixelsWriterImpl::writeRowGroupContent(std::vector<std::shared_ptr<ColumnWriter>>& writers,
+                                            std::int64_t numOfRows) {
     int rowGroupDataLength = 0;
-//    pixels::proto::RowGroupStatistic curRowGroupStatistic;
+    pixels::proto::RowGroupStatistic curRowGroupStatistic;
     pixels::proto::RowGroupInformation curRowGroupInfo;
     pixels::proto::RowGroupIndex curRowGroupIndex;
     pixels::proto::RowGroupEncoding curRowGroupEncoding;
-    // reset each column writer and get current row group content size in bytes
-    for(auto writer:columnWriters){
-        // flush writes the isNull bit map into the internal output stream.
-        writer->flush();
+    for(auto& writer:writers){
         rowGroupDataLength+=writer->getColumnChunkSize();
         if(CHUNK_ALIGNMENT!=0&& rowGroupDataLength%CHUNK_ALIGNMENT!=0){
             /*
@@ -155,7 +210,7 @@ void PixelsWriterImpl::writeRowGroup() {
                 throw std::runtime_error("Failed to align the start offset of the column chunks in the row group");
             }
 
-            for(auto& writer:columnWriters){
+            for(auto& writer:writers){
                 auto rowGroupBuffer=writer->getColumnChunkContent();
                 physicalWriter->append(rowGroupBuffer.data(), 0, rowGroupBuffer.size());
                 writtenBytes += rowGroupBuffer.size();
@@ -179,8 +234,8 @@ void PixelsWriterImpl::writeRowGroup() {
 
     // update index and stats(necessary?)
     rowGroupDataLength=0;
-    for(int i=0;i<columnWriters.size();i++){
-        std::shared_ptr<ColumnWriter> writer=columnWriters[i];
+    for(int i=0;i<writers.size();i++){
+        std::shared_ptr<ColumnWriter> writer=writers[i];
         auto chunkIndex=writer->getColumnChunkIndex();
         chunkIndex.set_chunkoffset(curRowGroupOffset+rowGroupDataLength);
         chunkIndex.set_chunklength(writer->getColumnChunkSize());
@@ -191,9 +246,12 @@ void PixelsWriterImpl::writeRowGroup() {
         }
         *(curRowGroupIndex.add_columnchunkindexentries()) = chunkIndex;
         *(curRowGroupEncoding.add_columnchunkencodings()) = writer->getColumnChunkEncoding();
+        // the readers prune the row groups by these statistics
+        *(curRowGroupStatistic.add_columnchunkstats()) = writer->getColumnChunkStat();
+        fileColStatRecorders[i].merge(writer->getColumnChunkStatRecorder());
 
-
-        columnWriters[i]=ColumnWriterBuilder::newColumnWriter(children.at(i),columnWriterOption);
+        // the writer is reused by the row group after the next one
+        writer->reset();
     }
 
     // put curRowGroupIndex into rowGroupFooter
@@ -201,8 +259,6 @@ void PixelsWriterImpl::writeRowGroup() {
 
     rowGroupFooter->mutable_rowgroupindexentry()->CopyFrom(curRowGroupIndex);
     rowGroupFooter->mutable_rowgroupencoding()->CopyFrom(curRowGroupEncoding);
-    std::cout<<"curRowGroupEncoding: "<<curRowGroupEncoding.ByteSizeLong()<<std::endl;
-    std::cout<<"curRowGroupEncoding: "<<curRowGroupEncoding.ByteSizeLong()<<std::endl;
     try {
         ByteBuffer footerBuffer(rowGroupFooter->ByteSizeLong());
         rowGroupFooter->SerializeToArray(footerBuffer.getPointer(), rowGroupFooter->ByteSizeLong());
@@ -218,12 +274,12 @@ void PixelsWriterImpl::writeRowGroup() {
     curRowGroupInfo.set_footeroffset(curRowGroupFooterOffset);
     curRowGroupInfo.set_datalength(rowGroupDataLength);
     curRowGroupInfo.set_footerlength(rowGroupFooter->ByteSizeLong());
-    curRowGroupInfo.set_numberofrows(curRowGroupNumOfRows);
+    curRowGroupInfo.set_numberofrows(numOfRows);
     rowGroupInfoList.push_back(curRowGroupInfo);
+    rowGroupStatisticList.push_back(curRowGroupStatistic);
 
-    this->fileRowNum += curRowGroupNumOfRows;
+    this->fileRowNum += numOfRows;
     this->fileContentLength += rowGroupDataLength;
-    std::cout << "PixelsWriterImpl::writeRowGroup" << std::endl;
 }
 
 void PixelsWriterImpl::writeFileTail() {
@@ -233,6 +289,12 @@ void PixelsWriterImpl::writeFileTail() {
     for(auto rowGroupInformation: rowGroupInfoList){
         *(footer->add_rowgroupinfos()) = rowGroupInformation;
     }
+    for(auto& rowGroupStatistic: rowGroupStatisticList){
+        *(footer->add_rowgroupstats()) = rowGroupStatistic;
+    }
+    for(auto& recorder: fileColStatRecorders){
+        *(footer->add_columnstats()) = recorder.serialize();
+    }
     postScript->set_version(PixelsVersion::V1);
     std::string FILE_MAGIC="PIXELS";
     postScript->set_contentlength(fileContentLength);
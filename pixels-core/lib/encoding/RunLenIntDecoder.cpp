@@ -3,6 +3,7 @@
 //
 
 #include "encoding/RunLenIntDecoder.h"
+#include <algorithm>
 
 RunLenIntDecoder::RunLenIntDecoder(const std::shared_ptr <ByteBuffer>& bb, bool isSigned) {
     literals = new long[Constants::MAX_SCOPE];
@@ -35,6 +36,246 @@ long RunLenIntDecoder::next() {
     return result;
 }
 
+void RunLenIntDecoder::skip(long numValues) {
+    while(numValues > 0) {
+        if(used == numLiterals) {
+            numLiterals = 0;
+            used = 0;
+            // jump over the runs that are skipped as a whole without decoding them
+            long skipped = skipRun(numValues);
+            if(skipped > 0) {
+                numValues -= skipped;
+                continue;
+            }
+            readValues();
+            if(numLiterals == 0) {
+                break;
+            }
+        }
+        long consumed = std::min((long)(numLiterals - used), numValues);
+        used += consumed;
+        numValues -= consumed;
+    }
+}
+
+/**
+ * Skip the next run in the input stream without decoding it, if the run
+ * has no more than maxValues values.
+ *
+ * @param maxValues the max number of values to skip
+ * @return the number of values skipped, 0 if the run is not skipped and
+ * the input stream is not moved.
+ */
+long RunLenIntDecoder::skipRun(long maxValues) {
+    if(inputStream->bytesRemaining() == 0) {
+        return 0;
+    }
+    uint32_t runStart = inputStream->getReadPos();
+    int firstByte = (int) inputStream->get();
+    auto currentEncoding = (EncodingType) ((firstByte >> 6) & 0x03);
+    long runLength = 0;
+    switch (currentEncoding) {
+        case RunLenIntEncoder::SHORT_REPEAT: {
+            int size = ((((uint32_t)firstByte) >> 3) & 0x07) + 1;
+            runLength = (firstByte & 0x07) + Constants::MIN_REPEAT;
+            if(runLength <= maxValues) {
+                inputStream->skipBytes(size);
+            }
+            break;
+        }
+        case RunLenIntEncoder::DIRECT: {
+            int fb = encodingUtils.decodeBitWidth((firstByte >> 1) & 0x1f);
+            runLength = (((firstByte & 0x01) << 8) | inputStream->get()) + 1;
+            if(runLength <= maxValues) {
+                inputStream->skipBytes((runLength * fb + 7) / 8);
+            }
+            break;
+        }
+        case RunLenIntEncoder::DELTA: {
+            uint8_t fb = (((uint32_t)firstByte) >> 1) & 0x1f;
+            if(fb != 0) {
+                fb = encodingUtils.decodeBitWidth(fb);
+            }
+            int len = ((firstByte & 0x01) << 8) | inputStream->get();
+            // the first value is followed by len values
+            runLength = len + 1;
+            if(runLength <= maxValues) {
+                // the first value and the fixed delta or delta base
+                readVulong(inputStream);
+                readVulong(inputStream);
+                if(fb != 0) {
+                    inputStream->skipBytes(((long)(len - 1) * fb + 7) / 8);
+                }
+            }
+            break;
+        }
+        default:
+            runLength = maxValues + 1;
+            break;
+    }
+    if(runLength > maxValues) {
+        inputStream->setReadPos(runStart);
+        return 0;
+    }
+    return runLength;
+}
+
+int RunLenIntDecoder::decode(long * out, int n) {
+    return decodeInto<long>(out, n);
+}
+
+template <class T>
+int RunLenIntDecoder::decodeInto(T * out, int n, std::vector<IntegerRun> * runs, int start) {
+    int decoded = 0;
+    while(decoded < n) {
+        if(used == numLiterals) {
+            numLiterals = 0;
+            used = 0;
+            if(inputStream->bytesRemaining() == 0) {
+                break;
+            }
+            int runLength = decodeRun(out + decoded, n - decoded, runs, start + decoded);
+            if(runLength > 0) {
+                decoded += runLength;
+                continue;
+            }
+            readValues();
+            if(numLiterals == 0) {
+                break;
+            }
+        }
+        int count = std::min(numLiterals - used, n - decoded);
+        for(int i = 0; i < count; i++) {
+            out[decoded + i] = (T) literals[used + i];
+        }
+        used += count;
+        decoded += count;
+    }
+    return decoded;
+}
+
+/**
+ * Decode the next run in the input stream straight into out, if the run
+ * has no more than maxValues values.
+ *
+ * @param out the output values
+ * @param maxValues the max number of values to decode
+ * @param runs if not null, receives the run decoded
+ * @param start the index of out[0] in the column vector
+ * @return the number of values decoded, 0 if the run is not decoded and
+ * the input stream is not moved.
+ */
+template <class T>
+int RunLenIntDecoder::decodeRun(T * out, int maxValues, std::vector<IntegerRun> * runs, int start) {
+    uint32_t runStart = inputStream->getReadPos();
+    int firstByte = (int) inputStream->get();
+    auto currentEncoding = (EncodingType) ((firstByte >> 6) & 0x03);
+    switch (currentEncoding) {
+        case RunLenIntEncoder::SHORT_REPEAT: {
+            int size = ((((uint32_t)firstByte) >> 3) & 0x07) + 1;
+            int len = (firstByte & 0x07) + Constants::MIN_REPEAT;
+            if(len > maxValues) {
+                break;
+            }
+            long val = bytesToLongBE(inputStream, size);
+            if(isSigned) {
+                val = zigzagDecode(val);
+            }
+            std::fill_n(out, len, (T) val);
+            addRun(runs, {start, len, val, val, val, true, 0});
+            return len;
+        }
+        case RunLenIntEncoder::DIRECT: {
+            int fb = encodingUtils.decodeBitWidth((firstByte >> 1) & 0x1f);
+            int len = (((firstByte & 0x01) << 8) | inputStream->get()) + 1;
+            if(len > maxValues) {
+                break;
+            }
+            // the literal buffer is empty here, use it to hold the unpacked values
+            readInts(literals, 0, len, fb, inputStream);
+            if(isSigned) {
+                for(int i = 0; i < len; i++) {
+                    out[i] = (T) zigzagDecode(literals[i]);
+                }
+            } else {
+                for(int i = 0; i < len; i++) {
+                    out[i] = (T) literals[i];
+                }
+            }
+            return len;
+        }
+        case RunLenIntEncoder::DELTA: {
+            uint8_t fb = (((uint32_t)firstByte) >> 1) & 0x1f;
+            if(fb != 0) {
+                fb = encodingUtils.decodeBitWidth(fb);
+            }
+            int len = ((firstByte & 0x01) << 8) | inputStream->get();
+            // the first value is followed by len values
+            if(len + 1 > maxValues) {
+                break;
+            }
+            long firstVal = isSigned ? readVslong(inputStream) : readVulong(inputStream);
+            if(fb == 0) {
+                // fixed delta, expand the arithmetic sequence
+                long fd = readVslong(inputStream);
+                for(int i = 0; i <= len; i++) {
+                    out[i] = (T) (firstVal + i * fd);
+                }
+                long lastVal = firstVal + len * fd;
+                addRun(runs, {start, len + 1, firstVal, std::min(firstVal, lastVal),
+                              std::max(firstVal, lastVal), true, fd});
+            } else {
+                long deltaBase = readVslong(inputStream);
+                readInts(literals, 0, len - 1, fb, inputStream);
+                // prefix sum of the unpacked deltas, whose sign is given by the delta base
+                long prevVal = firstVal + deltaBase;
+                out[0] = (T) firstVal;
+                out[1] = (T) prevVal;
+                if(deltaBase < 0) {
+                    for(int i = 0; i < len - 1; i++) {
+                        prevVal -= literals[i];
+                        out[i + 2] = (T) prevVal;
+                    }
+                } else {
+                    for(int i = 0; i < len - 1; i++) {
+                        prevVal += literals[i];
+                        out[i + 2] = (T) prevVal;
+                    }
+                }
+                // the deltas share the sign of the delta base, so the run is monotonic
+                addRun(runs, {start, len + 1, firstVal, std::min(firstVal, prevVal),
+                              std::max(firstVal, prevVal), false, 0});
+            }
+            return len + 1;
+        }
+        default:
+            break;
+    }
+    inputStream->setReadPos(runStart);
+    return 0;
+}
+
+template int RunLenIntDecoder::decodeInto<int32_t>(int32_t * out, int n, std::vector<IntegerRun> * runs, int start);
+template int RunLenIntDecoder::decodeInto<long>(long * out, int n, std::vector<IntegerRun> * runs, int start);
+
+void RunLenIntDecoder::addRun(std::vector<IntegerRun> * runs, const IntegerRun & run) {
+    if(runs == nullptr) {
+        return;
+    }
+    if(!runs->empty()) {
+        // merge the run into the previous one if it continues the same sequence
+        IntegerRun & last = runs->back();
+        if(last.sequence && run.sequence && last.delta == run.delta &&
+           last.start + last.length == run.start && last.first + last.length * last.delta == run.first) {
+            last.length += run.length;
+            last.minimum = std::min(last.minimum, run.minimum);
+            last.maximum = std::max(last.maximum, run.maximum);
+            return;
+        }
+    }
+    runs->emplace_back(run);
+}
+
 void RunLenIntDecoder::readValues() {
 	// read the first 2 bits and determine the encoding type
 	isRepeating = false;
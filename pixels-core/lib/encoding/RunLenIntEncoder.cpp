@@ -97,6 +97,15 @@ void RunLenIntEncoder::encode(int* values, byte* results, int length, int& resLe
     encode(values, 0, length, results, resLen);
 }
 
+void RunLenIntEncoder::encode(long* values, int length, const std::shared_ptr<ByteBuffer>& output) {
+    for(int i = 0; i < length; ++i) {
+        this->write(values[i]);
+    }
+    flush();
+    output->putBytes(outputStream->getPointer(), outputStream->getWritePos());
+    outputStream->resetPosition();
+}
+
 
 // -----------------------------------------------------------
 
@@ -972,7 +981,7 @@ void RunLenIntEncoder::writeVulong(std::shared_ptr<ByteBuffer> output, long valu
         }
         else {
             output->put((byte) (0x80 | (value & 0x7f)));
-            value = ((unsigned)value) >> 7;
+            value = ((uint64_t)value) >> 7;
         }
     }
 }
@@ -55,6 +55,16 @@ ColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncod
                    pixels::proto::ColumnChunkIndex &chunkIndex, std::shared_ptr<PixelsBitMask> filterMask) {
 }
 
+void ColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding &encoding, int offset,
+                        int size, int pixelStride, pixels::proto::ColumnChunkIndex &chunkIndex) {
+	throw InvalidArgumentException("ColumnReader::skip: This function is not supported yet. ");
+}
+
+void ColumnReader::skipValid(int pixelStride, int size, bool hasNull) {
+    if (hasNull) {
+        isNullOffset += ceil(1.0 * std::min(pixelStride, size) / 8);
+    }
+}
 
 void ColumnReader::setValid(const std::shared_ptr<ByteBuffer>& input, int pixelStride, const std::shared_ptr<ColumnVector>& columnVector, int pixelId, bool hasNull) {
     int elementSizeInCurrPixels = std::min(pixelStride, (int)columnVector->length);
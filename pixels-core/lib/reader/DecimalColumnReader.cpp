@@ -67,4 +67,20 @@ void DecimalColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto:
         throw std::runtime_error(
             "DecimalColumnReader: Unexpected Physical Type");
     }
+    elementIndex += size;
+}
+
+void DecimalColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding & encoding, int offset,
+                               int size, int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex) {
+    if(offset == 0) {
+        ColumnReader::elementIndex = 0;
+        isNullOffset = chunkIndex.isnulloffset();
+    }
+
+    int pixelId = elementIndex / pixelStride;
+    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
+    skipValid(pixelStride, size, hasNull);
+    // short decimals are always stored as 8-byte values
+    input->setReadPos(input->getReadPos() + size * sizeof(long));
+    elementIndex += size;
 }
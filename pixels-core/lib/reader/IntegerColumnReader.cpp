@@ -40,29 +40,109 @@ void IntegerColumnReader::read(std::shared_ptr<ByteBuffer> input,
     bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
     setValid(input, pixelStride, vector, pixelId, hasNull);
 
-    if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+    if (vectorIndex == 0) {
+        columnVector->runs.clear();
+    }
+    // without nulls padding, only the values that are not null are stored. They are read in
+    // one piece and moved to their positions afterwards, so the mask can not be applied
+    int valueNum = size;
+    if (hasNull && !chunkIndex.nullspadding()) {
+        valueNum = 0;
         for (int i = 0; i < size; i++) {
+            valueNum += columnVector->checkValid(i);
+        }
+        filterMask = nullptr;
+    }
+    if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+        // keep the runs for the consumers of encoded column vectors. Only the runs decoded as a whole
+        // are recorded, so with late materialization they never cover the values skipped by the mask
+        std::vector<IntegerRun> * runs = columnVector->encoding && valueNum == size ?
+                                         &columnVector->runs : nullptr;
+        int i = 0;
+        while (i < valueNum) {
+            if (filterMask != nullptr && !filterMask->get(i)) {
+                // late materialization: skip the values that are filtered out
+                int next = (int) filterMask->nextSetBit(i, size);
+                decoder->skip(next - i);
+                i = next;
+                continue;
+            }
+            // decode the values up to the next filtered out one in bulk
+            int end = filterMask == nullptr ? valueNum : (int) filterMask->nextClearBit(i, size);
             if (isLong) {
-                columnVector->longVector[i + vectorIndex] = decoder->next();
+                decoder->decodeInto<long>(columnVector->longVector + i + vectorIndex, end - i,
+                                          runs, i + vectorIndex);
             } else {
-                *(reinterpret_cast<int *>(columnVector->intVector) + i +
-                  vectorIndex) = decoder->next();
+                decoder->decodeInto<int32_t>(reinterpret_cast<int *>(columnVector->intVector) + i +
+                                             vectorIndex, end - i, runs, i + vectorIndex);
             }
-            elementIndex++;
+            i = end;
         }
     } else {
         if (isLong) {
             std::memcpy(reinterpret_cast<int64_t *>(columnVector->longVector) +
                             vectorIndex,
                         input->getPointer() + input->getReadPos(),
-                        size * sizeof(int64_t));
-            input->setReadPos(input->getReadPos() + size * sizeof(int64_t));
+                        valueNum * sizeof(int64_t));
+            input->setReadPos(input->getReadPos() + valueNum * sizeof(int64_t));
         } else {
             // if int
             std::memcpy(
                 reinterpret_cast<int *>(columnVector->intVector) + vectorIndex,
-                input->getPointer() + input->getReadPos(), size * sizeof(int));
-            input->setReadPos(input->getReadPos() + size * sizeof(int));
+                input->getPointer() + input->getReadPos(), valueNum * sizeof(int));
+            input->setReadPos(input->getReadPos() + valueNum * sizeof(int));
+        }
+    }
+    if (valueNum < size) {
+        if (isLong) {
+            spreadValues(columnVector->longVector + vectorIndex, columnVector, size, valueNum);
+        } else {
+            spreadValues(reinterpret_cast<int *>(columnVector->intVector) + vectorIndex, columnVector,
+                         size, valueNum);
+        }
+    }
+    elementIndex += size;
+}
+
+template <class T>
+void IntegerColumnReader::spreadValues(T * values, const std::shared_ptr<LongColumnVector> & columnVector,
+                                       int size, int valueNum) {
+    // backwards, so that a value is moved before its position is overwritten
+    int j = valueNum - 1;
+    for (int i = size - 1; i > j; i--) {
+        if (columnVector->checkValid(i)) {
+            values[i] = values[j--];
+        }
+    }
+}
+
+void IntegerColumnReader::skip(std::shared_ptr<ByteBuffer> input,
+                               pixels::proto::ColumnEncoding &encoding,
+                               int offset, int size, int pixelStride,
+                               pixels::proto::ColumnChunkIndex &chunkIndex) {
+    if (offset == 0) {
+        decoder = std::make_shared<RunLenIntDecoder>(input, true);
+        ColumnReader::elementIndex = 0;
+        isLong = type->getCategory() == TypeDescription::Category::LONG;
+        isNullOffset = chunkIndex.isnulloffset();
+    }
+
+    int pixelId = elementIndex / pixelStride;
+    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
+    int valueNum = size;
+    if (hasNull && !chunkIndex.nullspadding()) {
+        // only the values that are not null are stored, count the set bits of the nulls bit map
+        const uint8_t * isNull = input->getPointer() + isNullOffset;
+        for (int i = 0; i < size; i++) {
+            valueNum -= (isNull[i / 8] >> (i % 8)) & 1;
         }
     }
+    skipValid(pixelStride, size, hasNull);
+
+    if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+        decoder->skip(valueNum);
+    } else {
+        input->setReadPos(input->getReadPos() + valueNum * (isLong ? sizeof(int64_t) : sizeof(int)));
+    }
+    elementIndex += size;
 }
@@ -10,6 +10,7 @@ PixelsReaderOption::PixelsReaderOption() {
     tolerantSchemaEvolution = true;
     enableEncodedColumnVector = true;
     enableFilterPushDown = false;
+    enableLateMaterialization = false;
     queryId = -1L;
     batchSize = 0;
     rgStart = 0;
@@ -69,6 +70,14 @@ bool PixelsReaderOption::isEnableEncodedColumnVector() {
     return enableEncodedColumnVector;
 }
 
+void PixelsReaderOption::setEnableLateMaterialization(bool enabled) {
+    enableLateMaterialization = enabled;
+}
+
+bool PixelsReaderOption::isEnableLateMaterialization() {
+    return enableLateMaterialization;
+}
+
 void PixelsReaderOption::setEnabledFilterPushDown(bool enabledFilterPushDown) {
     this->enableFilterPushDown = enabledFilterPushDown;
 }
@@ -7,13 +7,11 @@
 #include "profiler/CountProfiler.h"
 
 PixelsRecordReaderImpl::PixelsRecordReaderImpl(std::shared_ptr<PhysicalReader> reader,
-                                               const pixels::proto::PostScript& pixelsPostScript,
-                                               const pixels::proto::Footer& pixelsFooter,
+                                               std::shared_ptr<pixels::proto::FileTail> pixelsFileTail,
                                                const PixelsReaderOption& opt,
-                                               std::shared_ptr<PixelsFooterCache> pixelsFooterCache) {
+                                               std::shared_ptr<PixelsFooterCache> pixelsFooterCache)
+    : fileTail(std::move(pixelsFileTail)), footer(fileTail->footer()), postScript(fileTail->postscript()) {
     physicalReader = reader;
-    footer = pixelsFooter;
-    postScript = pixelsPostScript;
     footerCache = pixelsFooterCache;
     option = opt;
     // TODO: intialize all kinds of variables
@@ -30,6 +28,7 @@ PixelsRecordReaderImpl::PixelsRecordReaderImpl(std::shared_ptr<PhysicalReader> r
     } else {
         filter = nullptr;
     }
+    enableLateMaterialization = option.isEnableLateMaterialization() && filter != nullptr;
     filterMask = nullptr;
     everRead = false;
 	everPrepareRead = false;
@@ -42,6 +41,11 @@ PixelsRecordReaderImpl::PixelsRecordReaderImpl(std::shared_ptr<PhysicalReader> r
     includedColumnNum = 0;
 	endOfFile = false;
     resultRowBatch = nullptr;
+    bufferSlot = -1;
+    prefetchedBufferSlot = -1;
+    prefetchedRGIdx = -1;
+    prefetchedTaskNum = 0;
+    advisedRGIdx = -1;
     // ::DirectUringRandomAccessFile::Initialize();
     checkBeforeRead();
 }
@@ -119,11 +123,6 @@ void PixelsRecordReaderImpl::UpdateRowGroupInfo() {
 	// if not end of file, update row count
 	curRGRowCount = (int) footer.rowgroupinfos(targetRGs.at(curRGIdx)).numberofrows();
 
-    if(enabledFilterPushDown) {
-        int length = std::min(batchSize, curRGRowCount);
-        filterMask = std::make_shared<PixelsBitMask>(length);
-    }
-
 	curRGFooter = rowGroupFooters.at(curRGIdx);
 	// refresh resultColumnsEncoded for reading the column vectors in the next row group.
 	const pixels::proto::RowGroupEncoding& rgEncoding = rowGroupFooters.at(curRGIdx)->rowgroupencoding();
@@ -159,6 +158,9 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
 		if(!read()) {
 			throw std::runtime_error("failed to read file");
 		}
+		if(endOfFile) {
+			return createEmptyEOFRowBatch(0);
+		}
 	}
 
 
@@ -167,6 +169,26 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
 
     // update current batch size
     int curBatchSize = std::min(curRGRowCount - curRowInRG, std::min(batchSize, curRGRowCount));
+    asyncReadCompleteCurrent();
+    prefetchNextRowGroup();
+
+    // skip the pixels that can not pass the filter according to the pixel statistics
+    while(filter != nullptr && !batchMayMatch(curBatchSize)) {
+        skipBatch(curBatchSize);
+        moveToNextBatch(curBatchSize);
+        if(endOfFile) {
+            return createEmptyEOFRowBatch(0);
+        }
+        if(!everRead) {
+            if(!read()) {
+                throw std::runtime_error("failed to read file");
+            }
+            asyncReadCompleteCurrent();
+            prefetchNextRowGroup();
+        }
+        curBatchSize = std::min(curRGRowCount - curRowInRG, std::min(batchSize, curRGRowCount));
+    }
+
     if(resultRowBatch == nullptr) {
         resultRowBatch = resultSchema->createRowBatch(curBatchSize, resultColumnsEncoded);
     } else {
@@ -177,14 +199,16 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
     }
 
     auto columnVectors = resultRowBatch->cols;
-    if(filterMask != nullptr) {
-        filterMask->set();
+    if(enabledFilterPushDown) {
+        // the mask must cover exactly the rows of this batch, so that it can be handed to the caller
+        if(filterMask == nullptr || filterMask->maskLength != curBatchSize) {
+            filterMask = std::make_shared<PixelsBitMask>(curBatchSize);
+        } else {
+            filterMask->set();
+        }
     }
 
     std::vector<int> filterColumnIndex;
-    if(has_async_task_num_ > 0) {
-      asyncReadComplete(has_async_task_num_);
-    }
     if(filter != nullptr) {
         for (auto &filterCol : filter->filters) {
             if(filterMask->isNone()) {
@@ -204,13 +228,11 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
     }
 
     // read vectors
+    // With late materialization, the non-filter columns are only decoded for the rows
+    // passing the filter. If no row passes, they are skipped so that the reading cursors
+    // of the column readers are still moved forward (Issue #564).
+    bool skipRemaining = enableLateMaterialization && filterMask->isNone();
     for(int i = 0; i < resultColumns.size(); i++) {
-        // TODO: Refer to Issue #564. Disable data skipping
-        //if(filterMask != nullptr) {
-        //    if(filterMask->isNone()) {
-        //        break;
-        //    }
-        //}
         // Skip the columns that calculate the filter mask, since they are already processed
         int index = curChunkBufferIndex.at(i);
         if(std::find(filterColumnIndex.begin(), filterColumnIndex.end(), index) != filterColumnIndex.end()) {
@@ -218,14 +240,59 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
         }
         auto & encoding = curEncoding.at(i);
         auto & chunkIndex = curChunkIndex.at(i);
-        readers.at(i)->read(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
-                            postScript.pixelstride(), resultRowBatch->rowCount,
-                            columnVectors.at(i), *chunkIndex, filterMask);
+        if(skipRemaining) {
+            readers.at(i)->skip(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
+                                postScript.pixelstride(), *chunkIndex);
+        } else {
+            readers.at(i)->read(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
+                                postScript.pixelstride(), resultRowBatch->rowCount,
+                                columnVectors.at(i), *chunkIndex,
+                                enableLateMaterialization ? filterMask : nullptr);
+        }
+    }
+
+    resultRowBatch->rowCount += curBatchSize;
+    moveToNextBatch(curBatchSize);
+	return resultRowBatch;
+}
+
+bool PixelsRecordReaderImpl::batchMayMatch(int curBatchSize) {
+    int pixelStride = (int) postScript.pixelstride();
+    int startPixelId = curRowInRG / pixelStride;
+    int endPixelId = (curRowInRG + curBatchSize - 1) / pixelStride;
+    for (auto &filterCol : filter->filters) {
+        int i = filterCol.first;
+        auto & chunkIndex = curChunkIndex.at(i);
+        bool columnMayMatch = false;
+        for(int pixelId = startPixelId; pixelId <= endPixelId; pixelId++) {
+            if(pixelId >= chunkIndex->pixelstatistics_size() ||
+               PixelsFilter::StatisticMayMatch(*filterCol.second,
+                                               chunkIndex->pixelstatistics(pixelId).statistic(),
+                                               resultSchema->getChildren().at(i))) {
+                columnMayMatch = true;
+                break;
+            }
+        }
+        if(!columnMayMatch) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PixelsRecordReaderImpl::skipBatch(int curBatchSize) {
+    for(int i = 0; i < resultColumns.size(); i++) {
+        int index = curChunkBufferIndex.at(i);
+        auto & encoding = curEncoding.at(i);
+        auto & chunkIndex = curChunkIndex.at(i);
+        readers.at(i)->skip(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
+                            postScript.pixelstride(), *chunkIndex);
     }
+}
 
+void PixelsRecordReaderImpl::moveToNextBatch(int curBatchSize) {
     // update current row index in the row group
     curRowInRG += curBatchSize;
-    resultRowBatch->rowCount += curBatchSize;
     // update row group index if current row index exceeds max row count in the row group
     if(curRowInRG >= curRGRowCount) {
         curRGIdx++;
@@ -238,7 +305,6 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
         }
         curRowInRG = 0;
     }
-	return resultRowBatch;
 }
 
 
@@ -251,7 +317,25 @@ void PixelsRecordReaderImpl::prepareRead() {
     // read row group statistics and find target row groups
     for(int i = 0; i < RGLen; i++) {
         includedRGs.at(i) = true;
-        includedRowNum += footer.rowgroupinfos(RGStart + i).numberofrows();
+        // skip the row group if its statistics prove that no row can pass the filter
+        if(filter != nullptr && footer.rowgroupstats_size() > RGStart + i) {
+            const pixels::proto::RowGroupStatistic& rowGroupStatistic = footer.rowgroupstats(RGStart + i);
+            for(auto &filterCol : filter->filters) {
+                int colId = resultColumns.at(filterCol.first);
+                if(rowGroupStatistic.columnchunkstats_size() <= colId) {
+                    continue;
+                }
+                if(!PixelsFilter::StatisticMayMatch(*filterCol.second,
+                                                    rowGroupStatistic.columnchunkstats(colId),
+                                                    resultSchema->getChildren().at(filterCol.first))) {
+                    includedRGs.at(i) = false;
+                    break;
+                }
+            }
+        }
+        if(includedRGs.at(i)) {
+            includedRowNum += footer.rowgroupinfos(RGStart + i).numberofrows();
+        }
     }
     targetRGs.clear();
     targetRGs.resize(RGLen);
@@ -264,13 +348,15 @@ void PixelsRecordReaderImpl::prepareRead() {
     }
     targetRGNum = targetRGIdx;
 
-    // TODO: if taregetRGNum == 0
+    if(targetRGNum == 0) {
+        // all the row groups are pruned, there is nothing to read in this file
+        endOfFile = true;
+        return;
+    }
 
     // read row group footers
     rowGroupFooters.clear();
     rowGroupFooters.resize(targetRGNum);
-    std::vector<bool> rowGroupFooterCacheHit;
-    rowGroupFooterCacheHit.resize(targetRGNum);
 
     /**
      * Issue #114:
@@ -282,14 +368,17 @@ void PixelsRecordReaderImpl::prepareRead() {
     RequestBatch requestBatch;
     std::vector<int> fis;
     std::vector<std::string> rgCacheIds;
+    std::string fileId = PixelsFooterCache::fileId(physicalReader->getPath());
+    cacheFileId = fileId;
     for(int i = 0; i < targetRGNum; i++) {
         int rgId = targetRGs[i];
-        std::string rgCacheId = fileName + "-" + std::to_string(rgId);
+        std::string rgCacheId = PixelsFooterCache::rgFooterId(fileId, rgId);
         rgCacheIds.emplace_back(rgCacheId);
-        if(footerCache != nullptr && footerCache->containsRGFooter(rgCacheId)) {
+        std::shared_ptr<pixels::proto::RowGroupFooter> cached =
+                footerCache != nullptr ? footerCache->findRGFooter(rgCacheId) : nullptr;
+        if(cached != nullptr) {
             // cache hit
-            rowGroupFooters.at(i) = footerCache->getRGFooter(rgCacheId);
-            rowGroupFooterCacheHit.at(i) = true;
+            rowGroupFooters.at(i) = cached;
         } else {
             // cache miss, read from disk and put it into cache
             const pixels::proto::RowGroupInformation& rowGroupInformation = footer.rowgroupinfos(rgId);
@@ -297,22 +386,20 @@ void PixelsRecordReaderImpl::prepareRead() {
             uint64_t footerLength = rowGroupInformation.footerlength();
             fis.push_back(i);
             requestBatch.add(queryId, (int) footerOffset, (int) footerLength);
-            rowGroupFooterCacheHit.at(i) = false;
         }
     }
     Scheduler * scheduler = SchedulerFactory::Instance()->getScheduler();
     auto bbs = scheduler->executeBatch(physicalReader, requestBatch, queryId);
     // TODO: the return value should be unique_ptr?
 
+    // the buffers are the footers of the missed row groups fis
     for(int i = 0; i < bbs.size(); i++) {
-        if(!rowGroupFooterCacheHit.at(i)) {
-			auto parsed = std::make_shared<pixels::proto::RowGroupFooter>();
-            parsed->ParseFromArray(bbs[i]->getPointer(), (int)bbs[i]->size());
-            rowGroupFooters.at(fis[i]) = parsed;
-			if(footerCache != nullptr) {
-				footerCache->putRGFooter(rgCacheIds[fis[i]], parsed);
-			}
-        }
+		auto parsed = std::make_shared<pixels::proto::RowGroupFooter>();
+        parsed->ParseFromArray(bbs[i]->getPointer(), (int)bbs[i]->size());
+        rowGroupFooters.at(fis[i]) = parsed;
+		if(footerCache != nullptr) {
+			footerCache->putRGFooter(rgCacheIds[fis[i]], parsed);
+		}
     }
 
     bbs.clear();
@@ -328,13 +415,9 @@ void PixelsRecordReaderImpl::prepareRead() {
 void PixelsRecordReaderImpl::asyncReadComplete(int requestSize) {
     if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io")
       && has_async_task_num_ >= requestSize) {
-        if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
-            auto localReader = std::static_pointer_cast<PhysicalLocalReader>(physicalReader);
-            localReader->readAsyncComplete(requestSize);
-          has_async_task_num_ -= requestSize;
-        } else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
-            throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
-        }
+        auto localReader = std::static_pointer_cast<PhysicalLocalReader>(physicalReader);
+        localReader->readAsyncComplete(requestSize);
+        has_async_task_num_ -= requestSize;
     }
 
 }
@@ -350,31 +433,118 @@ bool PixelsRecordReaderImpl::read() {
 	}
 
     everRead = true;
+    if(targetRGNum == 0) {
+        return true;
+    }
 
+    if(prefetchedRGIdx == curRGIdx) {
+        // the column chunks of this row group are being read by prefetchNextRowGroup(),
+        // and the previous row group is done, so its slot is given back
+        ::BufferPool::ReleaseSlot(bufferSlot);
+        bufferSlot = prefetchedBufferSlot;
+        chunkBuffers = std::move(prefetchedChunkBuffers);
+        chunkAdmissions = std::move(prefetchedChunkAdmissions);
+        prefetchedChunkAdmissions.clear();
+        prefetchedBufferSlot = -1;
+        prefetchedRGIdx = -1;
+        prefetchedTaskNum = 0;
+        return true;
+    }
+    readRowGroup(curRGIdx, bufferSlot, chunkBuffers, chunkAdmissions);
+    return true;
+}
+
+void PixelsRecordReaderImpl::prefetchNextRowGroup() {
+    int nextRGIdx = curRGIdx + 1;
+    if(physicalReader->supportsZeroCopy()) {
+        // the chunks are not copied into a slot, so the prefetch is only a hint to the page cache
+        if(nextRGIdx < targetRGNum && advisedRGIdx != nextRGIdx) {
+            adviseRowGroup(nextRGIdx);
+        }
+        return;
+    }
+    if(nextRGIdx >= targetRGNum || prefetchedRGIdx == nextRGIdx || bufferSlot < 0 ||
+       !ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io")) {
+        return;
+    }
+    // the prefetch is only worth a slot if the read is asynchronous
+    if(::BufferPool::GetFreeSlotNum() <= 0) {
+        return;
+    }
+    prefetchedRGIdx = nextRGIdx;
+    prefetchedTaskNum = readRowGroup(nextRGIdx, prefetchedBufferSlot, prefetchedChunkBuffers,
+                                     prefetchedChunkAdmissions);
+}
+
+void PixelsRecordReaderImpl::asyncReadCompleteCurrent() {
+    // the reads of the current row group are submitted before the prefetched ones, so
+    // they are the oldest requests of this file
+    if(has_async_task_num_ > prefetchedTaskNum) {
+        asyncReadComplete((int)(has_async_task_num_ - prefetchedTaskNum));
+    }
+    admitChunks(chunkAdmissions);
+}
+
+void PixelsRecordReaderImpl::admitChunks(std::vector<std::pair<std::string, std::shared_ptr<ByteBuffer>>> &admissions) {
+    for(auto &admission : admissions) {
+        ::PixelsChunkCache::Instance()->admit(admission.first, admission.second);
+    }
+    admissions.clear();
+}
+
+void PixelsRecordReaderImpl::adviseRowGroup(int rgIdx) {
+    const pixels::proto::RowGroupIndex& rowGroupIndex =
+            rowGroupFooters[rgIdx]->rowgroupindexentry();
+    for(int colId: targetColumns) {
+        const pixels::proto::ColumnChunkIndex& chunkIndex =
+                rowGroupIndex.columnchunkindexentries(colId);
+        physicalReader->willNeed((long)chunkIndex.chunkoffset(), (long)chunkIndex.chunklength());
+    }
+    advisedRGIdx = rgIdx;
+}
+
+uint32_t PixelsRecordReaderImpl::readRowGroup(int rgIdx, int &slot,
+                                              std::vector<std::shared_ptr<ByteBuffer>> &buffers,
+                                              std::vector<std::pair<std::string, std::shared_ptr<ByteBuffer>>> &admissions) {
+    uint32_t asyncTaskNum = 0;
     // read chunk offset and length of each target column chunks
 
     // TODO: this should remove later
-    chunkBuffers.clear();
-    chunkBuffers.resize(includedColumns.size());
+    buffers.clear();
+    buffers.resize(includedColumns.size());
     std::vector<ChunkId> diskChunks;
     diskChunks.reserve(targetColumns.size());
-
-
-    // TODO: support cache read
+    admissions.clear();
+    std::vector<std::string> chunkIds;
+    // the chunks read in place by the zero-copy readers are not worth caching
+    bool cacheEnabled = ::PixelsChunkCache::Instance()->isEnabled() && !physicalReader->supportsZeroCopy();
 
 	const pixels::proto::RowGroupIndex& rowGroupIndex =
-			rowGroupFooters[curRGIdx]->rowgroupindexentry();
+			rowGroupFooters[rgIdx]->rowgroupindexentry();
 	for(int colId: targetColumns) {
 		const pixels::proto::ColumnChunkIndex& chunkIndex =
 				rowGroupIndex.columnchunkindexentries(colId);
         if (!chunkIndex.littleendian()) {
             throw InvalidArgumentException("Pixels C++ reader only supports little endianness. ");
         }
-		ChunkId chunk(curRGIdx, colId, chunkIndex.chunkoffset(), chunkIndex.chunklength());
+        if(cacheEnabled) {
+            // the cached chunks are used directly, without going through the scheduler
+            std::string chunkId = ::PixelsChunkCache::chunkId(cacheFileId, targetRGs.at(rgIdx), colId);
+            auto cached = ::PixelsChunkCache::Instance()->get(chunkId);
+            if(cached != nullptr) {
+                buffers.at(colId) = cached;
+                continue;
+            }
+            chunkIds.emplace_back(chunkId);
+        }
+		ChunkId chunk(rgIdx, colId, chunkIndex.chunkoffset(), chunkIndex.chunklength());
 		diskChunks.emplace_back(chunk);
 	}
 
-
+	// the buffers of the slot may be too small for this row group, so a new slot is taken.
+	// The buffers of the same size class are reused by BufferPool
+	::BufferPool::ReleaseSlot(slot);
+	slot = -1;
     if(!diskChunks.empty()) {
         RequestBatch requestBatch((int)diskChunks.size());
         Scheduler * scheduler = SchedulerFactory::Instance()->getScheduler();
@@ -382,34 +552,54 @@ bool PixelsRecordReaderImpl::read() {
 		std::vector<uint64_t> bytes;
         for(int i = 0; i < diskChunks.size(); i++) {
             ChunkId chunk = diskChunks.at(i);
-            requestBatch.add(queryId, chunk.offset, (int)chunk.length, ::BufferPool::GetBufferId(i));
 			colIds.emplace_back(chunk.columnId);
 			bytes.emplace_back(chunk.length);
         }
-		::BufferPool::Initialize(colIds, bytes, fileSchema->getFieldNames());
-        ::DirectUringRandomAccessFile::RegisterBufferFromPool(colIds);
-		std::vector<std::shared_ptr<ByteBuffer>> originalByteBuffers;
-		for(int i = 0; i < colIds.size(); i++) {
-            auto colId = colIds.at(i);
-			originalByteBuffers.emplace_back(::BufferPool::GetBuffer(colId));
+		if(physicalReader->supportsZeroCopy()) {
+			// the chunks are read in place, so no slot is needed
+			if(advisedRGIdx != rgIdx) {
+				adviseRowGroup(rgIdx);
+			}
+		} else {
+			slot = ::BufferPool::AcquireSlot(colIds, bytes, fileSchema->getFieldNames());
+			// the buffers allocated for the slot are registered to the ring if it is idle
+			::DirectUringRandomAccessFile::RegisterBufferFromPool();
 		}
+		std::vector<std::shared_ptr<ByteBuffer>> originalByteBuffers;
+        for(int i = 0; i < diskChunks.size(); i++) {
+            ChunkId chunk = diskChunks.at(i);
+            if(slot >= 0) {
+                requestBatch.add(queryId, chunk.offset, (int)chunk.length, ::BufferPool::GetBufferId(slot, chunk.columnId));
+                originalByteBuffers.emplace_back(::BufferPool::GetBuffer(slot, chunk.columnId));
+            } else {
+                // no slot is available within the memory budget, fall back to the synchronous read
+                requestBatch.add(queryId, chunk.offset, (int)chunk.length);
+            }
+        }
 
 		auto byteBuffers = scheduler->executeBatch(physicalReader, requestBatch, originalByteBuffers, queryId);
 
       if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io") && originalByteBuffers.size() > 0) {
         has_async_task_num_ += diskChunks.size();
+        asyncTaskNum = (uint32_t)diskChunks.size();
       }
         for(int index = 0; index < diskChunks.size(); index++) {
             ChunkId chunk = diskChunks.at(index);
             std::shared_ptr<ByteBuffer> bb = byteBuffers.at(index);
             uint32_t colId = chunk.columnId;
             if(bb != nullptr) {
-                chunkBuffers.at(colId) = bb;
+                buffers.at(colId) = bb;
+                if(cacheEnabled) {
+                    admissions.emplace_back(chunkIds.at(index), bb);
+                }
             }
         }
+        // the chunks can only be copied into the cache after they are read
+        if(asyncTaskNum == 0) {
+            admitChunks(admissions);
+        }
     }
-    return true;
-
+    return asyncTaskNum;
 }
 
 PixelsRecordReaderImpl::~PixelsRecordReaderImpl() {
@@ -438,6 +628,20 @@ bool PixelsRecordReaderImpl::isEndOfFile() {
 }
 
 void PixelsRecordReaderImpl::close() {
+	// the buffer slot can only be reused after the pending reads into it are done
+	if(has_async_task_num_ > 0) {
+		asyncReadComplete((int)has_async_task_num_);
+	}
+	::BufferPool::ReleaseSlot(bufferSlot);
+	::BufferPool::ReleaseSlot(prefetchedBufferSlot);
+	bufferSlot = -1;
+	prefetchedBufferSlot = -1;
+	prefetchedRGIdx = -1;
+	prefetchedTaskNum = 0;
+	advisedRGIdx = -1;
+	prefetchedChunkBuffers.clear();
+	chunkAdmissions.clear();
+	prefetchedChunkAdmissions.clear();
 	// release chunk buffers
 	chunkBuffers.clear();
 	for(const auto& reader: readers) {
@@ -18,6 +18,7 @@ StringColumnReader::StringColumnReader(std::shared_ptr<TypeDescription> type) :
     dictStartsOffset = 0;
     dictStarts = nullptr;
     startsLength = 0;
+    dictionarySize = 0;
 }
 
 void StringColumnReader::close() {
@@ -41,6 +42,7 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
     int pixelId = elementIndex / pixelStride;
     bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
     setValid(input, pixelStride, vector, pixelId, hasNull);
+    columnVector->dictionary = nullptr;
 
     // TODO: if dictionary encoded
     if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_DICTIONARY) {
@@ -49,13 +51,43 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
             cascadeRLE = true;
         }
 
+        if (columnVector->encoding) {
+            // keep the dictionary ids instead of resolving the values. Reading the ids of the
+            // values that are filtered out costs about the same as skipping them.
+            columnVector->setDictionary(dictionary.data(), dictionarySize);
+            int * ids = reinterpret_cast<int *>(columnVector->dictIds) + vectorIndex;
+            if (cascadeRLE) {
+                contentDecoder->decodeInto<int32_t>(ids, size);
+            } else {
+                std::memcpy(ids, contentBuf->getPointer() + contentBuf->getReadPos(), size * sizeof(int));
+                contentBuf->setReadPos(contentBuf->getReadPos() + size * sizeof(int));
+            }
+            if (hasNull) {
+                for (int i = 0; i < size; i++) {
+                    if (!vector->checkValid(i)) {
+                        ids[i] = dictionarySize;
+                    }
+                }
+            }
+            elementIndex += size;
+            return;
+        }
+
         for(int i = 0; i < size; i++) {
-            bool valid = vector->checkValid(i);
-            if(elementIndex % pixelStride == 0) {
-                int pixelId = elementIndex / pixelStride;
-                // TODO: should write the remaining code
+            if(filterMask != nullptr && !filterMask->get(i)) {
+                // late materialization: skip the ids of the values that are filtered out
+                int next = (int) filterMask->nextSetBit(i, size);
+                if (cascadeRLE) {
+                    contentDecoder->skip(next - i);
+                } else {
+                    contentBuf->setReadPos(contentBuf->getReadPos() + (next - i) * sizeof(int));
+                }
+                elementIndex += next - i;
+                i = next - 1;
+                continue;
             }
-            if(vector->checkValid(i) && (filterMask == nullptr || filterMask->get(i))) {
+            bool valid = vector->checkValid(i);
+            if(valid) {
                 int originId = cascadeRLE ? (int) contentDecoder->next() : contentBuf->getInt();
                 int tmpLen = dictStarts[originId + 1] - dictStarts[originId];
                 // use setRef instead of setVal to reduce memory copy.
@@ -64,7 +96,7 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
                 // is null: skip this number
                 contentBuf->getInt();
             } else {
-                // filter out: skip this number
+                // is null: skip this number
                 if (!cascadeRLE) {
                     contentBuf->getInt();
                 } else {
@@ -104,6 +136,45 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
     }
 }
 
+void StringColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding & encoding, int offset,
+                              int size, int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex) {
+    if(offset == 0) {
+        elementIndex = 0;
+        bufferOffset = 0;
+        isNullOffset = chunkIndex.isnulloffset();
+        readContent(input, input->bytesRemaining(), encoding);
+    }
+
+    int pixelId = elementIndex / pixelStride;
+    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
+    // the isNull bitmap of this pixel, a set bit means the value is null
+    const uint8_t * isNull = hasNull ? input->getPointer() + isNullOffset : nullptr;
+    skipValid(pixelStride, size, hasNull);
+
+    if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_DICTIONARY) {
+        bool cascadeRLE = false;
+        if (encoding.has_cascadeencoding() && encoding.cascadeencoding().kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+            cascadeRLE = true;
+        }
+        // keep consistent with read(): one id is consumed for each element
+        if (cascadeRLE) {
+            contentDecoder->skip(size);
+        } else {
+            contentBuf->setReadPos(contentBuf->getReadPos() + size * sizeof(int));
+        }
+    } else {
+        for(int i = 0; i < size; i++) {
+            bool valid = isNull == nullptr || !(isNull[i / 8] & (1 << (i % 8)));
+            currentStart = nextStart;
+            nextStart = startsBuf->getInt();
+            if(valid) {
+                bufferOffset += nextStart - currentStart;
+            }
+        }
+    }
+    elementIndex += size;
+}
+
 void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
                                      uint32_t inputLength,
                                      pixels::proto::ColumnEncoding & encoding) {
@@ -121,6 +192,9 @@ void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
 		startsBuf = std::make_shared<ByteBuffer>(
 		    *input, dictStartsOffset, startsBufLength);
 		int bufferStart = 0;
+		if (dictStarts != nullptr) {
+			delete[] dictStarts;
+		}
 
         if (encoding.has_cascadeencoding() && encoding.cascadeencoding().kind() == pixels::proto::ColumnEncoding_Kind::ColumnEncoding_Kind_RUNLENGTH) {
             std::shared_ptr<RunLenIntDecoder> startsDecoder =
@@ -146,6 +220,7 @@ void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
             {
                 throw new InvalidArgumentException("the dictionary size is inconsistent with the size of the starts array");
             }
+            startsLength = startsSize;
             dictStarts = new int[startsSize];
             for (int i = 0; i < startsSize; ++i)
             {
@@ -153,6 +228,14 @@ void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
             }
             contentDecoder = nullptr;
         }
+        // the dictionary entries for the encoded column vectors, followed by the null entry
+        dictionarySize = startsLength - 1;
+        dictionary.resize(dictionarySize + 1);
+        for (int i = 0; i < dictionarySize; i++) {
+            dictionary[i] = duckdb::string_t((char *) dictContentBuf->getPointer() + dictStarts[i],
+                                             dictStarts[i + 1] - dictStarts[i]);
+        }
+        dictionary[dictionarySize] = duckdb::string_t("", 0);
     } else {
         input->markReaderIndex();
         input->skipBytes(inputLength - sizeof(int));
@@ -30,15 +30,45 @@ void TimestampColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::prot
     setValid(input, pixelStride, vector, pixelId, hasNull);
 
     if(encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
-        for (int i = 0; i < size; i++) {
-            if (elementIndex % pixelStride == 0) {
-                int pixelId = elementIndex / pixelStride;
+        int i = 0;
+        while (i < size) {
+            if (filterMask != nullptr && !filterMask->get(i)) {
+                // late materialization: skip the values that are filtered out
+                int next = (int) filterMask->nextSetBit(i, size);
+                decoder->skip(next - i);
+                elementIndex += next - i;
+                i = next;
+                continue;
             }
-            columnVector->set(i + vectorIndex, decoder->next());
-            elementIndex++;
+            // decode the values up to the next filtered out one in bulk
+            int end = filterMask == nullptr ? size : (int) filterMask->nextClearBit(i, size);
+            decoder->decode(columnVector->times + i + vectorIndex, end - i);
+            elementIndex += end - i;
+            i = end;
         }
     } else {
         columnVector->times = (int64_t *)(input->getPointer() + input->getReadPos());
         input->setReadPos(input->getReadPos() + size * sizeof(int64_t));
+        elementIndex += size;
     }
 }
+
+void TimestampColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding &encoding, int offset,
+                                 int size, int pixelStride, pixels::proto::ColumnChunkIndex &chunkIndex) {
+    if(offset == 0) {
+        decoder = std::make_shared<RunLenIntDecoder>(input, true);
+        ColumnReader::elementIndex = 0;
+        isNullOffset = chunkIndex.isnulloffset();
+    }
+
+    int pixelId = elementIndex / pixelStride;
+    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
+    skipValid(pixelStride, size, hasNull);
+
+    if(encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+        decoder->skip(size);
+    } else {
+        input->setReadPos(input->getReadPos() + size * sizeof(int64_t));
+    }
+    elementIndex += size;
+}
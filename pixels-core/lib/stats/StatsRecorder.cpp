@@ -23,11 +23,19 @@
 //
 
 #include "stats/StatsRecorder.h"
+#include "utils/CpuFeatures.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <immintrin.h>
 #include <stdexcept>
 
 
 StatsRecorder::StatsRecorder() : numberOfValues(0), hasNull(false) {}
 
+StatsRecorder::StatsRecorder(TypeDescription::Category category)
+        : numberOfValues(0), hasNull(false), category(category) {}
+
 
 StatsRecorder::StatsRecorder(const pixels::proto::ColumnStatistic& statistic)
         : numberOfValues(statistic.has_numberofvalues() ? statistic.numberofvalues() : 0),
@@ -89,6 +97,95 @@ void StatsRecorder::updateVector() {
     throw std::logic_error("Can't update vector");
 }
 
+namespace {
+/**
+ * Fold the values in chunks of 4 into the minimum, maximum and sum with AVX2. It is only called
+ * if CpuFeatures::HasAvx2().
+ *
+ * @return the index of the first value that has not been folded
+ */
+__attribute__((target("avx2")))
+int foldIntegersAvx2(const long *values, const uint8_t *isNull, int length,
+                     long &batchMin, long &batchMax, long &batchSum, bool &overflow) {
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i minValues = _mm256_set1_epi64x(LONG_MAX);
+    __m256i maxValues = _mm256_set1_epi64x(LONG_MIN);
+    __m256i sums = zero;
+    __m256i overflows = zero;
+    int i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (values + i));
+        __m256i valid = _mm256_cmpeq_epi64(zero, zero);
+        if (isNull != nullptr) {
+            int32_t word;
+            memcpy(&word, isNull + i, sizeof(word));
+            valid = _mm256_cmpeq_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128(word)), zero);
+        }
+        minValues = _mm256_blendv_epi8(minValues, v, _mm256_and_si256(valid, _mm256_cmpgt_epi64(minValues, v)));
+        maxValues = _mm256_blendv_epi8(maxValues, v, _mm256_and_si256(valid, _mm256_cmpgt_epi64(v, maxValues)));
+        __m256i addend = _mm256_and_si256(v, valid);
+        __m256i result = _mm256_add_epi64(sums, addend);
+        // the addition overflows if the sign of the result differs from the signs of both operands
+        overflows = _mm256_or_si256(overflows, _mm256_and_si256(_mm256_xor_si256(result, sums),
+                                                                _mm256_xor_si256(result, addend)));
+        sums = result;
+    }
+    long laneMin[4], laneMax[4], laneSum[4], laneOverflow[4];
+    _mm256_storeu_si256((__m256i *) laneMin, minValues);
+    _mm256_storeu_si256((__m256i *) laneMax, maxValues);
+    _mm256_storeu_si256((__m256i *) laneSum, sums);
+    _mm256_storeu_si256((__m256i *) laneOverflow, overflows);
+    for (int lane = 0; lane < 4; lane++) {
+        batchMin = std::min(batchMin, laneMin[lane]);
+        batchMax = std::max(batchMax, laneMax[lane]);
+        overflow |= laneOverflow[lane] < 0;
+        overflow |= __builtin_add_overflow(batchSum, laneSum[lane], &batchSum);
+    }
+    return i;
+}
+}
+
+void StatsRecorder::updateIntegers(const long *values, const uint8_t *isNull, int length) {
+    long batchMin = LONG_MAX;
+    long batchMax = LONG_MIN;
+    long batchSum = 0;
+    bool overflow = false;
+    int i = 0;
+    if (CpuFeatures::HasAvx2()) {
+        i = foldIntegersAvx2(values, isNull, length, batchMin, batchMax, batchSum, overflow);
+    }
+    for (; i < length; i++) {
+        if (isNull != nullptr && isNull[i]) {
+            continue;
+        }
+        batchMin = std::min(batchMin, values[i]);
+        batchMax = std::max(batchMax, values[i]);
+        overflow |= __builtin_add_overflow(batchSum, values[i], &batchSum);
+    }
+
+    long valueNum = length;
+    if (isNull != nullptr) {
+        for (int j = 0; j < length; j++) {
+            valueNum -= isNull[j] != 0;
+        }
+    }
+    if (valueNum == 0) {
+        return;
+    }
+    numberOfValues += valueNum;
+    if (!hasRange) {
+        hasRange = true;
+        minimum = batchMin;
+        maximum = batchMax;
+        sum = batchSum;
+        sumOverflow = overflow;
+    } else {
+        minimum = std::min(minimum, batchMin);
+        maximum = std::max(maximum, batchMax);
+        sumOverflow |= overflow || __builtin_add_overflow(sum, batchSum, &sum);
+    }
+}
+
 bool StatsRecorder::isStatsExists() const {
     return (numberOfValues > 0 || hasNull);
 }
@@ -97,12 +194,31 @@ bool StatsRecorder::isStatsExists() const {
 void StatsRecorder::merge(const StatsRecorder& stats) {
     numberOfValues += stats.numberOfValues;
     hasNull |= stats.hasNull;
+    if (!stats.hasRange) {
+        return;
+    }
+    if (!hasRange) {
+        hasRange = true;
+        minimum = stats.minimum;
+        maximum = stats.maximum;
+        sum = stats.sum;
+        sumOverflow = stats.sumOverflow;
+    } else {
+        minimum = std::min(minimum, stats.minimum);
+        maximum = std::max(maximum, stats.maximum);
+        sumOverflow |= stats.sumOverflow || __builtin_add_overflow(sum, stats.sum, &sum);
+    }
 }
 
 
 void StatsRecorder::reset() {
     numberOfValues = 0;
     hasNull = false;
+    hasRange = false;
+    minimum = 0;
+    maximum = 0;
+    sum = 0;
+    sumOverflow = false;
 }
 
 
@@ -115,6 +231,25 @@ pixels::proto::ColumnStatistic StatsRecorder::serialize() const {
     pixels::proto::ColumnStatistic statistic;
     statistic.set_numberofvalues(numberOfValues);
     statistic.set_hasnull(hasNull);
+    if (hasRange) {
+        switch (category) {
+            case TypeDescription::DATE:
+                statistic.mutable_datestatistics()->set_minimum((int) minimum);
+                statistic.mutable_datestatistics()->set_maximum((int) maximum);
+                break;
+            case TypeDescription::TIMESTAMP:
+                statistic.mutable_timestampstatistics()->set_minimum(minimum);
+                statistic.mutable_timestampstatistics()->set_maximum(maximum);
+                break;
+            default:
+                statistic.mutable_intstatistics()->set_minimum(minimum);
+                statistic.mutable_intstatistics()->set_maximum(maximum);
+                if (!sumOverflow) {
+                    statistic.mutable_intstatistics()->set_sum(sum);
+                }
+                break;
+        }
+    }
     return statistic;
 }
 
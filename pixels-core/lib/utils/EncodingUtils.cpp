@@ -3,6 +3,10 @@
 //
 
 #include "utils/EncodingUtils.h"
+#include "utils/CpuFeatures.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cstring>
 
 int EncodingUtils::BUFFER_SIZE = 64;
 
@@ -166,10 +170,18 @@ void EncodingUtils::unrolledUnPackBytes(long *buffer, int offset, int len,
                                         const std::shared_ptr<ByteBuffer> &input,
                                         int numBytes) {
     int numHops = 8;
-    int remainder = len % numHops;
     int endOffset = offset + len;
-    int endUnroll = endOffset - remainder;
     int i = offset;
+    bool simd = CpuFeatures::HasAvx2();
+    if (simd && (numBytes == 1 || numBytes == 2 || numBytes == 4 || numBytes == 8)) {
+        int available = std::min(len, (int) (input->bytesRemaining() / numBytes));
+        int unpacked = unPackBytesAvx2(buffer + offset,
+                                       input->getPointer() + input->getReadPos(), available, numBytes);
+        input->skipBytes(unpacked * numBytes);
+        i += unpacked;
+    }
+    int remainder = (endOffset - i) % numHops;
+    int endUnroll = endOffset - remainder;
     for (; i < endUnroll; i = i + numHops) {
         readLongBE(input, buffer, i, numHops, numBytes);
     }
@@ -179,6 +191,51 @@ void EncodingUtils::unrolledUnPackBytes(long *buffer, int offset, int len,
     }
 }
 
+__attribute__((target("avx2")))
+int EncodingUtils::unPackBytesAvx2(long *buffer, const uint8_t *data, int len, int numBytes) {
+    // each step converts 4 big endian values, reading exactly 4 * numBytes bytes
+    int i = 0;
+    switch (numBytes) {
+        case 1:
+            for (; i + 4 <= len; i += 4) {
+                int32_t word;
+                memcpy(&word, data + i, sizeof(word));
+                _mm256_storeu_si256((__m256i *) (buffer + i), _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(word)));
+            }
+            break;
+        case 2: {
+            const __m128i swap16 = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+            for (; i + 4 <= len; i += 4) {
+                __m128i values = _mm_loadl_epi64((const __m128i *) (data + i * 2));
+                values = _mm_shuffle_epi8(values, swap16);
+                _mm256_storeu_si256((__m256i *) (buffer + i), _mm256_cvtepu16_epi64(values));
+            }
+            break;
+        }
+        case 4: {
+            const __m128i swap32 = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+            for (; i + 4 <= len; i += 4) {
+                __m128i values = _mm_loadu_si128((const __m128i *) (data + i * 4));
+                values = _mm_shuffle_epi8(values, swap32);
+                _mm256_storeu_si256((__m256i *) (buffer + i), _mm256_cvtepu32_epi64(values));
+            }
+            break;
+        }
+        case 8: {
+            const __m256i swap64 = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                                    7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+            for (; i + 4 <= len; i += 4) {
+                __m256i values = _mm256_loadu_si256((const __m256i *) (data + i * 8));
+                _mm256_storeu_si256((__m256i *) (buffer + i), _mm256_shuffle_epi8(values, swap64));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return i;
+}
+
 void EncodingUtils::readLongBE(const std::shared_ptr<ByteBuffer> &input, long *buffer, int start, int numHops,
                                int numBytes) {
     int toRead = numHops * numBytes;
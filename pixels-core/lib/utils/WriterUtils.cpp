@@ -0,0 +1,65 @@
+#include "utils/WriterUtils.h"
+#include <cstring>
+
+// the loops are kept free of branches, so that they are vectorized by the compiler
+namespace {
+template <typename T>
+int gatherValues(long *pixel, const T *values, const uint8_t *isNull, int length, bool nullsPadding) {
+    int nullNum = 0;
+    for (int i = 0; i < length; i++) {
+        nullNum += isNull[i] != 0;
+    }
+    if (nullNum == 0) {
+        for (int i = 0; i < length; i++) {
+            pixel[i] = values[i];
+        }
+    } else if (nullsPadding) {
+        for (int i = 0; i < length; i++) {
+            // the mask is 0 for the nulls, so that they are padded with 0
+            pixel[i] = (long) values[i] & -(long) (isNull[i] == 0);
+        }
+    } else {
+        int valueNum = 0;
+        for (int i = 0; i < length; i++) {
+            // the value is always stored, and a null is overwritten by the next value
+            pixel[valueNum] = values[i];
+            valueNum += isNull[i] == 0;
+        }
+    }
+    return length - nullNum;
+}
+}
+
+int WriterUtils::gather(long *pixel, const long *values, const uint8_t *isNull, int length, bool nullsPadding) {
+    return gatherValues(pixel, values, isNull, length, nullsPadding);
+}
+
+int WriterUtils::gather(long *pixel, const int *values, const uint8_t *isNull, int length, bool nullsPadding) {
+    return gatherValues(pixel, values, isNull, length, nullsPadding);
+}
+
+void WriterUtils::encodeLongs(uint8_t *output, const long *values, int length, ByteOrder byteOrder) {
+    // the hosts are little endian
+    if (byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN) {
+        memcpy(output, values, length * sizeof(long));
+        return;
+    }
+    for (int i = 0; i < length; i++) {
+        uint64_t value = __builtin_bswap64((uint64_t) values[i]);
+        memcpy(output + i * sizeof(long), &value, sizeof(long));
+    }
+}
+
+void WriterUtils::encodeInts(uint8_t *output, const long *values, int length, ByteOrder byteOrder) {
+    if (byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN) {
+        for (int i = 0; i < length; i++) {
+            auto value = (uint32_t) values[i];
+            memcpy(output + i * sizeof(int), &value, sizeof(int));
+        }
+    } else {
+        for (int i = 0; i < length; i++) {
+            uint32_t value = __builtin_bswap32((uint32_t) values[i]);
+            memcpy(output + i * sizeof(int), &value, sizeof(int));
+        }
+    }
+}
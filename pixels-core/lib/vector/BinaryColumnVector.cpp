@@ -8,6 +8,9 @@ BinaryColumnVector::BinaryColumnVector(uint64_t len, bool encoding): ColumnVecto
     posix_memalign(reinterpret_cast<void **>(&vector), 32,
                    len * sizeof(duckdb::string_t));
     memoryUsage += (long) sizeof(uint8_t) * len;
+    dictIds = nullptr;
+    dictionary = nullptr;
+    dictionarySize = 0;
 }
 
 void BinaryColumnVector::close() {
@@ -15,6 +18,11 @@ void BinaryColumnVector::close() {
 		ColumnVector::close();
 		free(vector);
 		vector = nullptr;
+		if(dictIds != nullptr) {
+			free(dictIds);
+			dictIds = nullptr;
+		}
+		dictionary = nullptr;
 
 	}
 }
@@ -30,6 +38,15 @@ void BinaryColumnVector::setRef(int elementNum, uint8_t * const &sourceBuf, int
 
 }
 
+void BinaryColumnVector::setDictionary(duckdb::string_t * dictionary, int dictionarySize) {
+    if(dictIds == nullptr) {
+        posix_memalign(reinterpret_cast<void **>(&dictIds), 32, length * sizeof(uint32_t));
+        memoryUsage += (long) sizeof(uint32_t) * length;
+    }
+    this->dictionary = dictionary;
+    this->dictionarySize = dictionarySize;
+}
+
 void BinaryColumnVector::print(int rowCount) {
 	throw InvalidArgumentException("not support print binarycolumnvector.");
 }
@@ -63,6 +80,15 @@ void BinaryColumnVector::add(uint8_t *v,int len) {
     setVal(writeIndex++,v,0,len);
 }
 
+void BinaryColumnVector::add(const char *value, size_t size) {
+    if(writeIndex>=getLength()) {
+        ensureSize(writeIndex*2,true);
+    }
+    int index = writeIndex++;
+    vector[index] = duckdb::string_t(value, size);
+    isNull[index] = false;
+}
+
 void BinaryColumnVector::setVal(int elemnetNum, uint8_t *sourceBuf,int start,int length) {
 
 }
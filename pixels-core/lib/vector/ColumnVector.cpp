@@ -93,6 +93,11 @@ void ColumnVector::add(std::string &value) {
     throw new std::runtime_error("Adding string is not supported");
 }
 
+void ColumnVector::add(const char *value, size_t size) {
+    std::string text(value, size);
+    add(text);
+}
+
 void ColumnVector::add(bool value) {
     throw new std::runtime_error("Adding boolean is not supported");
 }
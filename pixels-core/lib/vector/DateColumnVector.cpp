@@ -3,6 +3,7 @@
 //
 
 #include "vector/DateColumnVector.h"
+#include "utils/TextParser.h"
 #include <algorithm>
 #include <ctime>       
 #include <iomanip>    
@@ -109,6 +110,20 @@ void DateColumnVector::add(std::string &value) {
 	}
 }
 
+void DateColumnVector::add(const char *value, size_t size) {
+	int days;
+	if (!TextParser::parseDate(value, size, days)) {
+		ColumnVector::add(value, size);
+		return;
+	}
+	if (writeIndex >= length) {
+		ensureSize(writeIndex * 2, true);
+	}
+	int index = writeIndex++;
+	dates[index] = days;
+	isNull[index] = false;
+}
+
 void DateColumnVector::add(bool value) {
 	std::cout << "Adding bool value: " << value << std::endl;
     add(value ? 1 : 0);
@@ -3,6 +3,7 @@
 //
 
 #include "vector/DecimalColumnVector.h"
+#include "utils/TextParser.h"
 #include "duckdb/common/types/decimal.hpp"
 #include <iostream>
 #include <string>
@@ -142,6 +143,20 @@ void DecimalColumnVector::add(std::string &value) {
     }
 }
 
+void DecimalColumnVector::add(const char *value, size_t size) {
+    int64_t v;
+    if (!TextParser::parseDecimal(value, size, scale, v)) {
+        ColumnVector::add(value, size);
+        return;
+    }
+    if (writeIndex >= length) {
+        ensureSize(writeIndex * 2, true);
+    }
+    int index = writeIndex++;
+    vector[index] = v;
+    isNull[index] = false;
+}
+
 void DecimalColumnVector::add(bool value) {
     std::cout << "add bool value:" << value << std::endl;
     add(value ? 1 : 0);
@@ -3,6 +3,7 @@
 //
 
 #include "vector/LongColumnVector.h"
+#include "utils/TextParser.h"
 #include <algorithm>
 
 LongColumnVector::LongColumnVector(uint64_t len, bool encoding, bool isLong): ColumnVector(len, encoding) {
@@ -59,7 +60,8 @@ void * LongColumnVector::current() {
         if(intVector == nullptr) {
             return nullptr;
         } else {
-            return intVector + readIndex;
+            // the reader packs int values as int32 into intVector
+            return reinterpret_cast<int *>(intVector) + readIndex;
         }
     }
 }
@@ -75,6 +77,18 @@ void LongColumnVector::add(std::string &value) {
     }
 }
 
+void LongColumnVector::add(const char *value, size_t size) {
+    int64_t v;
+    bool b;
+    if (TextParser::parseLong(value, size, v)) {
+        add(v);
+    } else if (TextParser::parseBool(value, size, b)) {
+        add(b);
+    } else {
+        ColumnVector::add(value, size);
+    }
+}
+
 void LongColumnVector::add(bool value) {
     add(value ? 1 : 0);
 }
@@ -87,7 +101,7 @@ void LongColumnVector::add(int64_t value) {
     if(isLong) {
         longVector[index] = value;
     } else {
-        intVector[index] = value;
+        reinterpret_cast<int *>(intVector)[index] = (int) value;
     }
     isNull[index] = false;
 }
@@ -100,7 +114,7 @@ void LongColumnVector::add(int value) {
     if(isLong) {
         longVector[index] = value;
     } else {
-        intVector[index] = value;
+        reinterpret_cast<int *>(intVector)[index] = (int) value;
     }
     isNull[index] = false;
 }
@@ -123,7 +137,8 @@ void LongColumnVector::ensureSize(uint64_t size, bool preserveData) {
             posix_memalign(reinterpret_cast<void **>(&intVector), 32,
                            size * sizeof(int32_t));
             if (preserveData) {
-                std::copy(oldVector, oldVector + length, intVector);
+                std::copy(reinterpret_cast<int *>(oldVector), reinterpret_cast<int *>(oldVector) + length,
+                          reinterpret_cast<int *>(intVector));
             }
             delete[] oldVector;
             memoryUsage += (long) sizeof(int) * (size - length);
@@ -9,6 +9,7 @@
 #include <ctime>
 #include <stdexcept>
 #include "vector/TimestampColumnVector.h"
+#include "utils/TextParser.h"
 
 TimestampColumnVector::TimestampColumnVector(int precision, bool encoding): ColumnVector(VectorizedRowBatch::DEFAULT_SIZE, encoding) {
     TimestampColumnVector(VectorizedRowBatch::DEFAULT_SIZE, precision, encoding);
@@ -140,6 +141,21 @@ void TimestampColumnVector::add(std::string &value) {
     }
 }
 
+void TimestampColumnVector::add(const char *value, size_t size) {
+    if (precision == 0) precision = 6;
+    int64_t v;
+    if (!TextParser::parseTimestamp(value, size, precision, v)) {
+        ColumnVector::add(value, size);
+        return;
+    }
+    if (writeIndex >= length) {
+        ensureSize(writeIndex * 2, true);
+    }
+    int index = writeIndex++;
+    times[index] = v;
+    isNull[index] = false;
+}
+
 void TimestampColumnVector::add(long value) {
     std::cout << "Adding long value: " << value << std::endl;
 
@@ -99,6 +99,7 @@ void VectorizedRowBatch::reset() {
     }
     rowCount = 0;
     current = 0;
+    heldBuffers.clear();
 }
 
 void VectorizedRowBatch::resize(int size) {
@@ -118,3 +119,21 @@ void VectorizedRowBatch::increment(int size) {
 uint64_t VectorizedRowBatch::remaining() {
     return rowCount - current;
 }
+
+void VectorizedRowBatch::addTextRow(const TextField *fields, int fieldNum) {
+    for (int i = 0; i < numCols; ++i) {
+        if (i >= fieldNum || fields[i].length == 0 ||
+            (fields[i].length == 2 && fields[i].data[0] == '\\' && fields[i].data[1] == 'N')) {
+            cols[i]->addNull();
+        } else {
+            cols[i]->add(fields[i].data, fields[i].length);
+        }
+    }
+    rowCount++;
+}
+
+void VectorizedRowBatch::holdBuffer(const std::shared_ptr<ByteBuffer> &buffer) {
+    if (heldBuffers.empty() || heldBuffers.back() != buffer) {
+        heldBuffers.push_back(buffer);
+    }
+}
@@ -66,6 +66,8 @@ void ColumnWriter::flush() {
         isNullOffset += alignBytes;
     }
     columnChunkIndex->set_isnulloffset(isNullOffset);
+    // the subclasses decide nullsPadding after the chunk index is created
+    columnChunkIndex->set_nullspadding(nullsPadding);
     outputStream->putBytes(isNullStream->getPointer() + isNullStream->getReadPos(), isNullStream->getWritePos() - isNullStream->getReadPos());
 }
 
@@ -93,10 +95,25 @@ void ColumnWriter::newPixel() {
     hasNull = false;
 }
 
+pixels::proto::ColumnStatistic ColumnWriter::getColumnChunkStat() {
+    return columnChunkStatRecorder.serialize();
+}
+
+const StatsRecorder& ColumnWriter::getColumnChunkStatRecorder() const {
+    return columnChunkStatRecorder;
+}
+
 void ColumnWriter::reset() {
     lastPixelPosition = 0;
     curPixelPosition = 0;
+    curPixelEleIndex = 0;
+    curPixelVectorIndex = 0;
+    curPixelIsNullIndex = 0;
+    hasNull = false;
     columnChunkIndex->Clear();
+    columnChunkIndex->set_littleendian(byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN);
+    columnChunkIndex->set_nullspadding(nullsPadding);
+    columnChunkIndex->set_isnullalignment(ISNULL_ALIGNMENT);
     columnChunkStat->Clear();
     pixelStatRecorder.reset();
     columnChunkStatRecorder.reset();
@@ -115,6 +132,8 @@ ColumnWriter::ColumnWriter(std::shared_ptr<TypeDescription> type,
                                    std::shared_ptr<PixelsWriterOption> writerOption)
         : pixelStride(writerOption->getPixelsStride()),
           encodingLevel(writerOption->getEncodingLevel()),
+          pixelStatRecorder(type->getCategory()),
+          columnChunkStatRecorder(type->getCategory()),
           byteOrder(writerOption->getByteOrder()),
           nullsPadding(false),// default is false
           isNull(pixelStride, false)
@@ -123,7 +142,9 @@ ColumnWriter::ColumnWriter(std::shared_ptr<TypeDescription> type,
     outputStream=std::make_shared<ByteBuffer>();
     isNullStream=std::make_shared<ByteBuffer>();
     columnChunkIndex=std::make_shared<pixels::proto::ColumnChunkIndex>();
+    columnChunkStat=std::make_shared<pixels::proto::ColumnStatistic>();
     columnChunkIndex->set_littleendian(byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN);
     columnChunkIndex->set_nullspadding(nullsPadding);
     columnChunkIndex->set_isnullalignment(ISNULL_ALIGNMENT);
+    encodingBuffer.resize(pixelStride * sizeof(long));
 }
\ No newline at end of file
@@ -20,6 +20,7 @@
 
 #include "writer/DateColumnWriter.h"
 #include "utils/BitUtils.h"
+#include "utils/WriterUtils.h"
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -33,8 +34,6 @@ DateColumnWriter::DateColumnWriter(std::shared_ptr<TypeDescription> type, std::s
 }
 
 int DateColumnWriter::write(std::shared_ptr<ColumnVector> vector, int size) {
-    std::cout << "In DateColumnWriter" << std::endl;
-    
     auto columnVector = std::static_pointer_cast<DateColumnVector>(vector);
     if (!columnVector) {
         throw std::invalid_argument("Invalid vector type");
@@ -67,19 +66,26 @@ void DateColumnWriter::close() {
     ColumnWriter::close();
 }
 
+void DateColumnWriter::reset() {
+    ColumnWriter::reset();
+    if (runlengthEncoding) {
+        encoder->clear();
+    }
+}
+
 void DateColumnWriter::writeCurPartTime(std::shared_ptr<ColumnVector> columnVector, int* values, int curPartLength, int curPartOffset) {
-    for (int i = 0; i < curPartLength; i++) {
-        curPixelEleIndex++;
-        if (columnVector->isNull[i + curPartOffset]) {
-            hasNull = true;
-            if (nullsPadding) {
-                // 如果是 null，填充 0
-                curPixelVector[curPixelVectorIndex++] = 0L;
-            }
-        } else {
-            curPixelVector[curPixelVectorIndex++] = values[i + curPartOffset];
-        }
+    const uint8_t *nulls = columnVector->isNull + curPartOffset;
+    long *pixel = curPixelVector.data() + curPixelVectorIndex;
+    int valueNum = WriterUtils::gather(pixel, values + curPartOffset, nulls, curPartLength, nullsPadding);
+    if (nullsPadding) {
+        pixelStatRecorder.updateIntegers(pixel, nulls, curPartLength);
+        curPixelVectorIndex += curPartLength;
+    } else {
+        pixelStatRecorder.updateIntegers(pixel, nullptr, valueNum);
+        curPixelVectorIndex += valueNum;
     }
+    hasNull |= valueNum < curPartLength;
+    curPixelEleIndex += curPartLength;
 
     std::copy(columnVector->isNull + curPartOffset, columnVector->isNull + curPartOffset + curPartLength, isNull.begin() + curPixelIsNullIndex);
     curPixelIsNullIndex += curPartLength;
@@ -95,20 +101,12 @@ bool DateColumnWriter::decideNullsPadding(std::shared_ptr<PixelsWriterOption> wr
 void DateColumnWriter::newPixel() {
     // 将当前的像素向量写入输出流
     if (runlengthEncoding) {
-        std::vector<byte> buffer(curPixelVectorIndex * sizeof(int));
-        int resLen;
-        encoder->encode(curPixelVector.data(), buffer.data(), curPixelVectorIndex, resLen);
-        outputStream->putBytes(buffer.data(), resLen);
+        encoder->encode(curPixelVector.data(), curPixelVectorIndex, outputStream);
     } else {
-        std::shared_ptr<ByteBuffer> curVecPartitionBuffer;
-        EncodingUtils encodingUtils;
-        curVecPartitionBuffer = std::make_shared<ByteBuffer>(curPixelVectorIndex * sizeof(int));
-
-        for (int i = 0; i < curPixelVectorIndex; i++) {
-            encodingUtils.writeIntLE(curVecPartitionBuffer, (int)curPixelVector[i]);
-        }
-
-        outputStream->putBytes(curVecPartitionBuffer->getPointer(), curVecPartitionBuffer->getWritePos());
+        // the dates are always written in little endian
+        WriterUtils::encodeInts(encodingBuffer.data(), curPixelVector.data(), curPixelVectorIndex,
+                                ByteOrder::PIXELS_LITTLE_ENDIAN);
+        outputStream->putBytes(encodingBuffer.data(), curPixelVectorIndex * sizeof(int));
     }
 
     ColumnWriter::newPixel();
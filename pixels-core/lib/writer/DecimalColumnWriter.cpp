@@ -19,52 +19,61 @@
  */
 #include "writer/DecimalColumnWriter.h"
 #include "utils/BitUtils.h"
+#include "utils/WriterUtils.h"
 
 DecimalColumnWriter::DecimalColumnWriter(std::shared_ptr<TypeDescription> type, std::shared_ptr<PixelsWriterOption> writerOption)
-    : ColumnWriter(type, writerOption) {}
+    : ColumnWriter(type, writerOption), curPixelVector(pixelStride) {}
 
 int DecimalColumnWriter::write(std::shared_ptr<ColumnVector> vector, int length) {
-    std::cout << "In DecimalColumnWriter" << std::endl;
-
     // 转换为 DecimalColumnVector 类型
     auto columnVector = std::static_pointer_cast<DecimalColumnVector>(vector);
     if (!columnVector) {
         throw std::invalid_argument("Invalid vector type");
     }
 
-    long* values = columnVector->vector;  
-    std::shared_ptr<ByteBuffer> littleEndian;
-    EncodingUtils encodingUtils;
-
-    for (int i = 0; i < length; i++) {
-        isNull[curPixelIsNullIndex++] = vector->isNull[i]; 
-        curPixelEleIndex++;
+    long* values = columnVector->vector;
+    int curPartLength;
+    int curPartOffset = 0;
+    int nextPartLength = length;
 
-        littleEndian = std::make_shared<ByteBuffer>(sizeof(long));  
+    // 计算分区以适应像素的需求
+    while ((curPixelIsNullIndex + nextPartLength) >= pixelStride) {
+        curPartLength = pixelStride - curPixelIsNullIndex;
+        writeCurPartDecimal(columnVector, values, curPartLength, curPartOffset);
+        newPixel();
+        curPartOffset += curPartLength;
+        nextPartLength = length - curPartOffset;
+    }
 
-        if (vector->isNull[i]) {
-            hasNull = true;
-            if (nullsPadding) {
-                // 如果是空值，且启用了填充，则填充 0
-                encodingUtils.writeLongLE(littleEndian, 0L);
-            }
-        } else {
-            // 如果不是空值，按字节序写入数据
-            if (byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN) {
-                encodingUtils.writeLongLE(littleEndian, values[i]);
-            } else {
-                encodingUtils.writeLongBE(littleEndian, values[i]);
-            }
-        }
+    curPartLength = nextPartLength;
+    writeCurPartDecimal(columnVector, values, curPartLength, curPartOffset);
 
-        outputStream->putBytes(littleEndian->getPointer(), littleEndian->getWritePos());
+    return outputStream->getWritePos();
+}
 
-        if (curPixelEleIndex >= pixelStride) {
-            ColumnWriter::newPixel();
-        }
+void DecimalColumnWriter::writeCurPartDecimal(std::shared_ptr<ColumnVector> columnVector, long* values, int curPartLength, int curPartOffset) {
+    const uint8_t *nulls = columnVector->isNull + curPartOffset;
+    long *pixel = curPixelVector.data() + curPixelVectorIndex;
+    int valueNum = WriterUtils::gather(pixel, values + curPartOffset, nulls, curPartLength, nullsPadding);
+    if (nullsPadding) {
+        pixelStatRecorder.updateIntegers(pixel, nulls, curPartLength);
+        curPixelVectorIndex += curPartLength;
+    } else {
+        pixelStatRecorder.updateIntegers(pixel, nullptr, valueNum);
+        curPixelVectorIndex += valueNum;
     }
+    hasNull |= valueNum < curPartLength;
+    curPixelEleIndex += curPartLength;
+
+    std::copy(columnVector->isNull + curPartOffset, columnVector->isNull + curPartOffset + curPartLength, isNull.begin() + curPixelIsNullIndex);
+    curPixelIsNullIndex += curPartLength;
+}
+
+void DecimalColumnWriter::newPixel() {
+    WriterUtils::encodeLongs(encodingBuffer.data(), curPixelVector.data(), curPixelVectorIndex, byteOrder);
+    outputStream->putBytes(encodingBuffer.data(), curPixelVectorIndex * sizeof(long));
 
-    return outputStream->getWritePos(); 
+    ColumnWriter::newPixel();
 }
 
 bool DecimalColumnWriter::decideNullsPadding(std::shared_ptr<PixelsWriterOption> writerOption) {
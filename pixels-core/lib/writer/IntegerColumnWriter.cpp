@@ -20,12 +20,14 @@
 
 #include "writer/IntegerColumnWriter.h"
 #include "utils/BitUtils.h"
+#include "utils/WriterUtils.h"
 
 IntegerColumnWriter::IntegerColumnWriter(std::shared_ptr<TypeDescription> type, std::shared_ptr<PixelsWriterOption> writerOption) :
 ColumnWriter(type, writerOption), curPixelVector(pixelStride)
 {
     isLong = type->getCategory() == TypeDescription::Category::LONG;
     runlengthEncoding = encodingLevel.ge(EncodingLevel::Level::EL2);
+    nullsPadding = decideNullsPadding(writerOption);
     if (runlengthEncoding)
     {
         encoder = std::make_unique<RunLenIntEncoder>();
@@ -34,20 +36,22 @@ ColumnWriter(type, writerOption), curPixelVector(pixelStride)
 
 int IntegerColumnWriter::write(std::shared_ptr<ColumnVector> vector, int size)
 {
-    std::cout<<"In IntegerColumnWriter"<<std::endl;
     auto columnVector = std::static_pointer_cast<LongColumnVector>(vector);
     if (!columnVector)
     {
         throw std::invalid_argument("Invalid vector type");
     }
-    long* values;
-    if(columnVector->isLongVector()){
-      values=columnVector->longVector;
-
-    }else {
-        values = columnVector->intVector;
+    if (columnVector->isLongVector())
+    {
+        return writeValues(columnVector, columnVector->longVector, size);
     }
+    // the int values are packed as int32
+    return writeValues(columnVector, reinterpret_cast<const int *>(columnVector->intVector), size);
+}
 
+template <class T>
+int IntegerColumnWriter::writeValues(std::shared_ptr<LongColumnVector> columnVector, const T *values, int size)
+{
     int curPartLength;         // size of the partition which belongs to current pixel
     int curPartOffset = 0;     // starting offset of the partition which belongs to current pixel
     int nextPartLength = size; // size of the partition which belongs to next pixel
@@ -77,25 +81,33 @@ void IntegerColumnWriter::close()
     }
     ColumnWriter::close();
 }
-void IntegerColumnWriter::writeCurPartLong(std::shared_ptr<ColumnVector> columnVector, long *values, int curPartLength, int curPartOffset)
+
+void IntegerColumnWriter::reset()
+{
+    ColumnWriter::reset();
+    if (runlengthEncoding)
+    {
+        encoder->clear();
+    }
+}
+template <class T>
+void IntegerColumnWriter::writeCurPartLong(std::shared_ptr<ColumnVector> columnVector, const T *values, int curPartLength, int curPartOffset)
 {
-    for (int i = 0; i < curPartLength; i++)
+    const uint8_t *nulls = columnVector->isNull + curPartOffset;
+    long *pixel = curPixelVector.data() + curPixelVectorIndex;
+    int valueNum = WriterUtils::gather(pixel, values + curPartOffset, nulls, curPartLength, nullsPadding);
+    if (nullsPadding)
+    {
+        pixelStatRecorder.updateIntegers(pixel, nulls, curPartLength);
+        curPixelVectorIndex += curPartLength;
+    }
+    else
     {
-        curPixelEleIndex++;
-        if (columnVector->isNull[i + curPartOffset])
-        {
-            hasNull = true;
-            if (nullsPadding)
-            {
-                // padding 0 for nulls
-                curPixelVector[curPixelVectorIndex++] = 0L;
-            }
-        }
-        else
-        {
-            curPixelVector[curPixelVectorIndex++] = values[i + curPartOffset];
-        }
+        pixelStatRecorder.updateIntegers(pixel, nullptr, valueNum);
+        curPixelVectorIndex += valueNum;
     }
+    hasNull |= valueNum < curPartLength;
+    curPixelEleIndex += curPartLength;
     std::copy(columnVector->isNull + curPartOffset, columnVector->isNull + curPartOffset + curPartLength, isNull.begin() + curPixelIsNullIndex);
     curPixelIsNullIndex += curPartLength;
 }
@@ -114,52 +126,17 @@ void IntegerColumnWriter::newPixel()
     // write out current pixel vector
     if (runlengthEncoding)
     {
-        std::vector<byte> buffer(curPixelVectorIndex * sizeof(int));
-        int resLen;
-        encoder->encode(curPixelVector.data(), buffer.data(), curPixelVectorIndex, resLen);
-        outputStream->putBytes(buffer.data(), resLen);
+        encoder->encode(curPixelVector.data(), curPixelVectorIndex, outputStream);
+    }
+    else if (isLong)
+    {
+        WriterUtils::encodeLongs(encodingBuffer.data(), curPixelVector.data(), curPixelVectorIndex, byteOrder);
+        outputStream->putBytes(encodingBuffer.data(), curPixelVectorIndex * sizeof(long));
     }
     else
     {
-        std::shared_ptr<ByteBuffer> curVecPartitionBuffer;
-        EncodingUtils encodingUtils;
-        if (isLong)
-        {
-            curVecPartitionBuffer = std::make_shared<ByteBuffer>(curPixelVectorIndex * sizeof(long));
-            if (byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN)
-            {
-                for (int i = 0; i < curPixelVectorIndex; i++)
-                {
-                    encodingUtils.writeLongLE(curVecPartitionBuffer, curPixelVector[i]);
-                }
-            }
-            else
-            {
-                for (int i = 0; i < curPixelVectorIndex; i++)
-                {
-                    encodingUtils.writeLongBE(curVecPartitionBuffer, curPixelVector[i]);
-                }
-            }
-        }
-        else
-        {
-            curVecPartitionBuffer = std::make_shared<ByteBuffer>(curPixelVectorIndex * sizeof(int));
-            if (byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN)
-            {
-                for (int i = 0; i < curPixelVectorIndex; i++)
-                {
-                    encodingUtils.writeIntLE(curVecPartitionBuffer, (int)curPixelVector[i]);
-                }
-            }
-            else
-            {
-                for (int i = 0; i < curPixelVectorIndex; i++)
-                {
-                    encodingUtils.writeIntBE(curVecPartitionBuffer, (int)curPixelVector[i]);
-                }
-            }
-        }
-        outputStream->putBytes(curVecPartitionBuffer->getPointer(), curVecPartitionBuffer->getWritePos());
+        WriterUtils::encodeInts(encodingBuffer.data(), curPixelVector.data(), curPixelVectorIndex, byteOrder);
+        outputStream->putBytes(encodingBuffer.data(), curPixelVectorIndex * sizeof(int));
     }
 
     ColumnWriter::newPixel();
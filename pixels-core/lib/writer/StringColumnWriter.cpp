@@ -32,6 +32,16 @@ ColumnWriter(type,writerOption),curPixelVector(pixelStride) {
 }
 
 
+void StringColumnWriter::reset(){
+ ColumnWriter::reset();
+ if (runlengthEncoding)
+ {
+  encoder->clear();
+ }
+ startsArray->clear();
+ startOffset=0;
+}
+
 void StringColumnWriter::flush(){
  ColumnWriter::flush();
  flushStarts();
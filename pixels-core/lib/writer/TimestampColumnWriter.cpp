@@ -21,6 +21,7 @@
 #include "writer/TimestampColumnWriter.h"
 #include "utils/EncodingUtils.h"
 #include "utils/BitUtils.h"
+#include "utils/WriterUtils.h"
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -37,19 +38,12 @@ TimestampColumnWriter::TimestampColumnWriter(std::shared_ptr<TypeDescription> ty
 
 int TimestampColumnWriter::write(std::shared_ptr<ColumnVector> vector, int length)
 {
-    std::cout << "In TimestampColumnWriter" << std::endl;
-
-    auto columnVector = std::static_pointer_cast<LongColumnVector>(vector);
+    auto columnVector = std::static_pointer_cast<TimestampColumnVector>(vector);
     if (!columnVector) {
         throw std::invalid_argument("Invalid vector type"); // 类型不匹配时抛出异常
     }
 
-    long* values;
-    if (columnVector->isLongVector()) {
-        values = columnVector->longVector;
-    } else {
-        values = columnVector->intVector; // 如果是整型向量，则转换为 long 类型
-    }
+    long* values = columnVector->times;
 
     int curPartLength;         // 当前分区的大小
     int curPartOffset = 0;     // 当前分区的起始偏移
@@ -79,25 +73,31 @@ void TimestampColumnWriter::close()
     ColumnWriter::close(); // 调用基类的 close 方法
 }
 
+void TimestampColumnWriter::reset()
+{
+    ColumnWriter::reset();
+    if (runlengthEncoding) {
+        encoder->clear();
+    }
+}
+
 void TimestampColumnWriter::writeCurPartTimestamp(std::shared_ptr<ColumnVector> columnVector, long* values, int curPartLength, int curPartOffset)
 {
-    for (int i = 0; i < curPartLength; i++)
+    const uint8_t *nulls = columnVector->isNull + curPartOffset;
+    long *pixel = curPixelVector.data() + curPixelVectorIndex;
+    int valueNum = WriterUtils::gather(pixel, values + curPartOffset, nulls, curPartLength, nullsPadding);
+    if (nullsPadding)
+    {
+        pixelStatRecorder.updateIntegers(pixel, nulls, curPartLength);
+        curPixelVectorIndex += curPartLength;
+    }
+    else
     {
-        curPixelEleIndex++;
-        if (columnVector->isNull[i + curPartOffset]) // 检查当前值是否为空
-        {
-            hasNull = true;
-            if (nullsPadding)
-            {
-                // 如果启用了 null 填充，则填充 0
-                curPixelVector[curPixelVectorIndex++] = 0L;
-            }
-        }
-        else
-        {
-            curPixelVector[curPixelVectorIndex++] = values[i + curPartOffset]; // 否则直接写入值
-        }
+        pixelStatRecorder.updateIntegers(pixel, nullptr, valueNum);
+        curPixelVectorIndex += valueNum;
     }
+    hasNull |= valueNum < curPartLength;
+    curPixelEleIndex += curPartLength;
     std::copy(columnVector->isNull + curPartOffset, columnVector->isNull + curPartOffset + curPartLength, isNull.begin() + curPixelIsNullIndex);
     curPixelIsNullIndex += curPartLength;
 }
@@ -115,32 +115,12 @@ void TimestampColumnWriter::newPixel()
 {
     // 确保 runlengthEncoding 为 true 才使用游程编码
     if (runlengthEncoding) {
-        std::vector<byte> buffer(curPixelVectorIndex * sizeof(long));
-        int resLen;
-        encoder->encode(curPixelVector.data(), buffer.data(), curPixelVectorIndex, resLen); // 使用游程编码
-        outputStream->putBytes(buffer.data(), resLen);
+        encoder->encode(curPixelVector.data(), curPixelVectorIndex, outputStream); // 使用游程编码
     }
     else
     {
-        std::shared_ptr<ByteBuffer> curVecPartitionBuffer;
-        EncodingUtils encodingUtils;
-        
-        curVecPartitionBuffer = std::make_shared<ByteBuffer>(curPixelVectorIndex * sizeof(long));
-        if (byteOrder == ByteOrder::PIXELS_LITTLE_ENDIAN)
-        {
-            for (int i = 0; i < curPixelVectorIndex; i++)
-            {
-                encodingUtils.writeLongLE(curVecPartitionBuffer, curPixelVector[i]);
-            }
-        }
-        else
-        {
-            for (int i = 0; i < curPixelVectorIndex; i++)
-            {
-                encodingUtils.writeLongBE(curVecPartitionBuffer, curPixelVector[i]);
-            }
-        }
-        outputStream->putBytes(curVecPartitionBuffer->getPointer(), curVecPartitionBuffer->getWritePos());
+        WriterUtils::encodeLongs(encodingBuffer.data(), curPixelVector.data(), curPixelVectorIndex, byteOrder);
+        outputStream->putBytes(encodingBuffer.data(), curPixelVectorIndex * sizeof(long));
     }
 
     ColumnWriter::newPixel(); // 调用基类的 newPixel 方法
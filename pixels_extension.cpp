@@ -53,6 +53,10 @@ void PixelsExtension::Load(DuckDB &db) {
 
 	auto &config = DBConfig::GetConfig(*db.instance);
 	config.replacement_scans.emplace_back(PixelsScanReplacement);
+	config.AddExtensionOption("pixels_read_priority",
+	                          "The priority of the reads of the query if read.request.scheduler is ratelimited, "
+	                          "the reads of the higher priority are admitted first",
+	                          LogicalType::INTEGER, Value::INTEGER(0));
 }
 
 std::string PixelsExtension::Name() {
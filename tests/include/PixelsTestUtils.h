@@ -0,0 +1,78 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIXELS_PIXELSTESTUTILS_H
+#define PIXELS_PIXELSTESTUTILS_H
+
+#include "PixelsReaderBuilder.h"
+#include "physical/StorageFactory.h"
+#include "utils/ConfigFactory.h"
+
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+/**
+ * A file under /tmp that is created empty and removed when the fixture goes out of scope.
+ */
+class TempFile {
+public:
+    explicit TempFile(const std::string &prefix) {
+        std::string pattern = "/tmp/" + prefix + "_XXXXXX";
+        int fd = mkstemp(&pattern[0]);
+        EXPECT_NE(fd, -1) << "cannot create " << pattern;
+        if (fd != -1) {
+            close(fd);
+        }
+        path = pattern;
+    }
+
+    TempFile(const TempFile &) = delete;
+    TempFile &operator=(const TempFile &) = delete;
+
+    ~TempFile() {
+        unlink(path.c_str());
+    }
+
+    const std::string &getPath() const {
+        return path;
+    }
+
+private:
+    std::string path;
+};
+
+// tests/data/example.pxl of the source tree, PIXELS_SRC points to the source tree
+inline std::string exampleFilePath() {
+    return ConfigFactory::Instance().getPixelsSourceDirectory() + "tests/data/example.pxl";
+}
+
+inline std::shared_ptr<PixelsReader> openPixelsReader(const std::string &path,
+                                                      std::shared_ptr<PixelsFooterCache> footerCache = nullptr) {
+    std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
+    auto builder = std::make_shared<PixelsReaderBuilder>();
+    return builder->setPath(path)
+            ->setStorage(storage)
+            ->setPixelsFooterCache(footerCache)
+            ->build();
+}
+
+#endif // PIXELS_PIXELSTESTUTILS_H
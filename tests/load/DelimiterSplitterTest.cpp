@@ -0,0 +1,94 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "load/DelimiterSplitter.h"
+#include "utils/CpuFeatures.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+std::vector<std::string> toStrings(const std::vector<TextField> &fields) {
+    std::vector<std::string> result;
+    for (auto &field : fields) {
+        result.emplace_back(field.data, field.length);
+    }
+    return result;
+}
+}
+
+TEST(DelimiterSplitterTest, SplitLines) {
+    DelimiterSplitter splitter('|');
+    std::string text = "1|abc||d\n|\nlast";
+    std::vector<TextField> fields;
+    const char *end = text.data() + text.size();
+    const char *next = splitter.splitLine(text.data(), end, fields);
+    EXPECT_EQ(toStrings(fields), (std::vector<std::string>{"1", "abc", "", "d"}));
+    next = splitter.splitLine(next, end, fields);
+    EXPECT_EQ(toStrings(fields), (std::vector<std::string>{"", ""}));
+    // the last line is not terminated by a line break
+    next = splitter.splitLine(next, end, fields);
+    EXPECT_EQ(toStrings(fields), (std::vector<std::string>{"last"}));
+    EXPECT_EQ(next, end);
+}
+
+TEST(DelimiterSplitterTest, SplitAcrossBlocks) {
+    // the lines are longer than the blocks of 16 and 32 bytes, and the delimiters and the line
+    // breaks fall on every position of the blocks
+    std::string text;
+    std::vector<std::vector<std::string>> expected;
+    for (int line = 0; line < 50; line++) {
+        std::vector<std::string> fields;
+        for (int field = 0; field < line % 7 + 1; field++) {
+            fields.emplace_back(std::string((line * 3 + field * 5) % 40, (char) ('a' + field)));
+            text += fields.back();
+            text += field == line % 7 ? '\n' : ',';
+        }
+        expected.emplace_back(fields);
+    }
+    // the SSE2 scanner is used below AVX2
+    for (auto level : {CpuFeatures::SimdLevel::SCALAR, CpuFeatures::SimdLevel::AVX2}) {
+        CpuFeatures::SetSimdLevel(level);
+        DelimiterSplitter splitter(',');
+        std::vector<TextField> fields;
+        const char *p = text.data();
+        const char *end = text.data() + text.size();
+        for (auto &line : expected) {
+            ASSERT_LT(p, end);
+            p = splitter.splitLine(p, end, fields);
+            EXPECT_EQ(toStrings(fields), line);
+        }
+        EXPECT_EQ(p, end);
+    }
+    CpuFeatures::SetSimdLevel(CpuFeatures::SimdLevel::AVX512);
+}
+
+TEST(DelimiterSplitterTest, ToDelimiter) {
+    char delimiter;
+    ASSERT_TRUE(DelimiterSplitter::toDelimiter("|", delimiter));
+    EXPECT_EQ(delimiter, '|');
+    ASSERT_TRUE(DelimiterSplitter::toDelimiter("\\s", delimiter));
+    EXPECT_EQ(delimiter, ' ');
+    ASSERT_TRUE(DelimiterSplitter::toDelimiter("\\t", delimiter));
+    EXPECT_EQ(delimiter, '\t');
+    ASSERT_TRUE(DelimiterSplitter::toDelimiter("\\|", delimiter));
+    EXPECT_EQ(delimiter, '|');
+    EXPECT_FALSE(DelimiterSplitter::toDelimiter("[,;]", delimiter));
+    EXPECT_FALSE(DelimiterSplitter::toDelimiter("\\d", delimiter));
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "utils/TextParser.h"
+
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+// the text is not null-terminated in the files, so the length is always passed
+bool parseLong(const char *text, int64_t &value) {
+    return TextParser::parseLong(text, strlen(text), value);
+}
+
+bool parseDecimal(const char *text, int scale, int64_t &value) {
+    return TextParser::parseDecimal(text, strlen(text), scale, value);
+}
+
+bool parseTimestamp(const char *text, int precision, int64_t &value) {
+    return TextParser::parseTimestamp(text, strlen(text), precision, value);
+}
+}
+
+TEST(TextParserTest, ParseLong) {
+    int64_t value;
+    ASSERT_TRUE(parseLong("0", value));
+    EXPECT_EQ(value, 0);
+    ASSERT_TRUE(parseLong("-9223372036854775808", value));
+    EXPECT_EQ(value, INT64_MIN);
+    ASSERT_TRUE(parseLong("9223372036854775807", value));
+    EXPECT_EQ(value, INT64_MAX);
+    EXPECT_FALSE(parseLong("9223372036854775808", value));
+    EXPECT_FALSE(parseLong("", value));
+    EXPECT_FALSE(parseLong("12a", value));
+    EXPECT_FALSE(parseLong(" 12", value));
+    // only the given length is parsed
+    ASSERT_TRUE(TextParser::parseLong("1234|5678", 4, value));
+    EXPECT_EQ(value, 1234);
+}
+
+TEST(TextParserTest, ParseBool) {
+    bool value;
+    ASSERT_TRUE(TextParser::parseBool("TRUE", 4, value));
+    EXPECT_TRUE(value);
+    ASSERT_TRUE(TextParser::parseBool("False", 5, value));
+    EXPECT_FALSE(value);
+    EXPECT_FALSE(TextParser::parseBool("truth", 5, value));
+    EXPECT_FALSE(TextParser::parseBool("1", 1, value));
+}
+
+TEST(TextParserTest, ParseDecimal) {
+    int64_t value;
+    ASSERT_TRUE(parseDecimal("123.45", 2, value));
+    EXPECT_EQ(value, 12345);
+    ASSERT_TRUE(parseDecimal("-0.5", 2, value));
+    EXPECT_EQ(value, -50);
+    ASSERT_TRUE(parseDecimal("+7", 3, value));
+    EXPECT_EQ(value, 7000);
+    ASSERT_TRUE(parseDecimal(".25", 2, value));
+    EXPECT_EQ(value, 25);
+    // the extra fractional digits are truncated
+    ASSERT_TRUE(parseDecimal("1.999", 2, value));
+    EXPECT_EQ(value, 199);
+    ASSERT_TRUE(parseDecimal("000000000000000000001.5", 1, value));
+    EXPECT_EQ(value, 15);
+    EXPECT_FALSE(parseDecimal("1234567890123456789", 0, value));
+    EXPECT_FALSE(parseDecimal("12345678901234567", 2, value));
+    EXPECT_FALSE(parseDecimal("1.2.3", 2, value));
+    EXPECT_FALSE(parseDecimal("-", 2, value));
+    EXPECT_FALSE(parseDecimal("1e5", 2, value));
+}
+
+TEST(TextParserTest, ParseDate) {
+    int days;
+    ASSERT_TRUE(TextParser::parseDate("1970-01-01", 10, days));
+    EXPECT_EQ(days, 0);
+    ASSERT_TRUE(TextParser::parseDate("2000-03-01", 10, days));
+    EXPECT_EQ(days, 11017);
+    ASSERT_TRUE(TextParser::parseDate("1969-12-31", 10, days));
+    EXPECT_EQ(days, -1);
+    EXPECT_FALSE(TextParser::parseDate("2000-13-01", 10, days));
+    EXPECT_FALSE(TextParser::parseDate("2000/03/01", 10, days));
+    EXPECT_FALSE(TextParser::parseDate("2000-3-1", 8, days));
+}
+
+TEST(TextParserTest, ParseTimestamp) {
+    int64_t value;
+    ASSERT_TRUE(parseTimestamp("1970-01-02 00:00:01", 0, value));
+    EXPECT_EQ(value, 86401);
+    ASSERT_TRUE(parseTimestamp("1970-01-01T00:00:01.5", 6, value));
+    EXPECT_EQ(value, 1500000);
+    // the extra fractional digits are truncated
+    ASSERT_TRUE(parseTimestamp("1970-01-01 00:00:00.123456789", 3, value));
+    EXPECT_EQ(value, 123);
+    EXPECT_FALSE(parseTimestamp("1970-01-01 24:00:00", 0, value));
+    EXPECT_FALSE(parseTimestamp("1970-01-01 00:00:00.", 3, value));
+    EXPECT_FALSE(parseTimestamp("1970-01-01", 0, value));
+}
+
+TEST(TextParserTest, TimestampsAreUtcWallClock) {
+    // the old loader took mktime() + 8h, which is only the UTC wall-clock time on UTC+8 hosts
+    const char *timeZone = getenv("TZ");
+    std::string oldTimeZone = timeZone == nullptr ? "" : timeZone;
+    setenv("TZ", "America/New_York", 1);
+    tzset();
+    int64_t value;
+    bool parsed = parseTimestamp("2024-01-01 08:00:00", 0, value);
+    if (timeZone == nullptr) {
+        unsetenv("TZ");
+    } else {
+        setenv("TZ", oldTimeZone.c_str(), 1);
+    }
+    tzset();
+    ASSERT_TRUE(parsed);
+    EXPECT_EQ(value, 1704096000);
+}
+
+TEST(TextParserTest, ShortFractionsArePadded) {
+    // the old loader took the digits as they are, so ".5" was 5us at precision 6
+    int64_t value;
+    ASSERT_TRUE(parseTimestamp("1970-01-01 00:00:00.5", 6, value));
+    EXPECT_EQ(value, 500000);
+    ASSERT_TRUE(parseTimestamp("1970-01-01 00:00:00.05", 3, value));
+    EXPECT_EQ(value, 50);
+    ASSERT_TRUE(parseTimestamp("1970-01-01 00:00:00.000001", 6, value));
+    EXPECT_EQ(value, 1);
+}
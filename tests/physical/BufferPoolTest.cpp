@@ -0,0 +1,58 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "physical/BufferPool.h"
+
+#include "gtest/gtest.h"
+#include <thread>
+
+namespace {
+// four buffers of 1 GiB, which take the whole memory budget of pixels-cxx.properties
+const std::vector<uint32_t> colIds{0, 1, 2, 3};
+const std::vector<uint64_t> bytes(4, 1000L * 1000 * 1000);
+const std::vector<std::string> columnNames{"a", "b", "c", "d"};
+}
+
+TEST(BufferPoolTest, ExitedThreadGivesBackItsBuffers) {
+    int threadSlot = -2;
+    std::thread thread([&]() {
+        // the buffers stay cached by the thread after the slot is released
+        threadSlot = BufferPool::AcquireSlot(colIds, bytes, columnNames);
+        BufferPool::ReleaseSlot(threadSlot);
+    });
+    thread.join();
+    ASSERT_EQ(threadSlot, 0);
+
+    int slot = BufferPool::AcquireSlot(colIds, bytes, columnNames);
+    EXPECT_EQ(slot, 0);
+    ASSERT_NE(BufferPool::GetBuffer(slot, 3), nullptr);
+    EXPECT_GE(BufferPool::GetBuffer(slot, 3)->size(), bytes[3]);
+    BufferPool::ReleaseSlot(slot);
+}
+
+TEST(BufferPoolTest, CachedBuffersAreReused) {
+    int slot = BufferPool::AcquireSlot(colIds, bytes, columnNames);
+    ASSERT_GE(slot, 0);
+    BufferPool::ReleaseSlot(slot);
+    // the budget is taken by the cached buffers, so the slot only succeeds with them
+    slot = BufferPool::AcquireSlot(colIds, bytes, columnNames);
+    EXPECT_GE(slot, 0);
+    BufferPool::ReleaseSlot(slot);
+}
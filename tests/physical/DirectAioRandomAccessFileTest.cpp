@@ -0,0 +1,134 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "physical/natives/DirectAioRandomAccessFile.h"
+#include "physical/natives/DirectIoLib.h"
+#include "PixelsTestUtils.h"
+
+#include "gtest/gtest.h"
+#include <climits>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+const int chunkLength = 5000;
+const int chunkNum = 4;
+}
+
+/**
+ * Read the chunks of two files through the AIO context of the thread, which is shared by the files.
+ */
+class DirectAioRandomAccessFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (int f = 0; f < 2; f++) {
+            contents_[f].resize(chunkLength * chunkNum);
+            for (size_t i = 0; i < contents_[f].size(); i++) {
+                contents_[f][i] = (uint8_t) (i * (f + 5) + i / 4096);
+            }
+            std::ofstream out(files_[f].getPath(), std::ios::binary);
+            ASSERT_TRUE(out.write((const char *) contents_[f].data(), contents_[f].size()).good());
+        }
+    }
+
+    void TearDown() override {
+        DirectAioRandomAccessFile::Reset();
+    }
+
+    /**
+     * Prepare and submit the reads of the given chunks as one batch.
+     */
+    std::vector<std::shared_ptr<ByteBuffer>> submit(DirectAioRandomAccessFile &file, int first, int num) {
+        std::vector<std::shared_ptr<ByteBuffer>> results;
+        for (int i = first; i < first + num; i++) {
+            // the reads are aligned to the blocks around the chunk
+            auto buffer = directIoLib_.allocateDirectBuffer(chunkLength + 2 * blockSize_);
+            buffers_.emplace_back(buffer);
+            file.seek((long) i * chunkLength);
+            results.emplace_back(file.readAsync(chunkLength, buffer, -1));
+        }
+        file.readAsyncSubmit(num);
+        return results;
+    }
+
+    void expectChunks(int f, int first, const std::vector<std::shared_ptr<ByteBuffer>> &results) {
+        for (size_t i = 0; i < results.size(); i++) {
+            ASSERT_EQ(memcmp(results[i]->getPointer(),
+                             contents_[f].data() + (first + i) * chunkLength, chunkLength), 0)
+                                    << "file " << f << " chunk " << first + i;
+        }
+    }
+
+    /**
+     * Read both files, waiting for them in the reverse order of the submission.
+     */
+    void readBothFiles() {
+        DirectAioRandomAccessFile a(files_[0].getPath());
+        DirectAioRandomAccessFile b(files_[1].getPath());
+        auto resultsA = submit(a, 0, chunkNum);
+        auto resultsB = submit(b, 0, chunkNum);
+        b.readAsyncComplete(chunkNum);
+        expectChunks(1, 0, resultsB);
+        a.readAsyncComplete(chunkNum);
+        expectChunks(0, 0, resultsA);
+        a.close();
+        b.close();
+    }
+
+    const int blockSize_ = std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size"));
+    DirectIoLib directIoLib_{blockSize_};
+    TempFile files_[2] = {TempFile("pixels_aio_a"), TempFile("pixels_aio_b")};
+    std::vector<uint8_t> contents_[2];
+    std::vector<std::shared_ptr<ByteBuffer>> buffers_;
+};
+
+TEST_F(DirectAioRandomAccessFileTest, FilesCompleteOutOfSubmissionOrder) {
+    DirectAioRandomAccessFile::Initialize(chunkNum);
+    readBothFiles();
+}
+
+TEST_F(DirectAioRandomAccessFileTest, SmallContextTakesMoreReadsThanItsDepth) {
+    // the new context of a thread that reads one column holds fewer events than the reads of both files
+    std::thread thread([this]() {
+        DirectAioRandomAccessFile::Initialize(1);
+        readBothFiles();
+    });
+    thread.join();
+}
+
+TEST_F(DirectAioRandomAccessFileTest, ReadsAreSynchronousWithoutAContext) {
+    // a thread whose context can't be created, since the events exceed fs.aio-max-nr
+    std::thread thread([this]() {
+        DirectAioRandomAccessFile::Initialize(INT_MAX / 8);
+        readBothFiles();
+    });
+    thread.join();
+}
+
+TEST_F(DirectAioRandomAccessFileTest, ReadOfATruncatedFileFails) {
+    DirectAioRandomAccessFile::Initialize(1);
+    DirectAioRandomAccessFile a(files_[0].getPath());
+    // the file ends before the reads that were planned with its length at open
+    ASSERT_EQ(truncate(files_[0].getPath().c_str(), chunkLength), 0);
+    submit(a, chunkNum - 1, 1);
+    EXPECT_THROW(a.readAsyncComplete(1), InvalidArgumentException);
+    a.close();
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "physical/natives/DirectRandomAccessFile.h"
+#include "physical/natives/DirectIoLib.h"
+#include "PixelsTestUtils.h"
+
+#include "gtest/gtest.h"
+#include <climits>
+#include <fstream>
+
+class DirectRandomAccessFileTest : public ::testing::Test
+{
+protected:
+    void SetUp() override {
+        content_.resize(fileSize_);
+        for (long i = 0; i < fileSize_; i++) {
+            content_[i] = (uint8_t) (i * 31 + i / 4096);
+        }
+        std::ofstream out(path_, std::ios::binary);
+        ASSERT_TRUE(out.write((const char *) content_.data(), fileSize_).good());
+    }
+
+protected:
+    // the chunks are two blocks apart, so each chunk and each gap takes an iovec
+    const int chunkNum_ = IOV_MAX;
+    const long fileSize_ = IOV_MAX * 8192L + 300;
+    TempFile file_{"pixels_direct"};
+    const std::string &path_ = file_.getPath();
+    std::vector<uint8_t> content_;
+};
+
+TEST_F(DirectRandomAccessFileTest, ReadFullyVectoredMoreThanIovMax) {
+    DirectRandomAccessFile file(path_);
+    DirectIoLib directIoLib(std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size")));
+    std::vector<long> offsets;
+    std::vector<int> lengths;
+    std::vector<std::shared_ptr<ByteBuffer>> buffers;
+    for (int i = 0; i < chunkNum_; i++) {
+        offsets.emplace_back(i * 8192L + 100);
+        lengths.emplace_back(200);
+    }
+    // the block of the last chunk ends after the end of the file
+    offsets.emplace_back(chunkNum_ * 8192L + 10);
+    lengths.emplace_back(200);
+    for (int i = 0; i < offsets.size(); i++) {
+        buffers.emplace_back(directIoLib.allocateDirectBuffer(8192));
+    }
+    auto results = file.readFullyVectored(offsets, lengths, buffers);
+    ASSERT_EQ(results.size(), offsets.size());
+    for (int i = 0; i < offsets.size(); i++) {
+        ASSERT_EQ(memcmp(results[i]->getPointer(), content_.data() + offsets[i], lengths[i]), 0) << "chunk " << i;
+    }
+    file.close();
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "physical/natives/DirectUringRandomAccessFile.h"
+#include "physical/natives/DirectIoLib.h"
+#include "physical/BufferPool.h"
+#include "PixelsTestUtils.h"
+
+#include "gtest/gtest.h"
+#include <fstream>
+#include <unistd.h>
+
+namespace {
+const int chunkLength = 5000;
+const int chunkNum = 4;
+}
+
+/**
+ * Read the chunks of two files through the io_uring ring of the thread. The ring is shared by the
+ * files, so the completions of a file may be reaped while the other file waits for its reads.
+ */
+class DirectUringRandomAccessFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        for (int f = 0; f < 2; f++) {
+            contents_[f].resize(chunkLength * chunkNum);
+            for (size_t i = 0; i < contents_[f].size(); i++) {
+                contents_[f][i] = (uint8_t) (i * (f + 7) + i / 4096);
+            }
+            std::ofstream out(files_[f].getPath(), std::ios::binary);
+            ASSERT_TRUE(out.write((const char *) contents_[f].data(), contents_[f].size()).good());
+        }
+        DirectUringRandomAccessFile::Initialize();
+    }
+
+    void TearDown() override {
+        DirectUringRandomAccessFile::Reset();
+    }
+
+    /**
+     * Prepare and submit the reads of the given chunks as one batch.
+     */
+    std::vector<std::shared_ptr<ByteBuffer>> submit(DirectUringRandomAccessFile &file, int first, int num) {
+        std::vector<std::shared_ptr<ByteBuffer>> results;
+        for (int i = first; i < first + num; i++) {
+            // the reads are aligned to the blocks around the chunk
+            auto buffer = directIoLib_.allocateDirectBuffer(chunkLength + 2 * blockSize_);
+            buffers_.emplace_back(buffer);
+            file.seek((long) i * chunkLength);
+            results.emplace_back(file.readAsync(chunkLength, buffer, -1));
+        }
+        file.readAsyncSubmit(num);
+        return results;
+    }
+
+    void expectChunks(int f, int first, const std::vector<std::shared_ptr<ByteBuffer>> &results) {
+        for (size_t i = 0; i < results.size(); i++) {
+            ASSERT_EQ(memcmp(results[i]->getPointer(),
+                             contents_[f].data() + (first + i) * chunkLength, chunkLength), 0)
+                                    << "file " << f << " chunk " << first + i;
+        }
+    }
+
+    const int blockSize_ = std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size"));
+    DirectIoLib directIoLib_{blockSize_};
+    TempFile files_[2] = {TempFile("pixels_uring_a"), TempFile("pixels_uring_b")};
+    std::vector<uint8_t> contents_[2];
+    std::vector<std::shared_ptr<ByteBuffer>> buffers_;
+};
+
+TEST_F(DirectUringRandomAccessFileTest, FilesCompleteOutOfSubmissionOrder) {
+    DirectUringRandomAccessFile a(files_[0].getPath());
+    DirectUringRandomAccessFile b(files_[1].getPath());
+    auto resultsA = submit(a, 0, chunkNum);
+    auto resultsB = submit(b, 0, chunkNum);
+    // b waits first, the completions of a that arrive meanwhile are kept for a
+    b.readAsyncComplete(chunkNum);
+    expectChunks(1, 0, resultsB);
+    a.readAsyncComplete(chunkNum);
+    expectChunks(0, 0, resultsA);
+    a.close();
+    b.close();
+}
+
+TEST_F(DirectUringRandomAccessFileTest, FilesCompleteInSubmissionOrder) {
+    DirectUringRandomAccessFile a(files_[0].getPath());
+    DirectUringRandomAccessFile b(files_[1].getPath());
+    auto resultsA = submit(a, 0, chunkNum);
+    auto resultsB = submit(b, 0, chunkNum);
+    a.readAsyncComplete(chunkNum);
+    expectChunks(0, 0, resultsA);
+    b.readAsyncComplete(chunkNum);
+    expectChunks(1, 0, resultsB);
+    a.close();
+    b.close();
+}
+
+TEST_F(DirectUringRandomAccessFileTest, BatchesOfAFileCompleteOneByOne) {
+    DirectUringRandomAccessFile a(files_[0].getPath());
+    DirectUringRandomAccessFile b(files_[1].getPath());
+    // the current and the prefetched row group of a, and the first row group of b in between
+    auto current = submit(a, 0, chunkNum / 2);
+    auto other = submit(b, 0, chunkNum);
+    auto next = submit(a, chunkNum / 2, chunkNum / 2);
+    a.readAsyncComplete(chunkNum / 2);
+    expectChunks(0, 0, current);
+    b.readAsyncComplete(chunkNum);
+    expectChunks(1, 0, other);
+    a.readAsyncComplete(chunkNum / 2);
+    expectChunks(0, chunkNum / 2, next);
+    a.close();
+    b.close();
+}
+
+TEST_F(DirectUringRandomAccessFileTest, ReadOfATruncatedFileFails) {
+    DirectUringRandomAccessFile a(files_[0].getPath());
+    // the file ends before the reads that were planned with its length at open
+    ASSERT_EQ(truncate(files_[0].getPath().c_str(), chunkLength), 0);
+    submit(a, chunkNum - 1, 1);
+    EXPECT_THROW(a.readAsyncComplete(1), InvalidArgumentException);
+    a.close();
+}
+
+TEST_F(DirectUringRandomAccessFileTest, PoolBuffersAreRegisteredWhenTheRingIsIdle) {
+    DirectUringRandomAccessFile a(files_[0].getPath());
+    DirectUringRandomAccessFile b(files_[1].getPath());
+    auto inFlight = submit(b, 0, chunkNum);
+    int slot = BufferPool::AcquireSlot({0}, {(uint64_t) chunkLength}, {"a"});
+    ASSERT_GE(slot, 0);
+    // the registered buffers are not replaced while the reads of b are in flight
+    DirectUringRandomAccessFile::RegisterBufferFromPool();
+    EXPECT_EQ(BufferPool::GetBufferId(slot, 0), -1);
+    b.readAsyncComplete(chunkNum);
+    expectChunks(1, 0, inFlight);
+
+    DirectUringRandomAccessFile::RegisterBufferFromPool();
+    int index = (int) BufferPool::GetBufferId(slot, 0);
+    ASSERT_GE(index, 0);
+    a.seek(chunkLength);
+    auto result = a.readAsync(chunkLength, BufferPool::GetBuffer(slot, 0), index);
+    a.readAsyncSubmit(1);
+    a.readAsyncComplete(1);
+    expectChunks(0, 1, {result});
+    BufferPool::ReleaseSlot(slot);
+    a.close();
+    b.close();
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "physical/natives/MmapRandomAccessFile.h"
+#include "PixelsTestUtils.h"
+
+#include "gtest/gtest.h"
+#include <fstream>
+
+class MmapRandomAccessFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        content_.resize(fileSize_);
+        for (long i = 0; i < fileSize_; i++) {
+            content_[i] = (uint8_t) (i * 13 + i / 4096);
+        }
+        std::ofstream out(path_, std::ios::binary);
+        ASSERT_TRUE(out.write((const char *) content_.data(), fileSize_).good());
+    }
+
+    /**
+     * @return whether the file is mapped into this process
+     */
+    bool isMapped() {
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+        while (std::getline(maps, line)) {
+            if (line.find(path_) != std::string::npos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const long fileSize_ = 3 * 4096 + 100;
+    TempFile file_{"pixels_mmap"};
+    const std::string &path_ = file_.getPath();
+    std::vector<uint8_t> content_;
+};
+
+TEST_F(MmapRandomAccessFileTest, ViewsReferenceTheMapping) {
+    MmapRandomAccessFile file(path_);
+    auto first = file.readFully(1000);
+    // the given buffer is not filled, the next view of the mapping is returned instead
+    auto unused = std::make_shared<ByteBuffer>(1000);
+    auto second = file.readFully(1000, unused);
+    EXPECT_NE(second, unused);
+    EXPECT_EQ(second->getPointer(), first->getPointer() + 1000);
+    file.seek(fileSize_ - 100);
+    auto last = file.readFully(100);
+    EXPECT_EQ(memcmp(first->getPointer(), content_.data(), 1000), 0);
+    EXPECT_EQ(memcmp(second->getPointer(), content_.data() + 1000, 1000), 0);
+    EXPECT_EQ(memcmp(last->getPointer(), content_.data() + fileSize_ - 100, 100), 0);
+    file.close();
+}
+
+TEST_F(MmapRandomAccessFileTest, ViewsOutliveTheFile) {
+    std::shared_ptr<ByteBuffer> view;
+    {
+        MmapRandomAccessFile file(path_);
+        file.seek(4000);
+        view = file.readFully(5000);
+        file.close();
+    }
+    // the view keeps the mapping after the file is closed and destroyed
+    ASSERT_TRUE(isMapped());
+    EXPECT_EQ(memcmp(view->getPointer(), content_.data() + 4000, 5000), 0);
+    view.reset();
+    EXPECT_FALSE(isMapped());
+}
+
+TEST_F(MmapRandomAccessFileTest, ClosedFileWithoutViewsIsUnmapped) {
+    MmapRandomAccessFile file(path_);
+    ASSERT_TRUE(isMapped());
+    file.close();
+    EXPECT_FALSE(isMapped());
+    EXPECT_THROW(file.readFully(10), std::runtime_error);
+}
+
+TEST_F(MmapRandomAccessFileTest, ReadBeyondTheEndThrows) {
+    MmapRandomAccessFile file(path_);
+    file.seek(fileSize_ - 10);
+    EXPECT_THROW(file.readFully(20), std::runtime_error);
+    file.seek(fileSize_ - 4);
+    EXPECT_THROW(file.readLong(), std::runtime_error);
+    file.seek(fileSize_ - 10);
+    EXPECT_NO_THROW(file.readFully(10));
+    file.close();
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "physical/PrefetchDepth.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+// a wait that stalls the scan thread and one that doesn't
+const int64_t stall = 10000;
+const int64_t hit = 0;
+}
+
+TEST(PrefetchDepthTest, StartsAtOneMorsel) {
+    PrefetchDepth depth(4);
+    EXPECT_EQ(depth.get(), 1);
+}
+
+TEST(PrefetchDepthTest, StallsDeepenThePipelineUpToTheMaxDepth) {
+    PrefetchDepth depth(4);
+    for (int expected = 2; expected <= 4; expected++) {
+        depth.update(stall);
+        EXPECT_EQ(depth.get(), expected);
+    }
+    depth.update(stall);
+    EXPECT_EQ(depth.get(), 4);
+}
+
+TEST(PrefetchDepthTest, ReadsInTimeShortenThePipeline) {
+    PrefetchDepth depth(4);
+    for (int i = 0; i < 3; i++) {
+        depth.update(stall);
+    }
+    ASSERT_EQ(depth.get(), 4);
+    // a single read in time doesn't shorten the pipeline
+    depth.update(hit);
+    EXPECT_EQ(depth.get(), 4);
+
+    int updates = 0;
+    while (depth.get() == 4) {
+        depth.update(hit);
+        updates++;
+    }
+    EXPECT_EQ(depth.get(), 3);
+    EXPECT_GT(updates, 1);
+
+    // a stall resets the reads in time in a row
+    depth.update(stall);
+    EXPECT_EQ(depth.get(), 4);
+    for (int i = 0; i < updates; i++) {
+        depth.update(hit);
+    }
+    EXPECT_EQ(depth.get(), 4);
+}
+
+TEST(PrefetchDepthTest, NeverShrinksBelowOneMorsel) {
+    PrefetchDepth depth(4);
+    for (int i = 0; i < 100; i++) {
+        depth.update(hit);
+    }
+    EXPECT_EQ(depth.get(), 1);
+}
+
+TEST(PrefetchDepthTest, MaxDepthIsReadFromTheConfig) {
+    PrefetchDepth depth;
+    EXPECT_GE(depth.getMaxDepth(), 1);
+    for (int i = 0; i < depth.getMaxDepth() + 1; i++) {
+        depth.update(stall);
+    }
+    EXPECT_EQ(depth.get(), depth.getMaxDepth());
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "physical/StorageArrayScheduler.h"
+
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+// the files of the devices dev0, dev1, ..., the storage directory depth is 1
+std::vector<std::string> createFiles(const std::vector<int> &fileNums) {
+    std::vector<std::string> files;
+    for (int device = 0; device < fileNums.size(); device++) {
+        for (int i = 0; i < fileNums[device]; i++) {
+            files.emplace_back("/dev" + std::to_string(device) + "/f_" + std::to_string(i) + ".pxl");
+        }
+    }
+    return files;
+}
+}
+
+TEST(StorageArraySchedulerTest, ClaimFromHomeDeviceFirst) {
+    auto files = createFiles({3, 3});
+    StorageArrayScheduler scheduler(files, 2);
+    ASSERT_EQ(scheduler.getDeviceSum(), 2);
+    for (int i = 0; i < 3; i++) {
+        int deviceID = 1;
+        int fileID = -1;
+        ASSERT_TRUE(scheduler.acquireMorsel(deviceID, fileID));
+        EXPECT_EQ(deviceID, 1);
+        EXPECT_EQ(fileID, i);
+        EXPECT_EQ(scheduler.getFileName(deviceID, fileID), "/dev1/f_" + std::to_string(i) + ".pxl");
+        scheduler.releaseMorsel(deviceID);
+    }
+}
+
+TEST(StorageArraySchedulerTest, StealingKeepsBatchIndexIncreasing) {
+    // the threads of dev0 and dev1 run out of morsels first, and steal from the other devices
+    auto files = createFiles({1, 2, 6, 6});
+    int threadNum = 4;
+    StorageArrayScheduler scheduler(files, threadNum);
+    std::vector<std::vector<int>> batchIDs(threadNum);
+    std::vector<bool> done(threadNum, false);
+    int stolen = 0;
+    while (std::find(done.begin(), done.end(), false) != done.end()) {
+        for (int thread = 0; thread < threadNum; thread++) {
+            if (done[thread]) {
+                continue;
+            }
+            int deviceID = thread;
+            int fileID = -1;
+            if (!scheduler.acquireMorsel(deviceID, fileID)) {
+                done[thread] = true;
+                continue;
+            }
+            stolen += deviceID != thread;
+            batchIDs[thread].emplace_back(scheduler.getBatchID(deviceID, fileID));
+            scheduler.releaseMorsel(deviceID);
+        }
+    }
+    EXPECT_GT(stolen, 0);
+    std::vector<int> all;
+    for (auto &ids: batchIDs) {
+        // DuckDB requires the batch indexes of a thread to increase
+        EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+        EXPECT_EQ(std::adjacent_find(ids.begin(), ids.end()), ids.end());
+        all.insert(all.end(), ids.begin(), ids.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), files.size());
+    for (int i = 0; i < all.size(); i++) {
+        EXPECT_EQ(all[i], i);
+    }
+}
+
+TEST(StorageArraySchedulerTest, ConcurrentStealingKeepsBatchIndexIncreasing) {
+    // the row groups are the morsels, and there are more threads than devices
+    auto files = createFiles({1, 4, 3});
+    std::vector<int> rowGroupNums(files.size(), 4);
+    int threadNum = 6;
+    StorageArrayScheduler scheduler(files, threadNum, rowGroupNums);
+    std::vector<std::vector<int>> batchIDs(threadNum);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < threadNum; thread++) {
+        threads.emplace_back([&, thread]() {
+            int homeDevice = thread % scheduler.getDeviceSum();
+            while (true) {
+                int deviceID = homeDevice;
+                int fileID = -1;
+                // the other threads keep claiming from a device that is too busy to steal from
+                if (!scheduler.acquireMorsel(deviceID, fileID)) {
+                    break;
+                }
+                batchIDs[thread].emplace_back(scheduler.getBatchID(deviceID, fileID));
+                EXPECT_EQ(scheduler.getRGLen(deviceID, fileID), 1);
+                scheduler.releaseMorsel(deviceID);
+            }
+        });
+    }
+    for (auto &t: threads) {
+        t.join();
+    }
+    std::vector<int> all;
+    for (auto &ids: batchIDs) {
+        EXPECT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+        all.insert(all.end(), ids.begin(), ids.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), files.size() * 4);
+    for (int i = 0; i < all.size(); i++) {
+        EXPECT_EQ(all[i], i);
+    }
+}
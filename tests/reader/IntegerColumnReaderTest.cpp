@@ -0,0 +1,101 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "reader/IntegerColumnReader.h"
+#include "vector/LongColumnVector.h"
+#include "writer/IntegerColumnWriter.h"
+#include "PixelsBitMask.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+const int length = 200;
+
+/**
+ * Write one pixel of run-length encoded longs: repeated values followed by a sequence.
+ */
+class IntegerColumnReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        values = std::make_shared<LongColumnVector>(length, true, true);
+        for (long i = 0; i < length; i++) {
+            values->add(i < length / 2 ? i / 25 : i);
+        }
+        auto option = std::make_shared<PixelsWriterOption>();
+        option->setPixelsStride(length);
+        option->setNullsPadding(false);
+        option->setEncodingLevel(EncodingLevel(EncodingLevel::EL2));
+        writer = std::make_unique<IntegerColumnWriter>(TypeDescription::createLong(), option);
+        writer->write(values, length);
+        writer->flush();
+        auto content = writer->getColumnChunkContent();
+        buffer = std::make_shared<ByteBuffer>(content.size());
+        buffer->putBytes(content.data(), content.size());
+    }
+
+    std::shared_ptr<LongColumnVector> read(std::shared_ptr<PixelsBitMask> filterMask) {
+        auto result = std::make_shared<LongColumnVector>(length, true, true);
+        IntegerColumnReader reader(TypeDescription::createLong());
+        auto encoding = writer->getColumnChunkEncoding();
+        reader.read(buffer, encoding, 0, length, length, 0, result,
+                    *writer->getColumnChunkIndexPtr(), filterMask);
+        return result;
+    }
+
+    std::shared_ptr<LongColumnVector> values;
+    std::unique_ptr<IntegerColumnWriter> writer;
+    std::shared_ptr<ByteBuffer> buffer;
+};
+}
+
+TEST_F(IntegerColumnReaderTest, ScanRecordsRuns) {
+    auto result = read(std::make_shared<PixelsBitMask>(length));
+    ASSERT_FALSE(result->runs.empty());
+    for (int i = 0; i < length; i++) {
+        EXPECT_EQ(result->longVector[i], values->longVector[i]);
+    }
+}
+
+TEST_F(IntegerColumnReaderTest, FilteredScanRecordsRunsOfTheSelectedValues) {
+    auto filterMask = std::make_shared<PixelsBitMask>(length);
+    filterMask->clear(60, 70);
+    filterMask->clear(150, 160);
+    auto result = read(filterMask);
+
+    // the run path is taken although some values are skipped
+    ASSERT_FALSE(result->runs.empty());
+    for (auto &run : result->runs) {
+        for (int i = run.start; i < run.start + run.length; i++) {
+            ASSERT_TRUE(filterMask->get(i)) << "run [" << run.start << ", "
+                                            << run.start + run.length << ") covers a skipped value";
+            EXPECT_EQ(result->longVector[i], values->longVector[i]);
+            EXPECT_GE(result->longVector[i], run.minimum);
+            EXPECT_LE(result->longVector[i], run.maximum);
+            if (run.sequence) {
+                EXPECT_EQ(result->longVector[i], run.first + (i - run.start) * run.delta);
+            }
+        }
+    }
+    for (int i = 0; i < length; i++) {
+        if (filterMask->get(i)) {
+            EXPECT_EQ(result->longVector[i], values->longVector[i]);
+        }
+    }
+}
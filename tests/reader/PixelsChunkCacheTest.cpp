@@ -0,0 +1,135 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "PixelsChunkCache.h"
+#include "PixelsTestUtils.h"
+#include "vector/LongColumnVector.h"
+
+#include "gtest/gtest.h"
+#include <cstring>
+
+namespace {
+uint32_t admitCount() {
+    return std::stoul(ConfigFactory::Instance().getProperty("pixel.chunk.cache.admit.count"));
+}
+
+std::shared_ptr<ByteBuffer> chunk(const std::string &content) {
+    auto buffer = std::make_shared<ByteBuffer>(content.size());
+    buffer->putBytes((uint8_t *) content.data(), content.size());
+    return buffer;
+}
+
+// the ids of example.pxl read by a record reader
+std::vector<long> readIds() {
+    auto reader = openPixelsReader(exampleFilePath(), std::make_shared<PixelsFooterCache>());
+    PixelsReaderOption option;
+    option.setSkipCorruptRecords(false);
+    option.setTolerantSchemaEvolution(true);
+    option.setEnableEncodedColumnVector(false);
+    option.setIncludeCols({"id"});
+    option.setBatchSize((int) reader->getPixelStride());
+    option.setRGRange(0, reader->getRowGroupNum());
+    auto recordReader = reader->read(option);
+    std::vector<long> ids;
+    while (true) {
+        auto batch = recordReader->readBatch(false);
+        if (batch->rowCount == 0) {
+            break;
+        }
+        auto column = std::static_pointer_cast<LongColumnVector>(batch->cols[0]);
+        for (int i = 0; i < batch->rowCount; i++) {
+            ids.emplace_back(column->isLongVector() ? column->longVector[i] :
+                             reinterpret_cast<int *>(column->intVector)[i]);
+        }
+    }
+    recordReader->close();
+    reader->close();
+    return ids;
+}
+}
+
+class PixelsChunkCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (!PixelsChunkCache::Instance()->isEnabled()) {
+            GTEST_SKIP() << "pixel.chunk.cache.size is 0";
+        }
+        PixelsChunkCache::Instance()->clear();
+    }
+
+    void TearDown() override {
+        PixelsChunkCache::Instance()->clear();
+    }
+};
+
+TEST_F(PixelsChunkCacheTest, AdmitsTheChunksReadAgain) {
+    auto cache = PixelsChunkCache::Instance();
+    std::string id = PixelsChunkCache::chunkId("file", 0, 1);
+    for (uint32_t i = 0; i < admitCount(); i++) {
+        // the chunk is only cached after it is looked up admitCount times
+        EXPECT_EQ(cache->get(id), nullptr);
+        cache->admit(id, chunk("abcdef"));
+    }
+    auto cached = cache->get(id);
+    ASSERT_NE(cached, nullptr);
+    ASSERT_EQ(cached->size(), 6U);
+    EXPECT_EQ(memcmp(cached->getPointer(), "abcdef", 6), 0);
+}
+
+TEST_F(PixelsChunkCacheTest, CachesACopyOfTheChunk) {
+    auto cache = PixelsChunkCache::Instance();
+    std::string id = PixelsChunkCache::chunkId("file", 1, 0);
+    auto buffer = chunk("abcdef");
+    for (uint32_t i = 0; i < admitCount(); i++) {
+        cache->get(id);
+    }
+    cache->admit(id, buffer);
+    // the buffer of the reader is reused by the next row groups
+    memcpy(buffer->getPointer(), "xxxxxx", 6);
+    auto first = cache->get(id);
+    auto second = cache->get(id);
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(memcmp(first->getPointer(), "abcdef", 6), 0);
+    // each reader gets its own read position
+    first->get();
+    first->get();
+    EXPECT_EQ(first->getReadPos(), 2U);
+    EXPECT_EQ(second->getReadPos(), 0U);
+    // the views keep the chunk alive after it is dropped from the cache
+    cache->clear();
+    EXPECT_EQ(cache->get(id), nullptr);
+    EXPECT_EQ(memcmp(second->getPointer(), "abcdef", 6), 0);
+}
+
+TEST_F(PixelsChunkCacheTest, RecordReadersHitTheCachedChunks) {
+    auto cache = PixelsChunkCache::Instance();
+    std::vector<long> ids = readIds();
+    ASSERT_FALSE(ids.empty());
+    for (uint32_t i = 1; i < admitCount(); i++) {
+        EXPECT_EQ(readIds(), ids);
+    }
+    uint64_t hits = cache->getHitCount();
+    uint64_t misses = cache->getMissCount();
+    EXPECT_EQ(readIds(), ids);
+    // one chunk per row group is read from the cache
+    EXPECT_GT(cache->getHitCount(), hits);
+    EXPECT_EQ(cache->getMissCount(), misses);
+}
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "PixelsFilter.h"
+#include "PixelsBitMask.h"
+#include "vector/LongColumnVector.h"
+#include "exception/InvalidArgumentException.h"
+
+#include "gtest/gtest.h"
+#include <random>
+
+namespace {
+const std::vector<CpuFeatures::SimdLevel> simdLevels = {CpuFeatures::SimdLevel::SCALAR,
+                                                        CpuFeatures::SimdLevel::AVX2,
+                                                        CpuFeatures::SimdLevel::AVX512};
+
+const std::vector<duckdb::ExpressionType> comparisons = {duckdb::ExpressionType::COMPARE_EQUAL,
+                                                         duckdb::ExpressionType::COMPARE_NOTEQUAL,
+                                                         duckdb::ExpressionType::COMPARE_LESSTHAN,
+                                                         duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO,
+                                                         duckdb::ExpressionType::COMPARE_GREATERTHAN,
+                                                         duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO};
+
+bool compare(duckdb::ExpressionType comparison, long value, long constant) {
+    switch (comparison) {
+        case duckdb::ExpressionType::COMPARE_EQUAL:
+            return value == constant;
+        case duckdb::ExpressionType::COMPARE_NOTEQUAL:
+            return value != constant;
+        case duckdb::ExpressionType::COMPARE_LESSTHAN:
+            return value < constant;
+        case duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO:
+            return value <= constant;
+        case duckdb::ExpressionType::COMPARE_GREATERTHAN:
+            return value > constant;
+        default:
+            return value >= constant;
+    }
+}
+
+class PixelsFilterTest : public ::testing::TestWithParam<bool>
+{
+protected:
+    void SetUp() override {
+        isLong_ = GetParam();
+        std::mt19937 random(42);
+        std::uniform_int_distribution<long> valueDistribution(-20, 20);
+        // the length is not a multiple of 8, so that the tails of the kernels are covered
+        values_.resize(1003);
+        valid_.resize(values_.size());
+        for (int i = 0; i < values_.size(); i++) {
+            values_[i] = valueDistribution(random);
+            valid_[i] = random() % 10 != 0;
+        }
+        vector_ = std::make_shared<LongColumnVector>(values_.size(), true, isLong_);
+        memset(vector_->isValid, 0, (values_.size() + 7) / 8);
+        for (int i = 0; i < values_.size(); i++) {
+            if (isLong_) {
+                vector_->longVector[i] = values_[i];
+            } else {
+                // the reader packs int values as int32 into intVector
+                reinterpret_cast<int32_t *>(vector_->intVector)[i] = (int32_t) values_[i];
+            }
+            if (valid_[i]) {
+                ((uint8_t *) vector_->isValid)[i / 8] |= 1 << (i % 8);
+            }
+        }
+        type_ = isLong_ ? TypeDescription::createLong() : TypeDescription::createInt();
+    }
+
+    void TearDown() override {
+        // the later tests use the widest instruction set of the CPU again
+        CpuFeatures::SetSimdLevel(CpuFeatures::SimdLevel::AVX512);
+    }
+
+    duckdb::Value constant(long value) {
+        return isLong_ ? duckdb::Value::BIGINT(value) : duckdb::Value::INTEGER((int32_t) value);
+    }
+
+    std::vector<bool> applyFilter(duckdb::TableFilter &filter, CpuFeatures::SimdLevel level) {
+        CpuFeatures::SetSimdLevel(level);
+        PixelsBitMask mask(values_.size());
+        PixelsFilter::ApplyFilter(vector_, filter, mask, type_);
+        std::vector<bool> result(values_.size());
+        for (int i = 0; i < values_.size(); i++) {
+            result[i] = mask.get(i);
+        }
+        return result;
+    }
+
+protected:
+    bool isLong_;
+    std::vector<long> values_;
+    std::vector<bool> valid_;
+    std::shared_ptr<LongColumnVector> vector_;
+    std::shared_ptr<TypeDescription> type_;
+};
+}
+
+TEST_P(PixelsFilterTest, CompareKernelsMatchScalar) {
+    for (auto comparison : comparisons) {
+        duckdb::ConstantFilter filter(comparison, constant(3));
+        std::vector<bool> expected(values_.size());
+        for (int i = 0; i < values_.size(); i++) {
+            expected[i] = valid_[i] && compare(comparison, values_[i], 3);
+        }
+        for (auto level : simdLevels) {
+            EXPECT_EQ(applyFilter(filter, level), expected)
+                << "comparison " << (int) comparison << " level " << (int) level;
+        }
+    }
+}
+
+TEST_P(PixelsFilterTest, RangeKernelsMatchScalar) {
+    duckdb::ConjunctionAndFilter filter;
+    filter.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO, constant(-5)));
+    filter.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_LESSTHAN, constant(8)));
+    std::vector<bool> expected(values_.size());
+    for (int i = 0; i < values_.size(); i++) {
+        expected[i] = valid_[i] && values_[i] >= -5 && values_[i] < 8;
+    }
+    for (auto level : simdLevels) {
+        EXPECT_EQ(applyFilter(filter, level), expected) << "level " << (int) level;
+    }
+}
+
+TEST_P(PixelsFilterTest, StatisticMayMatchKeepsTheMatchingRanges) {
+    // the statistic of [-20, 20], the constants are inside, on the bounds and outside
+    pixels::proto::ColumnStatistic statistic;
+    statistic.mutable_intstatistics()->set_minimum(-20);
+    statistic.mutable_intstatistics()->set_maximum(20);
+    for (auto comparison : comparisons) {
+        for (long value : {-21L, -20L, 0L, 20L, 21L}) {
+            duckdb::ConstantFilter filter(comparison, constant(value));
+            bool expected = false;
+            for (long v = -20; v <= 20; v++) {
+                expected |= compare(comparison, v, value);
+            }
+            EXPECT_EQ(PixelsFilter::StatisticMayMatch(filter, statistic, type_), expected)
+                << "comparison " << (int) comparison << " constant " << value;
+        }
+    }
+    // a single value statistic is pruned by not equal
+    statistic.mutable_intstatistics()->set_minimum(3);
+    statistic.mutable_intstatistics()->set_maximum(3);
+    duckdb::ConstantFilter notEqual(duckdb::ExpressionType::COMPARE_NOTEQUAL, constant(3));
+    EXPECT_FALSE(PixelsFilter::StatisticMayMatch(notEqual, statistic, type_));
+}
+
+TEST_P(PixelsFilterTest, StatisticMayMatchWithConjunctions) {
+    pixels::proto::ColumnStatistic statistic;
+    statistic.mutable_intstatistics()->set_minimum(0);
+    statistic.mutable_intstatistics()->set_maximum(10);
+    duckdb::ConjunctionAndFilter conjunctionAnd;
+    conjunctionAnd.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_GREATERTHAN, constant(5)));
+    conjunctionAnd.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_LESSTHAN, constant(20)));
+    EXPECT_TRUE(PixelsFilter::StatisticMayMatch(conjunctionAnd, statistic, type_));
+    conjunctionAnd.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_EQUAL, constant(11)));
+    EXPECT_FALSE(PixelsFilter::StatisticMayMatch(conjunctionAnd, statistic, type_));
+
+    duckdb::ConjunctionOrFilter conjunctionOr;
+    conjunctionOr.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_LESSTHAN, constant(0)));
+    EXPECT_FALSE(PixelsFilter::StatisticMayMatch(conjunctionOr, statistic, type_));
+    conjunctionOr.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_EQUAL, constant(10)));
+    EXPECT_TRUE(PixelsFilter::StatisticMayMatch(conjunctionOr, statistic, type_));
+}
+
+TEST_P(PixelsFilterTest, StatisticMayMatchWithoutStatistics) {
+    // the statistics that are not written never prune
+    pixels::proto::ColumnStatistic statistic;
+    duckdb::ConstantFilter filter(duckdb::ExpressionType::COMPARE_EQUAL, constant(3));
+    EXPECT_TRUE(PixelsFilter::StatisticMayMatch(filter, statistic, type_));
+    statistic.mutable_intstatistics()->set_minimum(5);
+    EXPECT_TRUE(PixelsFilter::StatisticMayMatch(filter, statistic, type_));
+
+    duckdb::IsNullFilter isNull;
+    EXPECT_TRUE(PixelsFilter::StatisticMayMatch(isNull, statistic, type_));
+    statistic.set_hasnull(false);
+    EXPECT_FALSE(PixelsFilter::StatisticMayMatch(isNull, statistic, type_));
+    statistic.set_hasnull(true);
+    EXPECT_TRUE(PixelsFilter::StatisticMayMatch(isNull, statistic, type_));
+}
+
+TEST_P(PixelsFilterTest, UnsupportedFiltersAreRejected) {
+    // a filter that is pushed down but not evaluated would return the rows it should drop
+    duckdb::ConstantFilter distinctFrom(duckdb::ExpressionType::COMPARE_DISTINCT_FROM, constant(3));
+    EXPECT_THROW(applyFilter(distinctFrom, CpuFeatures::SimdLevel::SCALAR), InvalidArgumentException);
+    duckdb::ConjunctionAndFilter conjunctionAnd;
+    conjunctionAnd.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_GREATERTHAN, constant(0)));
+    conjunctionAnd.child_filters.emplace_back(
+            std::make_unique<duckdb::ConstantFilter>(duckdb::ExpressionType::COMPARE_DISTINCT_FROM, constant(3)));
+    EXPECT_THROW(applyFilter(conjunctionAnd, CpuFeatures::SimdLevel::SCALAR), InvalidArgumentException);
+}
+
+INSTANTIATE_TEST_SUITE_P(IntAndLong, PixelsFilterTest, ::testing::Values(false, true));
+
+TEST(PixelsBitMaskTest, ToSelectionKernelsMatchScalar) {
+    std::mt19937 random(7);
+    PixelsBitMask mask(2048);
+    for (long i = 0; i < mask.maskLength; i++) {
+        mask.set(i, random() % 3 == 0);
+    }
+    // the offset and the count are not multiples of 8
+    long offset = 5;
+    long count = 2000;
+    std::vector<uint32_t> expected;
+    for (long i = 0; i < count; i++) {
+        if (mask.get(offset + i)) {
+            expected.emplace_back(i);
+        }
+    }
+    for (auto level : simdLevels) {
+        CpuFeatures::SetSimdLevel(level);
+        std::vector<uint32_t> selection(count);
+        long size = mask.toSelection(offset, count, selection.data());
+        selection.resize(size);
+        EXPECT_EQ(selection, expected) << "level " << (int) level;
+    }
+    CpuFeatures::SetSimdLevel(CpuFeatures::SimdLevel::AVX512);
+}
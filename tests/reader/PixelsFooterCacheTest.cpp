@@ -0,0 +1,117 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "PixelsFooterCache.h"
+#include "PixelsTestUtils.h"
+
+#include "gtest/gtest.h"
+#include <fstream>
+#include <thread>
+
+namespace {
+std::shared_ptr<FileTail> fileTail(long rows) {
+    auto tail = std::make_shared<FileTail>();
+    tail->mutable_postscript()->set_numberofrows(rows);
+    tail->mutable_postscript()->set_magic("PIXELS");
+    return tail;
+}
+
+uint64_t entryBytes(const std::string &id, long rows) {
+    return fileTail(rows)->ByteSizeLong() + id.size();
+}
+}
+
+TEST(PixelsFooterCacheTest, FindCountsHitsAndMisses) {
+    PixelsFooterCache cache;
+    EXPECT_EQ(cache.findFileTail("a"), nullptr);
+    cache.putFileTail("a", fileTail(1));
+    auto tail = cache.findFileTail("a");
+    ASSERT_NE(tail, nullptr);
+    EXPECT_EQ(tail->postscript().numberofrows(), 1);
+    // the file tails and the row group footers don't hit each other
+    EXPECT_EQ(cache.findRGFooter("a"), nullptr);
+    EXPECT_EQ(cache.getHitCount(), 1U);
+    EXPECT_EQ(cache.getMissCount(), 2U);
+}
+
+TEST(PixelsFooterCacheTest, EvictsLeastRecentlyUsed) {
+    // room for two of the entries
+    PixelsFooterCache cache(2 * entryBytes("a", 1));
+    cache.putFileTail("a", fileTail(1));
+    cache.putFileTail("b", fileTail(2));
+    EXPECT_EQ(cache.getCachedBytes(), 2 * entryBytes("a", 1));
+    // a is used after b, so b is evicted by c
+    ASSERT_NE(cache.findFileTail("a"), nullptr);
+    cache.putFileTail("c", fileTail(3));
+    EXPECT_TRUE(cache.containsFileTail("a"));
+    EXPECT_FALSE(cache.containsFileTail("b"));
+    EXPECT_TRUE(cache.containsFileTail("c"));
+    EXPECT_EQ(cache.getCachedBytes(), 2 * entryBytes("a", 1));
+}
+
+TEST(PixelsFooterCacheTest, KeepsTheEntryLargerThanTheCapacity) {
+    PixelsFooterCache cache(1);
+    cache.putFileTail("a", fileTail(1));
+    cache.putFileTail("b", fileTail(2));
+    EXPECT_FALSE(cache.containsFileTail("a"));
+    EXPECT_TRUE(cache.containsFileTail("b"));
+}
+
+TEST(PixelsFooterCacheTest, PutReplacesTheEntry) {
+    PixelsFooterCache cache;
+    cache.putFileTail("a", fileTail(1));
+    cache.putFileTail("a", fileTail(100000));
+    EXPECT_EQ(cache.getFileTail("a")->postscript().numberofrows(), 100000);
+    EXPECT_EQ(cache.getCachedBytes(), entryBytes("a", 100000));
+    cache.clear();
+    EXPECT_EQ(cache.getCachedBytes(), 0U);
+    EXPECT_FALSE(cache.containsFileTail("a"));
+}
+
+TEST(PixelsFooterCacheTest, RewrittenFileGetsANewId) {
+    TempFile file("pixels_footer_cache");
+    const std::string &path = file.getPath();
+    std::ofstream(path) << "first";
+    std::string id = PixelsFooterCache::fileId(path);
+    EXPECT_EQ(PixelsFooterCache::fileId(std::string("file://") + path), id);
+    EXPECT_NE(PixelsFooterCache::rgFooterId(id, 0), PixelsFooterCache::rgFooterId(id, 1));
+    std::ofstream(path) << "second";
+    EXPECT_NE(PixelsFooterCache::fileId(path), id);
+}
+
+TEST(PixelsFooterCacheTest, SharedByThreads) {
+    PixelsFooterCache cache(64 * entryBytes("a-00", 1));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 1000; i++) {
+                std::string id = "a-" + std::to_string((t * 7 + i) % 100);
+                if (cache.findFileTail(id) == nullptr) {
+                    cache.putFileTail(id, fileTail(1));
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(cache.getHitCount() + cache.getMissCount(), 4000U);
+    EXPECT_LE(cache.getCachedBytes(), 64 * entryBytes("a-00", 1));
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "PixelsTestUtils.h"
+
+#include "gtest/gtest.h"
+
+// the row group morsels of a file open their own readers, only the first one parses the file tail
+TEST(PixelsReaderBuilderTest, ReadersOfTheSameFileShareTheFileTail) {
+    auto footerCache = std::make_shared<PixelsFooterCache>();
+    auto first = openPixelsReader(exampleFilePath(), footerCache);
+    EXPECT_EQ(footerCache->getMissCount(), 1U);
+    EXPECT_EQ(footerCache->getHitCount(), 0U);
+
+    auto second = openPixelsReader(exampleFilePath(), footerCache);
+    EXPECT_EQ(footerCache->getMissCount(), 1U);
+    EXPECT_EQ(footerCache->getHitCount(), 1U);
+    EXPECT_EQ(second->getRowGroupNum(), first->getRowGroupNum());
+    EXPECT_EQ(second->getNumberOfRows(), first->getNumberOfRows());
+    EXPECT_EQ(second->getFileSchema()->getFieldNames(), first->getFileSchema()->getFieldNames());
+    // the readers are closed separately, the cached tail stays valid
+    first->close();
+    EXPECT_EQ(second->getRowGroupInfos().size(), second->getRowGroupNum());
+    second->close();
+}
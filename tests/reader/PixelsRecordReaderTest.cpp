@@ -0,0 +1,237 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "PixelsWriterImpl.h"
+#include "PixelsTestUtils.h"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+
+#include "gtest/gtest.h"
+
+namespace {
+const int pixelStride = 16;
+// the row groups are made of whole pixels, so that the reader batches have the same size
+const int rowGroupRows = 6 * pixelStride;
+const int rowGroupNum = 10;
+
+/**
+ * A file of the columns a = row and b = row / 30 * 1000, the rows of each row group are written
+ * as one batch. The row groups and the pixels of a are thus ordered by their statistics.
+ */
+class PixelsRecordReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto schema = TypeDescription::fromString("struct<a:bigint, b:bigint>");
+        auto rowBatch = schema->createRowBatch(rowGroupRows, std::vector<bool>(2, true));
+        // each batch exceeds the row group size, so that every batch is written as a row group
+        auto writer = std::make_unique<PixelsWriterImpl>(schema, pixelStride, 10, filePath, 1024, true,
+                                                         EncodingLevel(EncodingLevel::EL2), false, false, 16);
+        auto a = std::static_pointer_cast<LongColumnVector>(rowBatch->cols[0]);
+        auto b = std::static_pointer_cast<LongColumnVector>(rowBatch->cols[1]);
+        for (long row = 0; row < rowGroupRows * rowGroupNum; row++) {
+            a->add(row);
+            b->add(row / 30 * 1000);
+            rowBatch->rowCount++;
+            if (rowBatch->rowCount == rowBatch->getMaxSize()) {
+                writer->addRowBatch(rowBatch);
+                rowBatch->reset();
+            }
+        }
+        writer->close();
+        footerCache = std::make_shared<PixelsFooterCache>();
+    }
+
+    // the values of a batch, the rows filtered out are kept in the batch
+    struct Batch {
+        std::vector<long> a;
+        std::vector<long> b;
+        std::vector<bool> selected;
+    };
+
+    /**
+     * Read the columns a and b with the filters pushed down.
+     */
+    std::vector<Batch> read(duckdb::TableFilterSet &filters, bool lateMaterialization = false) {
+        auto reader = openPixelsReader(filePath, footerCache);
+        PixelsReaderOption option;
+        option.setSkipCorruptRecords(false);
+        option.setTolerantSchemaEvolution(true);
+        option.setEnableEncodedColumnVector(false);
+        option.setEnabledFilterPushDown(true);
+        option.setFilter(&filters);
+        option.setEnableLateMaterialization(lateMaterialization);
+        option.setIncludeCols({"a", "b"});
+        option.setBatchSize(pixelStride);
+        option.setRGRange(0, rowGroupNum);
+        auto recordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(reader->read(option));
+        std::vector<Batch> batches;
+        while (true) {
+            auto rowBatch = recordReader->readBatch(false);
+            if (rowBatch->rowCount == 0) {
+                break;
+            }
+            auto a = std::static_pointer_cast<LongColumnVector>(rowBatch->cols[0]);
+            auto b = std::static_pointer_cast<LongColumnVector>(rowBatch->cols[1]);
+            auto mask = recordReader->getFilterMask();
+            Batch batch;
+            for (int i = 0; i < rowBatch->rowCount; i++) {
+                batch.a.emplace_back(a->longVector[i]);
+                batch.b.emplace_back(b->longVector[i]);
+                batch.selected.emplace_back(mask->get(i));
+            }
+            batches.emplace_back(batch);
+        }
+        recordReader->close();
+        reader->close();
+        return batches;
+    }
+
+    // the values of a and b at the selected rows of the batches
+    static std::vector<std::pair<long, long>> selectedRows(const std::vector<Batch> &batches) {
+        std::vector<std::pair<long, long>> rows;
+        for (const Batch &batch : batches) {
+            for (int i = 0; i < batch.a.size(); i++) {
+                if (batch.selected[i]) {
+                    rows.emplace_back(batch.a[i], batch.b[i]);
+                }
+            }
+        }
+        return rows;
+    }
+
+    static std::unique_ptr<duckdb::ConstantFilter> compare(duckdb::ExpressionType comparison, long value) {
+        return std::make_unique<duckdb::ConstantFilter>(comparison, duckdb::Value::BIGINT(value));
+    }
+
+    TempFile file{"pixels_record_reader"};
+    const std::string &filePath = file.getPath();
+    std::shared_ptr<PixelsFooterCache> footerCache;
+};
+}
+
+TEST_F(PixelsRecordReaderTest, WritesTheStatistics) {
+    auto reader = openPixelsReader(filePath);
+    ASSERT_EQ(reader->getRowGroupNum(), rowGroupNum);
+    for (int rg = 0; rg < rowGroupNum; rg++) {
+        auto statistic = reader->getRowGroupStat(rg);
+        ASSERT_EQ(statistic.columnchunkstats_size(), 2);
+        auto &a = statistic.columnchunkstats(0);
+        EXPECT_EQ(a.numberofvalues(), rowGroupRows);
+        EXPECT_EQ(a.intstatistics().minimum(), rg * rowGroupRows);
+        EXPECT_EQ(a.intstatistics().maximum(), (rg + 1) * rowGroupRows - 1);
+        auto &b = statistic.columnchunkstats(1);
+        EXPECT_EQ(b.intstatistics().minimum(), rg * rowGroupRows / 30 * 1000);
+        EXPECT_EQ(b.intstatistics().maximum(), ((rg + 1) * rowGroupRows - 1) / 30 * 1000);
+    }
+    // the file statistics merge the row group statistics
+    auto a = reader->getColumnStat("a");
+    EXPECT_EQ(a.numberofvalues(), rowGroupRows * rowGroupNum);
+    EXPECT_EQ(a.intstatistics().minimum(), 0);
+    EXPECT_EQ(a.intstatistics().maximum(), rowGroupRows * rowGroupNum - 1);
+    EXPECT_EQ(a.intstatistics().sum(), (long) rowGroupRows * rowGroupNum * (rowGroupRows * rowGroupNum - 1) / 2);
+    reader->close();
+}
+
+TEST_F(PixelsRecordReaderTest, PrunesRowGroupsByStatistics) {
+    duckdb::TableFilterSet filters;
+    filters.filters[0] = compare(duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO, 7 * rowGroupRows);
+    auto batches = read(filters);
+    ASSERT_FALSE(batches.empty());
+    EXPECT_EQ(batches.front().a[0], 7 * rowGroupRows);
+    // only the footers of the row groups that may match are read
+    std::string fileId = PixelsFooterCache::fileId(filePath);
+    for (int rg = 0; rg < rowGroupNum; rg++) {
+        EXPECT_EQ(footerCache->containsRGFooter(PixelsFooterCache::rgFooterId(fileId, rg)), rg >= 7)
+            << "row group " << rg;
+    }
+}
+
+TEST_F(PixelsRecordReaderTest, PrunesAllRowGroups) {
+    duckdb::TableFilterSet filters;
+    filters.filters[1] = compare(duckdb::ExpressionType::COMPARE_LESSTHAN, 0);
+    EXPECT_TRUE(read(filters).empty());
+    std::string fileId = PixelsFooterCache::fileId(filePath);
+    for (int rg = 0; rg < rowGroupNum; rg++) {
+        EXPECT_FALSE(footerCache->containsRGFooter(PixelsFooterCache::rgFooterId(fileId, rg)));
+    }
+}
+
+TEST_F(PixelsRecordReaderTest, SkipsThePixelsThatCannotMatch) {
+    duckdb::TableFilterSet filters;
+    filters.filters[0] = compare(duckdb::ExpressionType::COMPARE_EQUAL, 700);
+    auto batches = read(filters);
+    // only the pixel of the rows 688 to 703 is read
+    ASSERT_EQ(batches.size(), 1U);
+    const Batch &batch = batches.front();
+    ASSERT_EQ(batch.a.size(), (size_t) pixelStride);
+    for (int i = 0; i < pixelStride; i++) {
+        EXPECT_EQ(batch.a[i], 688 + i);
+        EXPECT_EQ(batch.b[i], (688 + i) / 30 * 1000);
+        EXPECT_EQ(batch.selected[i], i == 12) << "row " << batch.a[i];
+    }
+}
+
+TEST_F(PixelsRecordReaderTest, SkipsThePixelsBeforeTheFirstMatch) {
+    duckdb::TableFilterSet filters;
+    filters.filters[0] = compare(duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO, 700);
+    auto batches = read(filters);
+    ASSERT_FALSE(batches.empty());
+    // the decoders are moved past the skipped pixel, so the rows that are read stay in order
+    long row = 688;
+    for (const Batch &batch : batches) {
+        for (int i = 0; i < batch.a.size(); i++, row++) {
+            ASSERT_EQ(batch.a[i], row);
+            EXPECT_EQ(batch.b[i], row / 30 * 1000);
+            EXPECT_EQ(batch.selected[i], row >= 700) << "row " << row;
+        }
+    }
+    EXPECT_EQ(row, rowGroupRows * rowGroupNum);
+}
+
+TEST_F(PixelsRecordReaderTest, LateMaterializationSkipsTheBatchesWithoutMatches) {
+    duckdb::TableFilterSet filters;
+    // the pixel of the rows 16 to 31 may match b = 500 by its statistics, but none of its rows does
+    auto conjunctionOr = std::make_unique<duckdb::ConjunctionOrFilter>();
+    conjunctionOr->child_filters.emplace_back(compare(duckdb::ExpressionType::COMPARE_EQUAL, 500));
+    conjunctionOr->child_filters.emplace_back(compare(duckdb::ExpressionType::COMPARE_EQUAL, 2000));
+    filters.filters[1] = std::move(conjunctionOr);
+    auto rows = selectedRows(read(filters, true));
+    ASSERT_EQ(rows.size(), 30U);
+    for (int i = 0; i < rows.size(); i++) {
+        // a is decoded at the selected rows even though the batches before them were not decoded
+        EXPECT_EQ(rows[i].first, 60 + i);
+        EXPECT_EQ(rows[i].second, 2000);
+    }
+}
+
+TEST_F(PixelsRecordReaderTest, LateMaterializationReadsTheSameRows) {
+    duckdb::TableFilterSet filters;
+    filters.filters[0] = compare(duckdb::ExpressionType::COMPARE_GREATERTHAN, 100);
+    auto conjunctionAnd = std::make_unique<duckdb::ConjunctionAndFilter>();
+    conjunctionAnd->child_filters.emplace_back(compare(duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO, 6000));
+    conjunctionAnd->child_filters.emplace_back(compare(duckdb::ExpressionType::COMPARE_LESSTHAN, 9000));
+    filters.filters[1] = std::move(conjunctionAnd);
+    auto rows = selectedRows(read(filters, true));
+    EXPECT_EQ(rows, selectedRows(read(filters)));
+    // the rows 180 to 269
+    ASSERT_EQ(rows.size(), 90U);
+    EXPECT_EQ(rows.front().first, 180);
+    EXPECT_EQ(rows.back().first, 269);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "encoding/RunLenIntDecoder.h"
+#include "encoding/RunLenIntEncoder.h"
+#include "utils/CpuFeatures.h"
+
+#include "gtest/gtest.h"
+#include <random>
+
+namespace {
+const int length = 3000;
+
+/**
+ * Encode random literals of a bit width, mixed with repeated values and sequences,
+ * so that the decoder goes through the unpack kernels as well as the runs.
+ */
+class RunLenIntDecoderTest : public ::testing::TestWithParam<int> {
+protected:
+    void SetUp() override {
+        int bitWidth = GetParam();
+        std::mt19937_64 random(bitWidth);
+        long bound = bitWidth >= 63 ? INT64_MAX : (1L << bitWidth) - 1;
+        std::uniform_int_distribution<long> distribution(-bound / 2, bound / 2);
+        values.resize(length);
+        for (int i = 0; i < length; i++) {
+            switch ((i / 100) % 3) {
+                case 0:
+                case 1:
+                    values[i] = distribution(random);
+                    break;
+                default:
+                    // repeated values and a sequence
+                    values[i] = i % 100 < 50 ? 7 : i;
+            }
+        }
+        encoded = std::make_shared<ByteBuffer>(length * 10);
+        RunLenIntEncoder encoder;
+        encoder.encode(values.data(), length, encoded);
+    }
+
+    void TearDown() override {
+        CpuFeatures::SetSimdLevel(CpuFeatures::SimdLevel::AVX512);
+    }
+
+    std::shared_ptr<ByteBuffer> input() {
+        return std::make_shared<ByteBuffer>(*encoded, 0, encoded->getWritePos());
+    }
+
+    std::vector<long> values;
+    std::shared_ptr<ByteBuffer> encoded;
+};
+}
+
+TEST_P(RunLenIntDecoderTest, DecodeMatchesAcrossSimdLevels) {
+    for (auto level : {CpuFeatures::SimdLevel::SCALAR, CpuFeatures::SimdLevel::AVX2}) {
+        CpuFeatures::SetSimdLevel(level);
+        RunLenIntDecoder decoder(input(), true);
+        std::vector<long> decoded(length);
+        int offset = 0;
+        while (offset < length) {
+            // decode in pieces that do not line up with the runs
+            int n = decoder.decode(decoded.data() + offset, std::min(333, length - offset));
+            ASSERT_GT(n, 0);
+            offset += n;
+        }
+        for (int i = 0; i < length; i++) {
+            ASSERT_EQ(decoded[i], values[i]) << "value " << i << " at level " << (int) level;
+        }
+    }
+}
+
+TEST_P(RunLenIntDecoderTest, DecodeIntoNarrowsValues) {
+    RunLenIntDecoder decoder(input(), true);
+    std::vector<int32_t> decoded(length);
+    ASSERT_EQ(decoder.decodeInto<int32_t>(decoded.data(), length), length);
+    for (int i = 0; i < length; i++) {
+        ASSERT_EQ(decoded[i], (int32_t) values[i]) << "value " << i;
+    }
+}
+
+TEST_P(RunLenIntDecoderTest, SkipKeepsPosition) {
+    for (auto level : {CpuFeatures::SimdLevel::SCALAR, CpuFeatures::SimdLevel::AVX2}) {
+        CpuFeatures::SetSimdLevel(level);
+        RunLenIntDecoder decoder(input(), true);
+        long position = 0;
+        std::vector<long> decoded(length);
+        for (int step : {17, 517, 1, 1201, 99, 512}) {
+            decoder.skip(step);
+            position += step;
+            int n = decoder.decode(decoded.data(), 23);
+            ASSERT_EQ(n, 23);
+            for (int i = 0; i < n; i++) {
+                ASSERT_EQ(decoded[i], values[position + i]) << "value " << position + i;
+            }
+            position += n;
+        }
+        ASSERT_EQ(decoder.next(), values[position]);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(BitWidths, RunLenIntDecoderTest, ::testing::Values(1, 2, 4, 8, 11, 16, 24, 32, 40, 48, 56, 63));
@@ -0,0 +1,147 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "reader/StringColumnReader.h"
+#include "vector/BinaryColumnVector.h"
+#include "PixelsBitMask.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+const int length = 20;
+const std::vector<std::string> entries = {"apple", "banana", "cherry"};
+
+bool isNullRow(int i) {
+    return i == 2 || i == 9 || i == 17;
+}
+
+std::string valueOf(int i) {
+    return entries[i % entries.size()];
+}
+
+/**
+ * Build one pixel of a dictionary encoded column chunk in the layout of the writer: the ids,
+ * the isNull bitmap, the dictionary content, the dictionary starts and the offsets of the
+ * content and the starts.
+ */
+class StringColumnReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::vector<uint8_t> chunk;
+        auto putInt = [&chunk](int value) {
+            auto bytes = reinterpret_cast<uint8_t *>(&value);
+            chunk.insert(chunk.end(), bytes, bytes + sizeof(int));
+        };
+        for (int i = 0; i < length; i++) {
+            // the ids of the null values are padded
+            putInt(isNullRow(i) ? 0 : (int) (i % entries.size()));
+        }
+        int isNullOffset = (int) chunk.size();
+        std::vector<uint8_t> isNull((length + 7) / 8, 0);
+        for (int i = 0; i < length; i++) {
+            if (isNullRow(i)) {
+                isNull[i / 8] |= 1 << (i % 8);
+            }
+        }
+        chunk.insert(chunk.end(), isNull.begin(), isNull.end());
+        int dictContentOffset = (int) chunk.size();
+        std::vector<int> starts = {0};
+        for (auto &entry : entries) {
+            chunk.insert(chunk.end(), entry.begin(), entry.end());
+            starts.push_back(starts.back() + (int) entry.size());
+        }
+        int dictStartsOffset = (int) chunk.size();
+        for (int start : starts) {
+            putInt(start);
+        }
+        putInt(dictContentOffset);
+        putInt(dictStartsOffset);
+
+        buffer = std::make_shared<ByteBuffer>(chunk.size());
+        buffer->putBytes(chunk.data(), chunk.size());
+        encoding.set_kind(pixels::proto::ColumnEncoding_Kind_DICTIONARY);
+        encoding.set_dictionarysize(entries.size());
+        chunkIndex.set_isnulloffset(isNullOffset);
+        chunkIndex.add_pixelstatistics()->mutable_statistic()->set_hasnull(true);
+    }
+
+    std::shared_ptr<BinaryColumnVector> read(bool encoded, std::shared_ptr<PixelsBitMask> filterMask) {
+        auto result = std::make_shared<BinaryColumnVector>(length, encoded);
+        reader.read(buffer, encoding, 0, length, length, 0, result, chunkIndex, filterMask);
+        return result;
+    }
+
+    StringColumnReader reader{TypeDescription::createString()};
+    std::shared_ptr<ByteBuffer> buffer;
+    pixels::proto::ColumnEncoding encoding;
+    pixels::proto::ColumnChunkIndex chunkIndex;
+};
+}
+
+TEST_F(StringColumnReaderTest, EncodedVectorKeepsTheIds) {
+    auto result = read(true, nullptr);
+    ASSERT_NE(result->dictionary, nullptr);
+    ASSERT_EQ(result->dictionarySize, (int) entries.size());
+    for (size_t id = 0; id < entries.size(); id++) {
+        EXPECT_EQ(result->dictionary[id].GetString(), entries[id]);
+    }
+    for (int i = 0; i < length; i++) {
+        if (isNullRow(i)) {
+            EXPECT_FALSE(result->checkValid(i));
+            // the null values refer to the null entry after the dictionary
+            EXPECT_EQ(result->dictIds[i], (uint32_t) entries.size());
+        } else {
+            EXPECT_TRUE(result->checkValid(i));
+            EXPECT_EQ(result->dictionary[result->dictIds[i]].GetString(), valueOf(i));
+        }
+    }
+    EXPECT_EQ(result->dictionary[entries.size()].GetSize(), 0u);
+}
+
+TEST_F(StringColumnReaderTest, SlicesOfTheIdsSelectTheirValues) {
+    auto result = read(true, nullptr);
+    // the scan slices the dictionary by the ids from the position of each output chunk
+    for (int position = 0; position < length; position += 8) {
+        const uint32_t *sel = result->dictIds + position;
+        for (int i = 0; i < std::min(8, length - position); i++) {
+            if (!isNullRow(position + i)) {
+                EXPECT_EQ(result->dictionary[sel[i]].GetString(), valueOf(position + i));
+            } else {
+                EXPECT_EQ(sel[i], (uint32_t) result->dictionarySize);
+            }
+        }
+    }
+}
+
+TEST_F(StringColumnReaderTest, LateMaterializationSkipsTheFilteredValues) {
+    auto filterMask = std::make_shared<PixelsBitMask>(length);
+    filterMask->clear(4, 12);
+    auto result = read(false, filterMask);
+    EXPECT_EQ(result->dictionary, nullptr);
+    for (int i = 0; i < length; i++) {
+        if (!filterMask->get(i)) {
+            continue;
+        }
+        EXPECT_EQ(result->checkValid(i), !isNullRow(i));
+        if (!isNullRow(i)) {
+            EXPECT_EQ(result->vector[i].GetString(), valueOf(i)) << "row " << i;
+        }
+    }
+}
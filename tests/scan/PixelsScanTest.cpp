@@ -0,0 +1,178 @@
+/*
+ * Copyright 2024 PixelsDB.
+ *
+ * This file is part of Pixels.
+ *
+ * Pixels is free software: you can redistribute it and/or modify
+ * it under the terms of the Affero GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * Pixels is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * Affero GNU General Public License for more details.
+ *
+ * You should have received a copy of the Affero GNU General Public
+ * License along with Pixels.  If not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#include "pixels_extension.hpp"
+#include "PixelsWriterImpl.h"
+#include "PixelsTestUtils.h"
+
+#include "gtest/gtest.h"
+#include <cstdlib>
+#include <unistd.h>
+
+namespace {
+const int pixelStride = 16;
+const int rowGroupRows = 4 * pixelStride;
+
+/**
+ * Runs pixels_scan on the files xxx_${number}.pxl of a temporary directory, the files have
+ * the column a, whose values increase with the rows so that the row groups are ordered by
+ * their statistics.
+ */
+class PixelsScanTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/pixels_scan_XXXXXX";
+        ASSERT_NE(mkdtemp(path), nullptr);
+        directory = path;
+        db.LoadExtension<duckdb::PixelsExtension>();
+    }
+
+    void TearDown() override {
+        for (auto &file : files) {
+            unlink(file.c_str());
+        }
+        rmdir(directory.c_str());
+    }
+
+    /**
+     * Write the file part_${number}.pxl of the values first, first + 1, ... in rowGroupNum row groups.
+     */
+    void writeFile(int number, long first, int rowGroupNum, int stride = pixelStride) {
+        std::string path = directory + "/part_" + std::to_string(number) + ".pxl";
+        auto schema = TypeDescription::fromString("struct<a:bigint>");
+        auto rowBatch = schema->createRowBatch(rowGroupRows, std::vector<bool>(1, true));
+        // each batch exceeds the row group size, so that every batch is written as a row group
+        auto writer = std::make_unique<PixelsWriterImpl>(schema, stride, 10, path, 1024, true,
+                                                         EncodingLevel(EncodingLevel::EL2), false, false, 16);
+        auto a = std::static_pointer_cast<LongColumnVector>(rowBatch->cols[0]);
+        for (long row = 0; row < rowGroupRows * rowGroupNum; row++) {
+            a->add(first + row);
+            rowBatch->rowCount++;
+            if (rowBatch->rowCount == rowBatch->getMaxSize()) {
+                writer->addRowBatch(rowBatch);
+                rowBatch->reset();
+            }
+        }
+        writer->close();
+        files.emplace_back(path);
+    }
+
+    std::string scan() const {
+        return "pixels_scan('" + directory + "/*.pxl')";
+    }
+
+    // the values of the first column of the result
+    std::vector<long> query(const std::string &sql) {
+        auto result = connection.Query(sql);
+        EXPECT_FALSE(result->HasError()) << sql << ": " << result->GetError();
+        std::vector<long> values;
+        for (duckdb::idx_t row = 0; row < result->RowCount(); row++) {
+            values.emplace_back(result->GetValue(0, row).GetValue<int64_t>());
+        }
+        return values;
+    }
+
+    // the rows of the result, each row is printed as the values separated by commas
+    std::vector<std::string> rows(const std::string &sql) {
+        auto result = connection.Query(sql);
+        EXPECT_FALSE(result->HasError()) << sql << ": " << result->GetError();
+        std::vector<std::string> rows;
+        for (duckdb::idx_t row = 0; row < result->RowCount(); row++) {
+            std::string text;
+            for (duckdb::idx_t column = 0; column < result->ColumnCount(); column++) {
+                text += (column == 0 ? "" : ",") + result->GetValue(column, row).ToString();
+            }
+            rows.emplace_back(text);
+        }
+        return rows;
+    }
+
+    static std::vector<long> range(long first, long last) {
+        std::vector<long> values;
+        for (long value = first; value <= last; value++) {
+            values.emplace_back(value);
+        }
+        return values;
+    }
+
+    std::string directory;
+    std::vector<std::string> files;
+    duckdb::DuckDB db{nullptr};
+    duckdb::Connection connection{db};
+};
+}
+
+// the record readers of the pruned files return no batch, the scan moves on to the next file
+TEST_F(PixelsScanTest, SkipsTheFilesWhoseRowGroupsAreAllPruned) {
+    writeFile(0, 0, 2);
+    writeFile(1, 1000, 2);
+    writeFile(2, 2000, 2);
+    query("SET threads TO 1");
+    EXPECT_EQ(query("SELECT a FROM " + scan() + " WHERE a >= 1000 AND a < 1100 ORDER BY a"), range(1000, 1099));
+    EXPECT_EQ(query("SELECT a FROM " + scan() + " WHERE a >= 2064 ORDER BY a"), range(2064, 2127));
+}
+
+// with more threads than files, each row group of the files is a morsel of its own
+TEST_F(PixelsScanTest, SkipsTheRowGroupMorselsThatArePruned) {
+    writeFile(0, 0, 2);
+    writeFile(1, 1000, 2);
+    query("SET threads TO 4");
+    EXPECT_EQ(query("SELECT a FROM " + scan() + " WHERE a >= 1064 ORDER BY a"), range(1064, 1127));
+    EXPECT_EQ(query("SELECT count(*) FROM " + scan() + " WHERE a BETWEEN 64 AND 1063"), std::vector<long>{128});
+}
+
+TEST_F(PixelsScanTest, ReturnsNothingWhenAllTheFilesArePruned) {
+    writeFile(0, 0, 2);
+    writeFile(1, 1000, 2);
+    EXPECT_TRUE(query("SELECT a FROM " + scan() + " WHERE a < 0").empty());
+    EXPECT_EQ(query("SELECT count(*) FROM " + scan() + " WHERE a > 5000"), std::vector<long>{0});
+}
+
+// the batches are the pixels of each file, not pixel.stride of the configuration
+TEST_F(PixelsScanTest, ReadsThePixelsOfTheFileStride) {
+    writeFile(0, 0, 2, pixelStride);
+    writeFile(1, 1000, 2, 2 * pixelStride);
+    query("SET threads TO 1");
+    std::vector<long> expected = range(0, 2 * rowGroupRows - 1);
+    std::vector<long> second = range(1000, 1000 + 2 * rowGroupRows - 1);
+    expected.insert(expected.end(), second.begin(), second.end());
+    EXPECT_EQ(query("SELECT a FROM " + scan() + " ORDER BY a"), expected);
+    // the pixels that cannot match are skipped by their statistics
+    EXPECT_EQ(query("SELECT a FROM " + scan() + " WHERE a = 17 OR a = 1040 ORDER BY a"), (std::vector<long>{17, 1040}));
+}
+
+// every filter type that pixels_scan evaluates returns the same rows as a DuckDB table that is not pushed down to
+TEST_F(PixelsScanTest, PushedDownFiltersMatchAnUnpushedScan) {
+    std::string example = "pixels_scan('" + exampleFilePath() + "')";
+    query("CREATE TABLE example AS SELECT * FROM " + example);
+    const std::vector<std::string> predicates = {
+            "id = 3", "id <> 3", "id < 3", "id <= 3", "id > 3", "id >= 3",
+            "id BETWEEN 2 AND 7", "id > 2 AND id < 7", "id = 1 OR id = 8",
+            "id IS NULL", "id IS NOT NULL",
+            "name = 'Tom'", "name <> 'Tom'", "name < 'Frank'", "name >= 'Eric'",
+            "birthday > DATE '2000-01-01'", "birthday <= DATE '2000-01-01'",
+            "score >= 60", "score < 60",
+            "id > 2 AND name <> 'Alice' AND score IS NOT NULL"};
+    for (const std::string &predicate : predicates) {
+        EXPECT_EQ(rows("SELECT * FROM " + example + " WHERE " + predicate + " ORDER BY id"),
+                  rows("SELECT * FROM example WHERE " + predicate + " ORDER BY id"))
+            << predicate;
+    }
+}
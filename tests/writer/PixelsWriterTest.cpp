@@ -27,6 +27,7 @@
 #include "physical/PhysicalReaderUtil.h"
 #include "PixelsReaderBuilder.h"
 #include "gtest/gtest.h"
+#include <unistd.h>
 
 class PIXELS_WRITER_TEST : public ::testing::Test
 {
@@ -305,4 +306,83 @@ TEST_F(PIXELS_WRITER_TEST, WRITE_TWO_COLUMN_WITHOUT_RUNLENENCODE)
         std::cerr << "[DEBUG] Time: " << duration.count() << std::endl;
     }
 
-}
\ No newline at end of file
+}
+
+TEST_F(PIXELS_WRITER_TEST, WRITE_AND_READ_ROW_GROUPS)
+{
+    char path[] = "/tmp/pixels_writer_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    std::string file_path = path;
+
+    auto schema = TypeDescription::fromString("struct<a:bigint, b:bigint>");
+    EXPECT_TRUE(schema);
+    std::vector<bool> encode_vector(2, true);
+    // the row groups are made of whole pixels, so that the reader batches have the same size
+    const int batch_size = 6 * pixels_stride_;
+    const int batch_num = 10;
+    auto row_batch = schema->createRowBatch(batch_size, encode_vector);
+
+    // each batch exceeds the row group size, so that every batch is written as a row group
+    // and the column writers are reset and reused by the later row groups
+    auto pixels_writer = std::make_unique<PixelsWriterImpl>(schema, pixels_stride_, row_group_size_, file_path,
+                                                            block_size_, block_padding_, EncodingLevel(EncodingLevel::EL2),
+                                                            false, false, compression_block_size_);
+    auto va = std::dynamic_pointer_cast<LongColumnVector>(row_batch->cols[0]);
+    auto vb = std::dynamic_pointer_cast<LongColumnVector>(row_batch->cols[1]);
+    ASSERT_TRUE(va);
+    ASSERT_TRUE(vb);
+    for (long i = 0; i < batch_size * batch_num; ++i)
+    {
+        va->add(i);
+        vb->add(i / 30 * 1000);
+        row_batch->rowCount++;
+        if (row_batch->rowCount == row_batch->getMaxSize())
+        {
+            pixels_writer->addRowBatch(row_batch);
+            row_batch->reset();
+        }
+    }
+    pixels_writer->close();
+
+    auto builder = std::make_shared<PixelsReaderBuilder>();
+    std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
+    std::shared_ptr<PixelsReader> pixels_reader = builder
+                                 ->setPath(file_path)
+                                 ->setStorage(storage)
+                                 ->setPixelsFooterCache(std::make_shared<PixelsFooterCache>())
+                                 ->build();
+    ASSERT_EQ(pixels_reader->getRowGroupNum(), batch_num);
+    ASSERT_EQ(pixels_reader->getNumberOfRows(), batch_size * batch_num);
+
+    PixelsReaderOption option;
+    option.setSkipCorruptRecords(false);
+    option.setTolerantSchemaEvolution(true);
+    option.setEnableEncodedColumnVector(false);
+    option.setIncludeCols({"a", "b"});
+    // the batches of the reader must not cross the pixels
+    option.setBatchSize(pixels_stride_);
+    option.setRGRange(0, batch_num);
+    auto record_reader = pixels_reader->read(option);
+    long row = 0;
+    while (true)
+    {
+        auto result = record_reader->readBatch(false);
+        if (result->rowCount == 0)
+        {
+            break;
+        }
+        auto ra = std::static_pointer_cast<LongColumnVector>(result->cols[0]);
+        auto rb = std::static_pointer_cast<LongColumnVector>(result->cols[1]);
+        for (int i = 0; i < result->rowCount; i++, row++)
+        {
+            ASSERT_EQ(ra->longVector[i], row);
+            ASSERT_EQ(rb->longVector[i], row / 30 * 1000);
+        }
+    }
+    EXPECT_EQ(row, batch_size * batch_num);
+    record_reader->close();
+    pixels_reader->close();
+    unlink(file_path.c_str());
+}